@@ -0,0 +1,340 @@
+#include "cache/ProgramCache.h"
+#include "codeObjects/BinaryExpression.h"
+#include "codeObjects/FuncDef.h"
+#include "codeObjects/Literal.h"
+#include "codeObjects/Interpreter.h"
+#include "codeObjects/Program.h"
+#include "codeObjects/Unit.h"
+#include "codeObjects/Value.h"
+#include "codeObjects/VarDefOrAssignment.h"
+#include "flat/FlatEvaluator.h"
+#include "flat/FlatTreeBuilder.h"
+#include "lexer/Lexer.h"
+#include "parser/Parser.h"
+#include "sink/Sink.h"
+#include "unitslang/ParameterSweep.h"
+#include "unitslang/UnitsLang.h"
+#include "vm/Compiler.h"
+#include "vm/VirtualMachine.h"
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+// discards program output, so that benchmarks measure only the interpreter
+class NullSink : public Sink {
+private:
+    void writeOut([[maybe_unused]] std::string_view data) override {}
+};
+
+enum Engine {
+    TREE_WALKER,
+    VM,
+    FLAT_TREE
+};
+
+std::string readFile(const std::string &path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("Cannot open file " + path);
+    }
+    std::ostringstream os;
+    os << file.rdbuf();
+    return os.str();
+}
+
+std::unique_ptr<Program> parse(const std::string &input) {
+    Lexer lexer(input);
+    Parser parser(lexer);
+    return parser.parse();
+}
+
+std::string deepRecursionScript() {
+    return
+        "func depth (n [1]) -> [1] {\n"
+        "    if n == 0 {\n"
+        "        return 0\n"
+        "    }\n"
+        "    return depth(n - 1) + 1\n"
+        "}\n"
+        "total = 0\n"
+        "i = 0\n"
+        "while i < 20 {\n"
+        "    total = total + depth(500)\n"
+        "    i = i + 1\n"
+        "}\n";
+}
+
+std::string tailRecursionScript() {
+    return
+        "func sum (n [1], acc [m]) -> [m] {\n"
+        "    if n == 0 {\n"
+        "        return acc\n"
+        "    }\n"
+        "    return sum(n - 1, acc + 1[m])\n"
+        "}\n"
+        "total = sum(10000, 0[m])\n";
+}
+
+std::string longLoopScript() {
+    return
+        "i = 0\n"
+        "distance = 0[m]\n"
+        "time = 0[s]\n"
+        "while i < 100000 {\n"
+        "    distance = distance + 2[m]\n"
+        "    time = time + 1[s]\n"
+        "    i = i + 1\n"
+        "}\n"
+        "speed = distance / time\n"
+        "print(\"{speed}\")\n";
+}
+
+// many definitions with literals of various units, printed at the end
+std::string literalTableScript(int rows) {
+    static const char *units[] = { "m", "km/s", "kg*m/s2", "N", "kPa", "J/s", "cm3" };
+    std::ostringstream os;
+    for (int i = 0; i < rows; ++i) {
+        os << "t" << i << " = " << i << "." << (i % 10) << "[" << units[i % 7] << "]\n";
+    }
+    for (int i = 0; i < rows; i += 100) {
+        os << "print(\"{t" << i << "}\")\n";
+    }
+    return os.str();
+}
+
+void runScript(benchmark::State &state, const std::string &input) {
+    const Engine engine = static_cast<Engine>(state.range(0));
+    state.SetLabel(engine == VM ? "vm" : engine == FLAT_TREE ? "flat-tree" : "tree-walker");
+    for (auto _ : state) {
+        std::unique_ptr<Program> program = parse(input);
+        NullSink stdoutSink;
+        Interpreter interpreter(stdoutSink, *program);
+        int exitStatus;
+        if (engine == VM) {
+            BytecodeProgram bytecode = Compiler::compile(*program);
+            VirtualMachine vm(interpreter, bytecode);
+            exitStatus = vm.execute();
+        } else if (engine == FLAT_TREE) {
+            FlatTree tree = FlatTreeBuilder::build(*program);
+            FlatEvaluator evaluator(interpreter, tree);
+            exitStatus = evaluator.execute();
+        } else {
+            exitStatus = interpreter.executeProgram();
+        }
+        benchmark::DoNotOptimize(exitStatus);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(input.size()));
+}
+
+} // anonymous namespace
+
+static void BM_LexerGetToken(benchmark::State &state) {
+    std::string input = readFile(UNITSLANG_EXAMPLE_SCRIPT) + literalTableScript(1000);
+    std::int64_t tokens = 0;
+    for (auto _ : state) {
+        Lexer lexer(input);
+        for (Token token = lexer.getToken(); token.type != TokenType::END_OF_STREAM; token = lexer.getToken()) {
+            benchmark::DoNotOptimize(token);
+            ++tokens;
+        }
+    }
+    state.SetItemsProcessed(tokens);
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(input.size()));
+}
+BENCHMARK(BM_LexerGetToken);
+
+static void BM_ParserParse(benchmark::State &state) {
+    std::string input = readFile(UNITSLANG_EXAMPLE_SCRIPT) + literalTableScript(1000);
+    for (auto _ : state) {
+        std::unique_ptr<Program> program = parse(input);
+        benchmark::DoNotOptimize(program);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(input.size()));
+}
+BENCHMARK(BM_ParserParse);
+
+// same input as BM_ParserParse, rebuilt from the cache file after the first iteration
+static void BM_ProgramCacheLoad(benchmark::State &state) {
+    std::string input = readFile(UNITSLANG_EXAMPLE_SCRIPT) + literalTableScript(1000);
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "unitslang_benchmark_cache";
+    ProgramCache cache(directory);
+    cache.load(input);
+    for (auto _ : state) {
+        std::unique_ptr<Program> program = cache.load(input);
+        benchmark::DoNotOptimize(program);
+    }
+    std::filesystem::remove_all(directory);
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(input.size()));
+}
+BENCHMARK(BM_ProgramCacheLoad);
+
+static void BM_UnitCombineWithUnit(benchmark::State &state) {
+    codeobj::Unit force(Unit{ UnitPrefix::KILO, UnitType::GRAM, 1 });
+    force.combineWithUnit(Token{ TokenType::OP_MULT, "*" }, codeobj::Unit(Unit{ UnitPrefix::NONE, UnitType::METER, 1 }));
+    force.combineWithUnit(Token{ TokenType::OP_MULT, "/" }, codeobj::Unit(Unit{ UnitPrefix::NONE, UnitType::SECOND, 2 }));
+    const codeobj::Unit time(Unit{ UnitPrefix::NONE, UnitType::SECOND, 2 });
+    const Token mult{ TokenType::OP_MULT, "*" };
+    const Token div{ TokenType::OP_MULT, "/" };
+    for (auto _ : state) {
+        codeobj::Unit unit = force;
+        unit.combineWithUnit(mult, time);
+        unit.combineWithUnit(div, time);
+        benchmark::DoNotOptimize(unit);
+    }
+}
+BENCHMARK(BM_UnitCombineWithUnit);
+
+// expression as parsed from a program, with types checked statically; refers to
+// a variable, so that it is not folded into a constant
+static void BM_BinaryExpressionCalculate(benchmark::State &state) {
+    std::unique_ptr<Program> program = parse(
+            "x = 1.5[m]\n"
+            "a = x * 2[m] + 3[m2] - x * x / 2\n"
+        );
+    auto &assignment = dynamic_cast<VarDefOrAssignment &>(*program->getInstructions().getInstructions().back());
+    NullSink stdoutSink;
+    Interpreter interpreter(stdoutSink, *program);
+    interpreter.executeProgram();
+    for (auto _ : state) {
+        Value value = assignment.getExpr().calculate(interpreter);
+        benchmark::DoNotOptimize(value);
+    }
+}
+BENCHMARK(BM_BinaryExpressionCalculate);
+
+// expression built directly, without static type checking
+static void BM_BinaryExpressionCalculateUnchecked(benchmark::State &state) {
+    Program program({}, {});
+    NullSink stdoutSink;
+    Interpreter interpreter(stdoutSink, program);
+    Unit meter{ UnitPrefix::NONE, UnitType::METER, 1 };
+    auto product = std::make_unique<BinaryExpression>(
+            std::make_unique<Literal>(Value(1.5, Type(codeobj::Unit(meter)))),
+            Token{ TokenType::OP_MULT, "*" },
+            std::make_unique<Literal>(Value(2.0, Type(codeobj::Unit(meter))))
+        );
+    Unit squareMeter{ UnitPrefix::NONE, UnitType::METER, 2 };
+    BinaryExpression expr(
+            std::move(product),
+            Token{ TokenType::OP_ADD, "+" },
+            std::make_unique<Literal>(Value(3.0, Type(codeobj::Unit(squareMeter))))
+        );
+    for (auto _ : state) {
+        Value value = expr.calculate(interpreter);
+        benchmark::DoNotOptimize(value);
+    }
+}
+BENCHMARK(BM_BinaryExpressionCalculateUnchecked);
+
+// the same expression on arrays of state.range(0) samples, calculated element-wise
+static void BM_ArrayExpressionCalculate(benchmark::State &state) {
+    std::ostringstream input;
+    input << "x = [";
+    for (std::int64_t i = 0; i < state.range(0); ++i) {
+        input << (i == 0 ? "" : ", ") << i << ".5";
+    }
+    input << "][m]\n"
+        "a = x * 2[m] + 3[m2] - x * x / 2\n";
+    std::unique_ptr<Program> program = parse(input.str());
+    auto &assignment = dynamic_cast<VarDefOrAssignment &>(*program->getInstructions().getInstructions().back());
+    NullSink stdoutSink;
+    Interpreter interpreter(stdoutSink, *program);
+    interpreter.executeProgram();
+    for (auto _ : state) {
+        Value value = assignment.getExpr().calculate(interpreter);
+        benchmark::DoNotOptimize(value);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ArrayExpressionCalculate)->Arg(16)->Arg(1024)->Arg(65536);
+
+static void BM_FuncDefCall(benchmark::State &state) {
+    std::unique_ptr<Program> program = parse(
+            "func scale (x [m], factor [1]) -> [m] {\n"
+            "    return x * factor\n"
+            "}\n"
+            "a = scale(1[m], 2)\n"
+        );
+    const FuncDef *funcDef = program->getFuncDef("scale");
+    NullSink stdoutSink;
+    Interpreter interpreter(stdoutSink, *program);
+    const Value x(1.0, Type(codeobj::Unit(Unit{ UnitPrefix::NONE, UnitType::METER, 1 })));
+    const Value factor(2.0, Type(codeobj::Unit()));
+    for (auto _ : state) {
+        std::optional<Value> result = funcDef->call(interpreter, { x, factor });
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(BM_FuncDefCall);
+
+static void BM_ExampleScript(benchmark::State &state) {
+    runScript(state, readFile(UNITSLANG_EXAMPLE_SCRIPT));
+}
+BENCHMARK(BM_ExampleScript)->Arg(TREE_WALKER)->Arg(VM)->Arg(FLAT_TREE)->Unit(benchmark::kMillisecond);
+
+static void BM_DeepRecursion(benchmark::State &state) {
+    runScript(state, deepRecursionScript());
+}
+BENCHMARK(BM_DeepRecursion)->Arg(TREE_WALKER)->Arg(VM)->Arg(FLAT_TREE)->Unit(benchmark::kMillisecond);
+
+static void BM_TailRecursion(benchmark::State &state) {
+    runScript(state, tailRecursionScript());
+}
+BENCHMARK(BM_TailRecursion)->Arg(TREE_WALKER)->Arg(VM)->Arg(FLAT_TREE)->Unit(benchmark::kMillisecond);
+
+static void BM_LongLoop(benchmark::State &state) {
+    runScript(state, longLoopScript());
+}
+BENCHMARK(BM_LongLoop)->Arg(TREE_WALKER)->Arg(VM)->Arg(FLAT_TREE)->Unit(benchmark::kMillisecond);
+
+static void BM_LiteralTable(benchmark::State &state) {
+    runScript(state, literalTableScript(10000));
+}
+BENCHMARK(BM_LiteralTable)->Arg(TREE_WALKER)->Arg(VM)->Arg(FLAT_TREE)->Unit(benchmark::kMillisecond);
+
+// the script compiled once and run with one Runner, as by an embedding service
+static void BM_RunCompiledProgram(benchmark::State &state) {
+    const auto engine = static_cast<unitslang::Engine>(state.range(0));
+    state.SetLabel(engine == unitslang::Engine::VM ? "vm" : engine == unitslang::Engine::FLAT_TREE ? "flat-tree" : "tree-walker");
+    unitslang::CompiledProgram program = unitslang::compile(readFile(UNITSLANG_EXAMPLE_SCRIPT), {}, engine);
+    unitslang::Runner runner;
+    NullSink stdoutSink;
+    for (auto _ : state) {
+        int exitStatus = runner.run(program, {}, stdoutSink);
+        benchmark::DoNotOptimize(exitStatus);
+    }
+}
+BENCHMARK(BM_RunCompiledProgram)->Arg(TREE_WALKER)->Arg(VM)->Arg(FLAT_TREE)->Unit(benchmark::kMillisecond);
+
+// formula compiled once and run for every row of a table, on state.range(0) threads
+static void BM_ParameterSweep(benchmark::State &state) {
+    std::ostringstream csv;
+    csv << "distance [m],time [s],mass [kg]\n";
+    for (int i = 0; i < 10000; ++i) {
+        csv << i << ',' << 1 + i % 60 << ',' << 0.5 * (i % 7) << '\n';
+    }
+    const unitslang::Table table = unitslang::readTable(csv.str());
+    const unitslang::CompiledProgram program = unitslang::compile(
+            "speed = distance / time\n"
+            "energy = mass * speed * speed / 2\n",
+            table.columns
+        );
+    const std::vector<Variable> outputs{ unitslang::parseDeclaration("energy [kg*m2/s2]") };
+    unitslang::ParameterSweep sweep(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        std::vector<unitslang::RowResult> results = sweep.run(program, table, outputs);
+        benchmark::DoNotOptimize(results);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(table.rows.size()));
+}
+BENCHMARK(BM_ParameterSweep)->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,80 @@
+#include "unitslang/BatchRunner.h"
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+bool parseNumber(std::string_view value, std::size_t &number) {
+    auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), number);
+    return error == std::errc() && end == value.data() + value.size();
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    // runs independent scripts in parallel, each with separately captured output;
+    // output of every script is printed to stdout (and its errors to stderr) after a header
+    // with its file name, in order of the files
+    // --threads=<n> number of threads running the scripts, by default one per hardware thread
+    // other options are the same as of main
+    static constexpr std::string_view threadsOption = "--threads=";
+    static constexpr std::string_view maxCallDepthOption = "--max-call-depth=";
+    std::size_t threadsCount = std::max(std::thread::hardware_concurrency(), 1u);
+    bool useVm = false;
+    bool useFlatTree = false;
+    bool memoize = false;
+    std::size_t maxCallDepth = Interpreter::DEFAULT_MAX_CALL_DEPTH;
+    bool isUsageValid = true;
+    int firstFile = 1;
+    for (; firstFile < argc && std::string_view(argv[firstFile]).substr(0, 2) == "--"; ++firstFile) {
+        std::string_view option(argv[firstFile]);
+        if (option == "--vm") {
+            useVm = true;
+        } else if (option == "--flat") {
+            useFlatTree = true;
+        } else if (option == "--memoize") {
+            memoize = true;
+        } else if (option.substr(0, threadsOption.size()) == threadsOption) {
+            isUsageValid = isUsageValid && parseNumber(option.substr(threadsOption.size()), threadsCount) && threadsCount > 0;
+        } else if (option.substr(0, maxCallDepthOption.size()) == maxCallDepthOption) {
+            isUsageValid = isUsageValid && parseNumber(option.substr(maxCallDepthOption.size()), maxCallDepth);
+        } else {
+            isUsageValid = false;
+        }
+    }
+    if (!isUsageValid || firstFile == argc || (useVm && useFlatTree)) {
+        std::cerr << "Usage: " << argv[0] << " [--threads=<n>] [--vm | --flat] [--memoize] [--max-call-depth=<n>] <script-file>..."
+            << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> paths(argv + firstFile, argv + argc);
+    unitslang::BatchRunner batchRunner(threadsCount);
+    batchRunner.setEngine(useVm ? unitslang::Engine::VM
+        : useFlatTree ? unitslang::Engine::FLAT_TREE
+        : unitslang::Engine::TREE_WALKER);
+    batchRunner.setMemoization(memoize);
+    batchRunner.setMaxCallDepth(maxCallDepth);
+    std::vector<unitslang::ScriptResult> results = batchRunner.runFiles(paths);
+
+    // fails if any script failed
+    int exitStatus = 0;
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        std::cout << "==> " << paths[i] << " (exit status " << results[i].exitStatus << ") <==\n" << results[i].output;
+        if (!results[i].errors.empty()) {
+            std::cout.flush();
+            std::cerr << "==> " << paths[i] << " <==\n" << results[i].errors;
+            std::cerr.flush();
+        }
+        if (results[i].exitStatus != 0) {
+            exitStatus = 1;
+        }
+    }
+    return exitStatus;
+}
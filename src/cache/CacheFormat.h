@@ -0,0 +1,43 @@
+#ifndef TKOMSIUNITS_CACHE_CACHE_FORMAT_H_INCLUDED
+#define TKOMSIUNITS_CACHE_CACHE_FORMAT_H_INCLUDED
+
+#include <cstdint>
+
+// Layout of a program cache file, written by ProgramWriter and read by ProgramReader.
+// Numbers are stored in the byte order of the machine (the magic number does not match
+// otherwise), strings and lists are preceded by their 32-bit length:
+//   header:      magic, version, source of the program (file names are only its 64-bit hash)
+//   program:     inputs (name, type), functions (sorted by name, without print),
+//                top-level instructions block
+//   function:    name, parameters (name, type), return type, body block
+//   block:       instructions
+//   instruction: InstrTag followed by its fields
+//   expression:  ExprTag followed by its fields
+//   type:        Type::TypeClass, for numbers 16-bit exponent and prefix of every unit type
+namespace cache {
+
+inline constexpr std::uint32_t MAGIC = 0x43'4C'55'00; // "\0ULC" read as little endian
+// changed whenever the layout or the meaning of cached code objects changes
+inline constexpr std::uint32_t VERSION = 5;
+
+enum class InstrTag : std::uint8_t {
+    VAR_DEF_OR_ASSIGNMENT,  // name, has declared type, [type], expression
+    FUNC_CALL,              // name, arguments
+    IF,                     // has condition, [condition], block, has else-if, [if]
+    WHILE,                  // condition, block
+    RETURN,                 // has expression, [expression]
+    BREAK,
+    CONTINUE
+};
+
+enum class ExprTag : std::uint8_t {
+    LITERAL,                // type, value (double, bool as byte or string)
+    BINARY_EXPRESSION,      // BinaryExpression::Operator, left operand, right operand
+    VAR_REFERENCE,          // name
+    STRING,                 // parts
+    FUNC_CALL               // name, arguments
+};
+
+} // namespace cache
+
+#endif // TKOMSIUNITS_CACHE_CACHE_FORMAT_H_INCLUDED
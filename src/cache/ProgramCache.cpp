@@ -0,0 +1,83 @@
+#include "ProgramCache.h"
+
+#include "ProgramReader.h"
+#include "ProgramWriter.h"
+#include "codeObjects/Program.h"
+#include "lexer/Lexer.h"
+#include "parser/Parser.h"
+#include "source/MappedFileSource.h"
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <unistd.h>
+
+std::unique_ptr<Program> ProgramCache::load(std::string_view source) {
+    std::filesystem::path path = getPath(source);
+    if (std::unique_ptr<Program> program = tryRead(path, source)) {
+        ++hitsCount_;
+        return program;
+    }
+    Lexer lexer(source);
+    Parser parser(lexer);
+    std::unique_ptr<Program> program = parser.parse();
+    tryWrite(path, source, *program);
+    return program;
+}
+
+std::filesystem::path ProgramCache::getPath(std::string_view source) const {
+    std::ostringstream name;
+    name << std::hex << std::setfill('0') << std::setw(16) << hash(source) << FILE_EXTENSION;
+    return directory_ / name.str();
+}
+
+std::uint64_t ProgramCache::hash(std::string_view source) {
+    std::uint64_t hash = 0xcbf29ce484222325;
+    for (char c : source) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001b3;
+    }
+    return hash;
+}
+
+std::unique_ptr<Program> ProgramCache::tryRead(const std::filesystem::path &path, std::string_view source) const {
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(path, error)) {
+        return nullptr;
+    }
+    try {
+        // strings are copied out of the file, so it is unmapped right after reading
+        MappedFileSource file(path.string());
+        return ProgramReader::read(file.getBuffer(), source);
+    } catch (const std::runtime_error &) {
+        // damaged or written by a different version; parsed and written again
+        return nullptr;
+    }
+}
+
+void ProgramCache::tryWrite(const std::filesystem::path &path, std::string_view source, const Program &program) const {
+    std::string data;
+    try {
+        data = ProgramWriter::write(program, source);
+    } catch (const std::runtime_error &) {
+        return;
+    }
+    std::error_code error;
+    std::filesystem::create_directories(directory_, error);
+    // renamed when complete, so that concurrent loads never read a partially written file
+    std::filesystem::path tempPath = path;
+    tempPath += ".tmp" + std::to_string(::getpid());
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.write(data.data(), static_cast<std::streamsize>(data.size())) || !file.flush()) {
+            file.close();
+            std::filesystem::remove(tempPath, error);
+            return;
+        }
+    }
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        std::filesystem::remove(tempPath, error);
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef TKOMSIUNITS_CACHE_PROGRAM_CACHE_H_INCLUDED
+#define TKOMSIUNITS_CACHE_PROGRAM_CACHE_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string_view>
+
+class Program;
+
+// Keeps parsed programs in files of a directory, named after the hash of their source;
+// a file keeps the whole source, so a colliding hash is a cache miss. A program whose
+// source was cached before is mapped into memory and rebuilt without
+// lexing and parsing it. Cache files that cannot be read are replaced; failures to
+// write them are ignored, so the cache never changes the result of loading a program.
+class ProgramCache {
+public:
+    static constexpr std::string_view FILE_EXTENSION = ".ulc";
+
+public:
+    explicit ProgramCache(std::filesystem::path directory)
+        : directory_(std::move(directory)) {}
+
+    // errors in the source are reported the same way as by the Parser
+    std::unique_ptr<Program> load(std::string_view source);
+
+    // programs rebuilt from the cache files by load()
+    std::size_t getHitsCount() const {
+        return hitsCount_;
+    }
+
+    std::filesystem::path getPath(std::string_view source) const;
+
+    // FNV-1a
+    static std::uint64_t hash(std::string_view source);
+
+private:
+    std::unique_ptr<Program> tryRead(const std::filesystem::path &path, std::string_view source) const;
+    void tryWrite(const std::filesystem::path &path, std::string_view source, const Program &program) const;
+
+private:
+    std::filesystem::path directory_;
+    std::size_t hitsCount_ = 0;
+};
+
+#endif // TKOMSIUNITS_CACHE_PROGRAM_CACHE_H_INCLUDED
@@ -0,0 +1,291 @@
+#include "ProgramReader.h"
+
+#include "CacheFormat.h"
+#include "codeObjects/Program.h"
+#include "codeObjects/FuncCall.h"
+#include "codeObjects/BinaryExpression.h"
+#include "codeObjects/Literal.h"
+#include "codeObjects/VarReference.h"
+#include "codeObjects/String.h"
+#include "codeObjects/VarDefOrAssignment.h"
+#include "codeObjects/If.h"
+#include "codeObjects/While.h"
+#include "codeObjects/Return.h"
+#include "codeObjects/Break.h"
+#include "codeObjects/Continue.h"
+#include "codeObjects/NodeArena.h"
+#include "error/ErrorHandler.h"
+#include <cstring>
+#include <utility>
+
+namespace {
+
+// far above nesting of any program parsed without exhausting the stack
+constexpr std::size_t MAX_NESTING_DEPTH = 10000;
+
+// tokens from which the Parser creates BinaryExpression with the operator
+constexpr std::pair<TokenType, std::string_view> operatorTokens[] = {
+    {TokenType::OP_ADD, "+"},
+    {TokenType::OP_ADD, "-"},
+    {TokenType::OP_MULT, "*"},
+    {TokenType::OP_MULT, "/"},
+    {TokenType::OP_REL, ">"},
+    {TokenType::OP_REL, ">="},
+    {TokenType::OP_REL, "<"},
+    {TokenType::OP_REL, "<="},
+    {TokenType::OP_EQ, "=="},
+    {TokenType::OP_EQ, "!="},
+    {TokenType::OP_AND, "&&"},
+    {TokenType::OP_OR, "||"}
+};
+
+// counts nesting of the code object being read
+class NestingGuard {
+public:
+    explicit NestingGuard(std::size_t &depth) : depth_(depth) {
+        if (++depth_ > MAX_NESTING_DEPTH) {
+            ErrorHandler::handleFromCache("Code objects nested too deeply");
+        }
+    }
+    ~NestingGuard() {
+        --depth_;
+    }
+    NestingGuard(const NestingGuard &) = delete;
+    NestingGuard& operator=(const NestingGuard &) = delete;
+
+private:
+    std::size_t &depth_;
+};
+
+} // anonymous namespace
+
+std::unique_ptr<Program> ProgramReader::read(std::string_view data, std::string_view source) {
+    ProgramReader reader(data);
+    return reader.readProgram(source);
+}
+
+std::unique_ptr<Program> ProgramReader::readProgram(std::string_view source) {
+    if (readRaw<std::uint32_t>() != cache::MAGIC) {
+        ErrorHandler::handleFromCache("Not a program cache file");
+    }
+    if (readRaw<std::uint32_t>() != cache::VERSION) {
+        ErrorHandler::handleFromCache("Unsupported program cache version");
+    }
+    // compared byte by byte: files are named after a short hash of the source, which may collide
+    if (readStringView() != source) {
+        ErrorHandler::handleFromCache("Program cached for a different source");
+    }
+
+    // code objects are allocated in the arena of the program, as by the Parser
+    auto arena = std::make_unique<NodeArena>();
+    NodeArena::Scope arenaScope(*arena);
+    std::vector<Variable> inputs = readVariables();
+    std::vector<std::unique_ptr<FuncDef>> funcDefs;
+    std::size_t funcDefsCount = readSize();
+    for (std::size_t i = 0; i < funcDefsCount; ++i) {
+        funcDefs.push_back(readFunction());
+    }
+    std::vector<std::unique_ptr<Instruction>> instructions = readInstructions();
+    if (pos_ != data_.size()) {
+        ErrorHandler::handleFromCache("Unexpected data after the program");
+    }
+    return std::make_unique<Program>(std::move(funcDefs), std::move(instructions), std::move(arena), std::move(inputs));
+}
+
+std::vector<Variable> ProgramReader::readVariables() {
+    std::vector<Variable> variables;
+    std::size_t variablesCount = readSize();
+    for (std::size_t i = 0; i < variablesCount; ++i) {
+        std::string name = readString();
+        variables.emplace_back(name, readType());
+    }
+    return variables;
+}
+
+std::unique_ptr<FuncDef> ProgramReader::readFunction() {
+    std::string name = readString();
+    std::vector<Variable> params = readVariables();
+    Type returnType = readType();
+    return std::make_unique<FuncDef>(name, std::move(params), std::move(returnType), readBlock());
+}
+
+std::unique_ptr<InstructionBlock> ProgramReader::readBlock() {
+    NestingGuard guard(depth_);
+    return std::make_unique<InstructionBlock>(readInstructions());
+}
+
+std::vector<std::unique_ptr<Instruction>> ProgramReader::readInstructions() {
+    std::vector<std::unique_ptr<Instruction>> instructions;
+    std::size_t instructionsCount = readSize();
+    for (std::size_t i = 0; i < instructionsCount; ++i) {
+        instructions.push_back(readInstruction());
+    }
+    return instructions;
+}
+
+std::unique_ptr<Instruction> ProgramReader::readInstruction() {
+    switch (readRaw<cache::InstrTag>()) {
+        case cache::InstrTag::VAR_DEF_OR_ASSIGNMENT: {
+            std::string name = readString();
+            std::optional<Type> declaredType;
+            if (readFlag()) {
+                declaredType = readType();
+            }
+            return std::make_unique<VarDefOrAssignment>(name, readExpression(), std::move(declaredType));
+        }
+        case cache::InstrTag::FUNC_CALL: {
+            std::string name = readString();
+            return std::make_unique<FuncCall>(name, readArgs());
+        }
+        case cache::InstrTag::IF:
+            return readIf();
+        case cache::InstrTag::WHILE: {
+            std::unique_ptr<Expression> cond = readExpression();
+            return std::make_unique<While>(std::move(cond), readBlock());
+        }
+        case cache::InstrTag::RETURN:
+            return std::make_unique<Return>(readFlag() ? readExpression() : nullptr);
+        case cache::InstrTag::BREAK:
+            return std::make_unique<Break>();
+        case cache::InstrTag::CONTINUE:
+            return std::make_unique<Continue>();
+    }
+    ErrorHandler::handleFromCache("Unknown instruction");
+}
+
+std::unique_ptr<If> ProgramReader::readIf() {
+    NestingGuard guard(depth_);
+    std::unique_ptr<Expression> cond = readFlag() ? readExpression() : nullptr;
+    std::unique_ptr<InstructionBlock> positiveBlock = readBlock();
+    std::unique_ptr<If> elseIf;
+    if (readFlag()) {
+        if (readRaw<cache::InstrTag>() != cache::InstrTag::IF) {
+            ErrorHandler::handleFromCache("Else branch of If is not If");
+        }
+        elseIf = readIf();
+    }
+    if (!cond) {
+        return std::make_unique<If>(std::move(positiveBlock));
+    }
+    return std::make_unique<If>(std::move(cond), std::move(positiveBlock), std::move(elseIf));
+}
+
+std::unique_ptr<Expression> ProgramReader::readExpression() {
+    NestingGuard guard(depth_);
+    switch (readRaw<cache::ExprTag>()) {
+        case cache::ExprTag::LITERAL: {
+            Type type = readType();
+            switch (type.getTypeClass()) {
+                case Type::NUMBER: {
+                    double number = readRaw<double>();
+                    return std::make_unique<Literal>(Value(number, std::move(type)));
+                }
+                case Type::BOOL:
+                    return std::make_unique<Literal>(Value(readFlag()));
+                case Type::STRING:
+                    return std::make_unique<Literal>(Value(readString()));
+                case Type::ARRAY: {
+                    std::size_t size = readSize();
+                    if (size > (data_.size() - pos_) / sizeof(double)) {
+                        ErrorHandler::handleFromCache("Unexpected end of data");
+                    }
+                    std::vector<double> elements(size);
+                    for (double &element : elements) {
+                        element = readRaw<double>();
+                    }
+                    return std::make_unique<Literal>(Value(std::move(elements), std::move(type)));
+                }
+                default:
+                    ErrorHandler::handleFromCache("Literal of type void");
+            }
+        }
+        case cache::ExprTag::BINARY_EXPRESSION: {
+            auto op = static_cast<std::size_t>(readRaw<BinaryExpression::Operator>());
+            if (op >= std::size(operatorTokens)) {
+                ErrorHandler::handleFromCache("Unknown binary operator");
+            }
+            std::unique_ptr<Expression> left = readExpression();
+            std::unique_ptr<Expression> right = readExpression();
+            auto [tokenType, text] = operatorTokens[op];
+            return std::make_unique<BinaryExpression>(std::move(left), Token{ tokenType, text }, std::move(right));
+        }
+        case cache::ExprTag::VAR_REFERENCE:
+            return std::make_unique<VarReference>(readString());
+        case cache::ExprTag::STRING:
+            return std::make_unique<codeobj::String>(readArgs());
+        case cache::ExprTag::FUNC_CALL: {
+            std::string name = readString();
+            return std::make_unique<FuncCall>(name, readArgs());
+        }
+    }
+    ErrorHandler::handleFromCache("Unknown expression");
+}
+
+std::vector<std::unique_ptr<Expression>> ProgramReader::readArgs() {
+    std::vector<std::unique_ptr<Expression>> args;
+    std::size_t argsCount = readSize();
+    for (std::size_t i = 0; i < argsCount; ++i) {
+        args.push_back(readExpression());
+    }
+    return args;
+}
+
+Type ProgramReader::readType() {
+    auto typeClass = static_cast<Type::TypeClass>(readRaw<std::uint8_t>());
+    switch (typeClass) {
+        case Type::VOID:
+        case Type::BOOL:
+        case Type::STRING:
+            return Type(typeClass);
+        case Type::NUMBER:
+        case Type::ARRAY:
+            break;
+        default:
+            ErrorHandler::handleFromCache("Unknown type");
+    }
+    codeobj::Unit unit;
+    for (std::size_t i = 0; i < unitTypesCount; ++i) {
+        int exponent = readRaw<codeobj::Unit::Exponent>();
+        auto prefix = readRaw<UnitPrefix>();
+        if (static_cast<std::size_t>(prefix) >= unitPrefixes.size()) {
+            ErrorHandler::handleFromCache("Unknown unit prefix");
+        }
+        if (exponent != 0) {
+            unit.multWithUnit(codeobj::Unit(::Unit{ prefix, static_cast<UnitType>(i), exponent }));
+        }
+    }
+    return Type(typeClass, std::move(unit));
+}
+
+std::string ProgramReader::readString() {
+    return std::string(readStringView());
+}
+
+std::string_view ProgramReader::readStringView() {
+    std::size_t size = readSize();
+    if (size > data_.size() - pos_) {
+        ErrorHandler::handleFromCache("Unexpected end of data");
+    }
+    std::string_view str = data_.substr(pos_, size);
+    pos_ += size;
+    return str;
+}
+
+std::size_t ProgramReader::readSize() {
+    return readRaw<std::uint32_t>();
+}
+
+bool ProgramReader::readFlag() {
+    return readRaw<std::uint8_t>() != 0;
+}
+
+template <typename T>
+T ProgramReader::readRaw() {
+    if (sizeof(T) > data_.size() - pos_) {
+        ErrorHandler::handleFromCache("Unexpected end of data");
+    }
+    T value;
+    std::memcpy(&value, data_.data() + pos_, sizeof(T));
+    pos_ += sizeof(T);
+    return value;
+}
@@ -0,0 +1,56 @@
+#ifndef TKOMSIUNITS_CACHE_PROGRAM_READER_H_INCLUDED
+#define TKOMSIUNITS_CACHE_PROGRAM_READER_H_INCLUDED
+
+#include "codeObjects/Type.h"
+#include "codeObjects/Variable.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Program;
+class FuncDef;
+class Instruction;
+class InstructionBlock;
+class Expression;
+class If;
+
+// Rebuilds a Program from the data written by ProgramWriter. The code objects are
+// created the same way as by the Parser (in a NodeArena), so the Program runs its
+// analyses on them again. Malformed data is reported as a cache error.
+class ProgramReader {
+public:
+    // source: data written for a different source is reported as a cache error
+    static std::unique_ptr<Program> read(std::string_view data, std::string_view source);
+
+private:
+    explicit ProgramReader(std::string_view data) : data_(data) {}
+
+    std::unique_ptr<Program> readProgram(std::string_view source);
+    std::vector<Variable> readVariables();
+    std::unique_ptr<FuncDef> readFunction();
+    std::unique_ptr<InstructionBlock> readBlock();
+    std::vector<std::unique_ptr<Instruction>> readInstructions();
+    std::unique_ptr<Instruction> readInstruction();
+    std::unique_ptr<If> readIf();
+    std::unique_ptr<Expression> readExpression();
+    std::vector<std::unique_ptr<Expression>> readArgs();
+    Type readType();
+    std::string readString();
+    // view of the data, valid as long as the data
+    std::string_view readStringView();
+    std::size_t readSize();
+    bool readFlag();
+    template <typename T>
+    T readRaw();
+
+private:
+    std::string_view data_;
+    std::size_t pos_ = 0;
+    // limits nesting of blocks and expressions, so that corrupted data cannot exhaust the stack
+    std::size_t depth_ = 0;
+};
+
+#endif // TKOMSIUNITS_CACHE_PROGRAM_READER_H_INCLUDED
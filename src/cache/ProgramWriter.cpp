@@ -0,0 +1,210 @@
+#include "ProgramWriter.h"
+
+#include "CacheFormat.h"
+#include "codeObjects/Program.h"
+#include "codeObjects/FuncCall.h"
+#include "codeObjects/BinaryExpression.h"
+#include "codeObjects/Literal.h"
+#include "codeObjects/VarReference.h"
+#include "codeObjects/String.h"
+#include "codeObjects/VarDefOrAssignment.h"
+#include "codeObjects/If.h"
+#include "codeObjects/While.h"
+#include "codeObjects/Return.h"
+#include "codeObjects/InternalPrintInstr.h"
+#include "error/ErrorHandler.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <variant>
+
+std::string ProgramWriter::write(const Program &program, std::string_view source) {
+    ProgramWriter writer;
+    writer.writeRaw(cache::MAGIC);
+    writer.writeRaw(cache::VERSION);
+    writer.writeString(source);
+
+    writer.writeVariables(program.getInputs());
+
+    // print() is predefined by every Program
+    std::vector<const FuncDef *> functions;
+    for (auto &&[name, funcDef] : program.getFuncDefs()) {
+        if (name != "print") {
+            functions.push_back(funcDef.get());
+        }
+    }
+    std::sort(functions.begin(), functions.end(), [](const FuncDef *left, const FuncDef *right) {
+            return left->getName() < right->getName();
+        });
+    writer.writeSize(functions.size());
+    for (const FuncDef *funcDef : functions) {
+        writer.writeFunction(*funcDef);
+    }
+    writer.writeBlock(program.getInstructions());
+    return std::move(writer.out_);
+}
+
+void ProgramWriter::writeVariables(const std::vector<Variable> &variables) {
+    writeSize(variables.size());
+    for (auto &&variable : variables) {
+        writeString(variable.getName());
+        writeType(variable.getType());
+    }
+}
+
+void ProgramWriter::writeFunction(const FuncDef &funcDef) {
+    writeString(funcDef.getName());
+    writeVariables(funcDef.getParams());
+    writeType(funcDef.getType());
+    writeBlock(funcDef.getBody());
+}
+
+void ProgramWriter::writeBlock(const InstructionBlock &block) {
+    writeSize(block.getInstructions().size());
+    for (auto &&instr : block.getInstructions()) {
+        asStatement_ = true;
+        instr->accept(*this);
+    }
+}
+
+void ProgramWriter::writeArgs(const std::vector<std::unique_ptr<Expression>> &args) {
+    writeSize(args.size());
+    for (auto &&arg : args) {
+        asStatement_ = false;
+        arg->accept(*this);
+    }
+}
+
+void ProgramWriter::writeType(const Type &type) {
+    writeRaw(static_cast<std::uint8_t>(type.getTypeClass()));
+    if (type.getTypeClass() != Type::NUMBER && type.getTypeClass() != Type::ARRAY) {
+        return;
+    }
+    for (std::size_t i = 0; i < unitTypesCount; ++i) {
+        auto unitType = static_cast<UnitType>(i);
+        writeRaw(static_cast<codeobj::Unit::Exponent>(type.asUnit().getExponent(unitType)));
+        writeRaw(static_cast<std::uint8_t>(type.asUnit().getPrefix(unitType)));
+    }
+}
+
+void ProgramWriter::writeString(std::string_view str) {
+    writeSize(str.size());
+    out_.append(str);
+}
+
+void ProgramWriter::writeSize(std::size_t size) {
+    if (size > std::numeric_limits<std::uint32_t>::max()) {
+        ErrorHandler::handleFromCache("Program too large to be cached");
+    }
+    writeRaw(static_cast<std::uint32_t>(size));
+}
+
+template <typename T>
+void ProgramWriter::writeRaw(T value) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    out_.append(bytes, sizeof(T));
+}
+
+void ProgramWriter::visit(Literal &literal) {
+    const Value &value = literal.getValue();
+    writeRaw(cache::ExprTag::LITERAL);
+    writeType(value.type);
+    switch (value.type.getTypeClass()) {
+        case Type::NUMBER:
+            writeRaw(value.asDouble());
+            break;
+        case Type::BOOL:
+            writeRaw(static_cast<std::uint8_t>(value.asBool()));
+            break;
+        case Type::ARRAY:
+            writeSize(value.asArray().size());
+            for (double element : value.asArray()) {
+                writeRaw(element);
+            }
+            break;
+        default:
+            writeString(std::get<std::string>(value.value));
+            break;
+    }
+}
+
+void ProgramWriter::visit(BinaryExpression &expr) {
+    writeRaw(cache::ExprTag::BINARY_EXPRESSION);
+    writeRaw(expr.getOperatorKind());
+    expr.getLeftOperand().accept(*this);
+    expr.getRightOperand().accept(*this);
+}
+
+void ProgramWriter::visit(VarReference &varRef) {
+    writeRaw(cache::ExprTag::VAR_REFERENCE);
+    writeString(varRef.getName());
+}
+
+void ProgramWriter::visit(codeobj::String &str) {
+    writeRaw(cache::ExprTag::STRING);
+    writeArgs(str.getParts());
+}
+
+void ProgramWriter::visit(FuncCall &funcCall) {
+    if (asStatement_) {
+        writeRaw(cache::InstrTag::FUNC_CALL);
+    } else {
+        writeRaw(cache::ExprTag::FUNC_CALL);
+    }
+    writeString(funcCall.getName());
+    writeArgs(funcCall.getArgs());
+}
+
+void ProgramWriter::visit(VarDefOrAssignment &instr) {
+    writeRaw(cache::InstrTag::VAR_DEF_OR_ASSIGNMENT);
+    writeString(instr.getName());
+    writeRaw(static_cast<std::uint8_t>(instr.getDeclaredType().has_value()));
+    if (instr.getDeclaredType()) {
+        writeType(*instr.getDeclaredType());
+    }
+    asStatement_ = false;
+    instr.getExpr().accept(*this);
+}
+
+void ProgramWriter::visit(If &instr) {
+    writeRaw(cache::InstrTag::IF);
+    writeRaw(static_cast<std::uint8_t>(instr.getCond() != nullptr));
+    if (instr.getCond()) {
+        asStatement_ = false;
+        instr.getCond()->accept(*this);
+    }
+    writeBlock(instr.getPositiveBlock());
+    writeRaw(static_cast<std::uint8_t>(instr.getElseIf() != nullptr));
+    if (instr.getElseIf()) {
+        instr.getElseIf()->accept(*this);
+    }
+}
+
+void ProgramWriter::visit(While &instr) {
+    writeRaw(cache::InstrTag::WHILE);
+    asStatement_ = false;
+    instr.getCond().accept(*this);
+    writeBlock(instr.getBody());
+}
+
+void ProgramWriter::visit(Return &instr) {
+    writeRaw(cache::InstrTag::RETURN);
+    writeRaw(static_cast<std::uint8_t>(instr.getExpr() != nullptr));
+    if (instr.getExpr()) {
+        asStatement_ = false;
+        instr.getExpr()->accept(*this);
+    }
+}
+
+void ProgramWriter::visit([[maybe_unused]] Break &instr) {
+    writeRaw(cache::InstrTag::BREAK);
+}
+
+void ProgramWriter::visit([[maybe_unused]] Continue &instr) {
+    writeRaw(cache::InstrTag::CONTINUE);
+}
+
+void ProgramWriter::visit([[maybe_unused]] InternalPrintInstr &instr) {
+    ErrorHandler::handleFromCache("Body of predefined function cannot be cached");
+}
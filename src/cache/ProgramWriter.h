@@ -0,0 +1,58 @@
+#ifndef TKOMSIUNITS_CACHE_PROGRAM_WRITER_H_INCLUDED
+#define TKOMSIUNITS_CACHE_PROGRAM_WRITER_H_INCLUDED
+
+#include "codeObjects/CodeObjectVisitor.h"
+#include "codeObjects/Type.h"
+#include "codeObjects/Value.h"
+#include "codeObjects/Variable.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Program;
+class FuncDef;
+class Expression;
+class InstructionBlock;
+
+// Serializes code objects of Program into the format described in CacheFormat.h.
+// Analyses of the Program are not stored - they are repeated when it is read.
+class ProgramWriter : private CodeObjectVisitor {
+public:
+    // source: the program is read back only for the same source
+    static std::string write(const Program &program, std::string_view source);
+
+private:
+    ProgramWriter() = default;
+
+    void writeVariables(const std::vector<Variable> &variables);
+    void writeFunction(const FuncDef &funcDef);
+    void writeBlock(const InstructionBlock &block);
+    void writeArgs(const std::vector<std::unique_ptr<Expression>> &args);
+    void writeType(const Type &type);
+    void writeString(std::string_view str);
+    void writeSize(std::size_t size);
+    template <typename T>
+    void writeRaw(T value);
+
+    void visit(Literal &literal) override;
+    void visit(BinaryExpression &expr) override;
+    void visit(VarReference &varRef) override;
+    void visit(codeobj::String &str) override;
+    void visit(FuncCall &funcCall) override;
+    void visit(VarDefOrAssignment &instr) override;
+    void visit(If &instr) override;
+    void visit(While &instr) override;
+    void visit(Return &instr) override;
+    void visit(Break &instr) override;
+    void visit(Continue &instr) override;
+    void visit(InternalPrintInstr &instr) override;
+
+private:
+    std::string out_;
+    // FuncCall is written as instruction or expression
+    bool asStatement_ = false;
+};
+
+#endif // TKOMSIUNITS_CACHE_PROGRAM_WRITER_H_INCLUDED
@@ -0,0 +1,183 @@
+#include "ProgramCache.h"
+#include "ProgramReader.h"
+#include "ProgramWriter.h"
+#include "codeObjects/Program.h"
+#include "codeObjects/Interpreter.h"
+#include "source/StringSource.h"
+#include "lexer/Lexer.h"
+#include "parser/Parser.h"
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+namespace {
+
+struct RunResult {
+    int exitStatus;
+    std::string stdout;
+};
+
+const std::string testScript =
+    "a = 10\n b = 0\n c = 0[km/s2]\n"
+    "while a > 0 {"
+    "    a = a - 1\n"
+    "    if a > 7 { continue\n } elif a == 7 { b = b + 10\n } else { b = b + 0\n }\n"
+    "    c = a * 1[km/s2]\n"
+    "    b = b + 1\n"
+    "    if a < 3 { break\n }\n"
+    "}\n"
+    "func fibonacci (steps [1]) -> [m] {"
+    "    if steps < 2 {"
+    "        return steps * 1[m]\n"
+    "    }\n"
+    "    return fibonacci(steps - 1) + fibonacci(steps - 2)\n"
+    "}\n"
+    "func describe (x [mN*cm], flag [bool]) {"
+    "    y = x\n"
+    "    print(\"{y} {flag}\")\n"
+    "}\n"
+    "f = fibonacci(15)\n"
+    "describe(2[mN*cm], true)\n"
+    "l = b > 100 && f > 0[m] || false\n"
+    "name = \"b\"\n"
+    "samples [array km] = [1, -2.5, 4000][km] * 2\n"
+    "print(\"a = {a}, {name} = {b}, {f} {l} {c} {samples}\")\n"
+    "return b\n";
+
+std::unique_ptr<Program> parse(const std::string &input) {
+    StringSource src(input);
+    Lexer lexer(src);
+    Parser parser(lexer);
+    return parser.parse();
+}
+
+RunResult run(Program &program) {
+    std::ostringstream testStdout;
+    Interpreter interp(testStdout, program);
+    int exitStatus = interp.executeProgram();
+    return RunResult{ exitStatus, testStdout.str() };
+}
+
+class CacheTests : public testing::Test {
+protected:
+    void SetUp() override {
+        directory_ = std::filesystem::temp_directory_path() / ("unitslang_cache_tests_" + std::to_string(::getpid()));
+        std::filesystem::remove_all(directory_);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(directory_);
+    }
+
+    std::filesystem::path directory_;
+};
+
+} // anonymous namespace
+
+TEST_F(CacheTests, CachedProgramExecutesLikeParsed) {
+    RunResult expected = run(*parse(testScript));
+    EXPECT_EQ(16, expected.exitStatus);
+
+    ProgramCache cache(directory_);
+    std::unique_ptr<Program> parsed = cache.load(testScript);
+    EXPECT_EQ(0u, cache.getHitsCount());
+    EXPECT_TRUE(std::filesystem::is_regular_file(cache.getPath(testScript)));
+    std::unique_ptr<Program> cached = cache.load(testScript);
+    EXPECT_EQ(1u, cache.getHitsCount());
+
+    for (Program *program : { parsed.get(), cached.get() }) {
+        RunResult result = run(*program);
+        EXPECT_EQ(expected.exitStatus, result.exitStatus);
+        EXPECT_EQ(expected.stdout, result.stdout);
+    }
+    // a different source is not loaded from the file of the first one
+    ProgramCache otherCache(directory_);
+    run(*otherCache.load(testScript + "b = 1\n"));
+    EXPECT_EQ(0u, otherCache.getHitsCount());
+}
+
+TEST_F(CacheTests, RebuiltProgramIsWrittenUnchanged) {
+    std::unique_ptr<Program> program = parse(testScript);
+    std::string data = ProgramWriter::write(*program, testScript);
+    std::unique_ptr<Program> rebuilt = ProgramReader::read(data, testScript);
+    EXPECT_EQ(data, ProgramWriter::write(*rebuilt, testScript));
+
+    EXPECT_THROW(ProgramReader::read(data, testScript + ' '), std::runtime_error);
+    for (std::size_t size : { std::size_t(0), std::size_t(10), data.size() / 2, data.size() - 1 }) {
+        EXPECT_THROW(ProgramReader::read(data.substr(0, size), testScript), std::runtime_error);
+    }
+    EXPECT_THROW(ProgramReader::read(data + '\0', testScript), std::runtime_error);
+}
+
+TEST_F(CacheTests, RedefinedFunctionIsRejected) {
+    const std::string input = "func fa () {\n}\nfunc fb () {\n}\nfunc fc () {\n}\nfunc fd () {\n}\n";
+    std::unique_ptr<Program> program = parse(input);
+    std::string data = ProgramWriter::write(*program, input);
+    // a damaged file may define a function twice; the source in the header is kept
+    std::size_t codeStart = data.find(input) + input.size();
+    for (std::size_t pos = data.find("fb", codeStart); pos != std::string::npos; pos = data.find("fb", pos)) {
+        data.replace(pos, 2, "fa");
+    }
+    EXPECT_THROW(ProgramReader::read(data, input), std::runtime_error);
+}
+
+TEST_F(CacheTests, DamagedCacheFileIsReplaced) {
+    ProgramCache cache(directory_);
+    cache.load(testScript);
+    std::filesystem::path path = cache.getPath(testScript);
+    std::uintmax_t size = std::filesystem::file_size(path);
+    std::filesystem::resize_file(path, size / 2);
+
+    RunResult result = run(*cache.load(testScript));
+    EXPECT_EQ(0u, cache.getHitsCount());
+    EXPECT_EQ(16, result.exitStatus);
+    EXPECT_EQ(size, std::filesystem::file_size(path));
+    cache.load(testScript);
+    EXPECT_EQ(1u, cache.getHitsCount());
+}
+
+TEST_F(CacheTests, FileOfCollidingSourceIsNotUsed) {
+    // the program of another source stored under the name of the loaded one,
+    // as after a collision of their hashes
+    const std::string other = "return 3\n";
+    ProgramCache cache(directory_);
+    cache.load(other);
+    std::filesystem::create_directories(directory_);
+    std::filesystem::rename(cache.getPath(other), cache.getPath(testScript));
+
+    RunResult result = run(*cache.load(testScript));
+    EXPECT_EQ(0u, cache.getHitsCount());
+    EXPECT_EQ(16, result.exitStatus);
+    cache.load(testScript);
+    EXPECT_EQ(1u, cache.getHitsCount());
+}
+
+TEST_F(CacheTests, ErrorsInSourceAreNotCached) {
+    ProgramCache cache(directory_);
+    const std::string input = "a = 1[m]\n b = a + 1[s]\n";
+    EXPECT_THROW(cache.load(input), std::runtime_error);
+    EXPECT_FALSE(std::filesystem::exists(cache.getPath(input)));
+}
+
+TEST_F(CacheTests, InputsOfProgramAreWritten) {
+    const std::string input = "speed = distance / 2[s]\n print(\"{label} {speed}\")\n";
+    StringSource src(input);
+    Lexer lexer(src);
+    Parser parser(lexer);
+    std::unique_ptr<Program> program = parser.parse({
+            Variable("distance", Type(codeobj::Unit(Unit{ UnitPrefix::KILO, UnitType::METER, 1 }))),
+            Variable("label", Type(Type::STRING))
+        });
+    std::string data = ProgramWriter::write(*program, input);
+    std::unique_ptr<Program> rebuilt = ProgramReader::read(data, input);
+    ASSERT_EQ(2u, rebuilt->getInputs().size());
+    EXPECT_EQ("distance", rebuilt->getInputs()[0].getName());
+    EXPECT_TRUE(rebuilt->getInputs()[0].getType().isIdenticalTo(program->getInputs()[0].getType()));
+    EXPECT_EQ("label", rebuilt->getInputs()[1].getName());
+    EXPECT_EQ(Type::STRING, rebuilt->getInputs()[1].getType().getTypeClass());
+}
@@ -1,48 +1,126 @@
 #include "BinaryExpression.h"
 
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
 namespace {
 
-void assertNumberTypes(const Value &left, const Value &right, const std::string &opName) {
+void assertNumberTypes(const Value &left, const Value &right, const char *opName) {
     if (left.type.getTypeClass() != Type::NUMBER || right.type.getTypeClass() != Type::NUMBER) {
-        ErrorHandler::handleTypeMismatch(opName + " operands must be of numeric type");
+        ErrorHandler::handleTypeMismatch(std::string(opName) + " operands must be of numeric type");
     }
 }
-void assertBoolTypes(const Value &left, const Value &right, const std::string &opName) {
+void assertBoolTypes(const Value &left, const Value &right, const char *opName) {
     if (left.type.getTypeClass() != Type::BOOL || right.type.getTypeClass() != Type::BOOL) {
-        ErrorHandler::handleTypeMismatch(opName + " operands must be of bool type");
+        ErrorHandler::handleTypeMismatch(std::string(opName) + " operands must be of bool type");
     }
 }
-void assertNumberOrBoolTypes(const Value &left, const Value &right, const std::string &opName) {
+void assertNumberOrBoolTypes(const Value &left, const Value &right, const char *opName) {
     if ((left.type.getTypeClass() != Type::NUMBER && left.type.getTypeClass() != Type::BOOL)
         || (right.type.getTypeClass() != Type::NUMBER && right.type.getTypeClass() != Type::BOOL)
     ) {
-        ErrorHandler::handleTypeMismatch(opName + " operands must be of numeric or bool type");
+        ErrorHandler::handleTypeMismatch(std::string(opName) + " operands must be of numeric or bool type");
     }
 }
-void assertEqualTypes(const Value &left, const Value &right, const std::string &opName) {
+void assertEqualTypes(const Value &left, const Value &right, const char *opName) {
     if (left.type != right.type) {
-        ErrorHandler::handleTypeMismatch(opName + " operands are not type-compatibile");
+        ErrorHandler::handleTypeMismatch(std::string(opName) + " operands are not type-compatibile");
+    }
+}
+
+// units of the result of an operation on arrays
+enum class ArrayUnit {
+    LEFT,       // + -: unit of the left operand
+    MULT,       // units of the operands are combined
+    DIV,
+    MASK        // comparisons: scalar 1 for true, 0 for false
+};
+
+// Element-wise kernels: plain loops over contiguous elements, without branches
+// or calls, so that the compiler vectorizes them (SIMD) in optimized builds.
+template <typename Op>
+void applyToElements(double *left, const double *right, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        left[i] = Op{}(left[i], right[i]);
     }
 }
+template <typename Op>
+void applyToElements(double *left, double right, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        left[i] = Op{}(left[i], right);
+    }
+}
+template <typename Op>
+void applyToElements(double left, const double *right, double *result, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        result[i] = Op{}(left, right[i]);
+    }
+}
+
+bool isArrayOperation(const Value &left, const Value &right) {
+    return left.type.getTypeClass() == Type::ARRAY || right.type.getTypeClass() == Type::ARRAY;
+}
+
+// operands are arrays or numbers, at least one of them is an array; units are
+// checked and combined once for the whole array, not for every element
+template <typename Op, ArrayUnit arrayUnit>
+void arrayOp(Value &left, const Value &right, const char *opName) {
+    auto isNumeric = [](const Value &value) {
+            return value.type.getTypeClass() == Type::NUMBER || value.type.getTypeClass() == Type::ARRAY;
+        };
+    if (!isNumeric(left) || !isNumeric(right)) {
+        ErrorHandler::handleTypeMismatch(std::string(opName) + " operands must be of numeric or array type");
+    }
+    codeobj::Unit unit = left.type.asUnit();
+    if constexpr (arrayUnit == ArrayUnit::MULT) {
+        unit.multWithUnit(right.type.asUnit());
+    } else if constexpr (arrayUnit == ArrayUnit::DIV) {
+        unit.divWithUnit(right.type.asUnit());
+    } else if (!unit.isAddCompatibileWith(right.type.asUnit())) {
+        ErrorHandler::handleTypeMismatch(std::string(opName) + " operands are not type-compatibile");
+    }
+    if constexpr (arrayUnit == ArrayUnit::MASK) {
+        unit = codeobj::Unit();
+    }
+
+    if (right.type.getTypeClass() != Type::ARRAY) {
+        std::vector<double> &elements = left.asArray();
+        applyToElements<Op>(elements.data(), right.asDouble(), elements.size());
+    } else if (left.type.getTypeClass() != Type::ARRAY) {
+        const std::vector<double> &rightElements = right.asArray();
+        std::vector<double> elements(rightElements.size());
+        applyToElements<Op>(left.asDouble(), rightElements.data(), elements.data(), elements.size());
+        left.value = std::move(elements);
+    } else {
+        std::vector<double> &elements = left.asArray();
+        if (elements.size() != right.asArray().size()) {
+            ErrorHandler::handleTypeMismatch(std::string(opName) + " operands are arrays of different lengths");
+        }
+        applyToElements<Op>(elements.data(), right.asArray().data(), elements.size());
+    }
+    left.type = Type(Type::ARRAY, std::move(unit));
+}
 
 template <typename BinaryFunc>
-void additiveOp(Value &left, const Value &right, BinaryFunc &&func, const std::string &opName) {
+void additiveOp(Value &left, const Value &right, BinaryFunc &&func, const char *opName) {
     assertNumberTypes(left, right, opName);
     assertEqualTypes(left, right, opName);
     left.value = func(left.asDouble(), right.asDouble());
 }
 template <typename BinaryFunc>
-void multiplicativeOp(Value &left, const Value &right, BinaryFunc &&func, const std::string &opName) {
+void multiplicativeOp(Value &left, const Value &right, BinaryFunc &&func, const char *opName) {
     assertNumberTypes(left, right, opName);
     left.value = func(left.asDouble(), right.asDouble());
 }
 template <typename BinaryFunc>
-void relativeOp(Value &left, const Value &right, BinaryFunc &&func, const std::string &opName) {
+void relativeOp(Value &left, const Value &right, BinaryFunc &&func, const char *opName) {
     additiveOp(left, right, std::forward<BinaryFunc>(func), opName);
     left.type = Type::BOOL;
 }
 template <typename BinaryFunc>
-void equalityOp(Value &left, const Value &right, BinaryFunc &&func, const std::string &opName) {
+void equalityOp(Value &left, const Value &right, BinaryFunc &&func, const char *opName) {
     assertNumberOrBoolTypes(left, right, opName);
     assertEqualTypes(left, right, opName);
     if (left.type.getTypeClass() == Type::BOOL) {
@@ -53,42 +131,82 @@ void equalityOp(Value &left, const Value &right, BinaryFunc &&func, const std::s
     left.type = Type::BOOL;
 }
 template <typename BinaryFunc>
-void logicalOp(Value &left, const Value &right, BinaryFunc &&func, const std::string &opName) {
+void logicalOp(Value &left, const Value &right, BinaryFunc &&func, const char *opName) {
     assertBoolTypes(left, right, opName);
     assertEqualTypes(left, right, opName);
     left.value = func(left.asBool(), right.asBool());
 }
 
 void add(Value &left, const Value &right) {
+    if (isArrayOperation(left, right)) {
+        arrayOp<std::plus<double>, ArrayUnit::LEFT>(left, right, "Addition");
+        return;
+    }
     additiveOp(left, right, std::plus<double>{}, "Addition");
 }
 void subtract(Value &left, const Value &right) {
+    if (isArrayOperation(left, right)) {
+        arrayOp<std::minus<double>, ArrayUnit::LEFT>(left, right, "Subtraction");
+        return;
+    }
     additiveOp(left, right, std::minus<double>{}, "Subtraction");
 }
 void mult(Value &left, const Value &right) {
+    if (isArrayOperation(left, right)) {
+        arrayOp<std::multiplies<double>, ArrayUnit::MULT>(left, right, "Multiplication");
+        return;
+    }
     multiplicativeOp(left, right, std::multiplies<double>{}, "Multiplication");
     left.type.asUnit().multWithUnit(right.type.asUnit());
 }
 void div(Value &left, const Value &right) {
+    if (isArrayOperation(left, right)) {
+        arrayOp<std::divides<double>, ArrayUnit::DIV>(left, right, "Division");
+        return;
+    }
     multiplicativeOp(left, right, std::divides<double>{}, "Division");
     left.type.asUnit().divWithUnit(right.type.asUnit());
 }
 void greaterThan(Value &left, const Value &right) {
+    if (isArrayOperation(left, right)) {
+        arrayOp<std::greater<double>, ArrayUnit::MASK>(left, right, "GreaterThan");
+        return;
+    }
     relativeOp(left, right, std::greater<double>{}, "GreaterThan");
 }
 void greaterThanOrEqual(Value &left, const Value &right) {
+    if (isArrayOperation(left, right)) {
+        arrayOp<std::greater_equal<double>, ArrayUnit::MASK>(left, right, "GreaterThanOrEqual");
+        return;
+    }
     relativeOp(left, right, std::greater_equal<double>{}, "GreaterThanOrEqual");
 }
 void lessThan(Value &left, const Value &right) {
+    if (isArrayOperation(left, right)) {
+        arrayOp<std::less<double>, ArrayUnit::MASK>(left, right, "LessThan");
+        return;
+    }
     relativeOp(left, right, std::less<double>{}, "LessThan");
 }
 void lessThanOrEqual(Value &left, const Value &right) {
+    if (isArrayOperation(left, right)) {
+        arrayOp<std::less_equal<double>, ArrayUnit::MASK>(left, right, "LessThanOrEqual");
+        return;
+    }
     relativeOp(left, right, std::less_equal<double>{}, "LessThanOrEqual");
 }
 void equalTo(Value &left, const Value &right) {
+    if (isArrayOperation(left, right)) {
+        arrayOp<std::equal_to<double>, ArrayUnit::MASK>(left, right, "EqualTo");
+        return;
+    }
     equalityOp(left, right, std::equal_to<>{}, "EqualTo");
 }
 void notEqualTo(Value &left, const Value &right) {
+    if (isArrayOperation(left, right)) {
+        arrayOp<std::not_equal_to<double>, ArrayUnit::MASK>(left, right, "NotEqualTo");
+        return;
+    }
     equalityOp(left, right, std::not_equal_to<>{}, "NotEqualTo");
 }
 void logicAnd(Value &left, const Value &right) {
@@ -100,23 +218,283 @@ void logicOr(Value &left, const Value &right) {
 
 } // anonymous namespace
 
-Value BinaryExpression::calculate([[maybe_unused]] Interpreter &interpreter) {
-    static const std::unordered_map<std::string, void(*)(Value &, const Value &)> operations {
-        {"+" , &add},
-        {"-" , &subtract},
-        {"*" , &mult},
-        {"/" , &div},
-        {">" , &greaterThan},
-        {">=" , &greaterThanOrEqual},
-        {"<" , &lessThan},
-        {"<=" , &lessThanOrEqual},
-        {"==", &equalTo},
-        {"!=", &notEqualTo},
-        {"&&", &logicAnd},
-        {"||", &logicOr}
+struct BinaryExpression::Kernels {
+    template <Operation operation>
+    static void applyDynamic([[maybe_unused]] const BinaryExpression &expr, Value &left, const Value &right) {
+        operation(left, right);
+    }
+    static double calculateNumberDynamic(const BinaryExpression &expr, Interpreter &interpreter) {
+        return expr.calculate(interpreter).asDouble();
+    }
+    static bool calculateBoolDynamic(const BinaryExpression &expr, Interpreter &interpreter) {
+        return expr.calculate(interpreter).asBool();
+    }
+
+    // + -: the result has the unit of the left operand
+    template <typename Op>
+    static void applyArithmetic([[maybe_unused]] const BinaryExpression &expr, Value &left, const Value &right) {
+        left.value = Op{}(left.asDouble(), right.asDouble());
+    }
+    template <typename Op>
+    static double calculateArithmetic(const BinaryExpression &expr, Interpreter &interpreter) {
+        double left = expr.leftOperand_->calculateNumber(interpreter);
+        double right = expr.rightOperand_->calculateNumber(interpreter);
+        return Op{}(left, right);
+    }
+
+    // * /: units of the operands are combined
+    template <typename Op>
+    static void applyMultiplicative(const BinaryExpression &expr, Value &left, const Value &right) {
+        left.value = Op{}(left.asDouble(), right.asDouble());
+        if (expr.isExact_) {
+            left.type = expr.type_;
+        } else if constexpr (std::is_same_v<Op, std::multiplies<double>>) {
+            // prefixes of the operands are known only at run time
+            left.type.asUnit().multWithUnit(right.type.asUnit());
+        } else {
+            left.type.asUnit().divWithUnit(right.type.asUnit());
+        }
+    }
+
+    template <typename Op>
+    static void applyComparison([[maybe_unused]] const BinaryExpression &expr, Value &left, const Value &right) {
+        left.value = Op{}(left.asDouble(), right.asDouble());
+        left.type = Type::BOOL;
+    }
+    template <typename Op>
+    static bool calculateComparison(const BinaryExpression &expr, Interpreter &interpreter) {
+        double left = expr.leftOperand_->calculateNumber(interpreter);
+        double right = expr.rightOperand_->calculateNumber(interpreter);
+        return Op{}(left, right);
+    }
+
+    // && ||, == != of bool operands
+    template <typename Op>
+    static void applyLogic([[maybe_unused]] const BinaryExpression &expr, Value &left, const Value &right) {
+        left.value = Op{}(left.asBool(), right.asBool());
+    }
+    template <typename Op>
+    static bool calculateLogic(const BinaryExpression &expr, Interpreter &interpreter) {
+        bool left = expr.leftOperand_->calculateBool(interpreter);
+        bool right = expr.rightOperand_->calculateBool(interpreter);
+        return Op{}(left, right);
+    }
+
+    // indexed by Operator
+    static constexpr void (*dynamicAppliers[])(const BinaryExpression &, Value &, const Value &) = {
+        &applyDynamic<&add>,
+        &applyDynamic<&subtract>,
+        &applyDynamic<&mult>,
+        &applyDynamic<&div>,
+        &applyDynamic<&greaterThan>,
+        &applyDynamic<&greaterThanOrEqual>,
+        &applyDynamic<&lessThan>,
+        &applyDynamic<&lessThanOrEqual>,
+        &applyDynamic<&equalTo>,
+        &applyDynamic<&notEqualTo>,
+        &applyDynamic<&logicAnd>,
+        &applyDynamic<&logicOr>
+    };
+    static_assert(std::size(dynamicAppliers) == static_cast<std::size_t>(Operator::OR) + 1);
+
+    template <typename Op>
+    static void specializeArithmetic(BinaryExpression &expr) {
+        expr.apply_ = &applyArithmetic<Op>;
+        expr.calculateNumber_ = &calculateArithmetic<Op>;
+    }
+    template <typename Op>
+    static void specializeMultiplicative(BinaryExpression &expr) {
+        expr.apply_ = &applyMultiplicative<Op>;
+        if (expr.isExact_) {
+            expr.calculateNumber_ = &calculateArithmetic<Op>;
+        }
+    }
+    template <typename Op>
+    static void specializeComparison(BinaryExpression &expr) {
+        expr.apply_ = &applyComparison<Op>;
+        expr.calculateBool_ = &calculateComparison<Op>;
+    }
+    template <typename Op>
+    static void specializeLogic(BinaryExpression &expr) {
+        expr.apply_ = &applyLogic<Op>;
+        expr.calculateBool_ = &calculateLogic<Op>;
+    }
+    // && ||: the right operand is not calculated when the left one decides the result
+    template <bool decisive>
+    static bool calculateShortCircuit(const BinaryExpression &expr, Interpreter &interpreter) {
+        if (expr.leftOperand_->calculateBool(interpreter) == decisive) {
+            return decisive;
+        }
+        return expr.rightOperand_->calculateBool(interpreter);
+    }
+    template <typename Op, bool decisive>
+    static void specializeShortCircuit(BinaryExpression &expr) {
+        expr.apply_ = &applyLogic<Op>;
+        expr.calculateBool_ = &calculateShortCircuit<decisive>;
+    }
+};
+
+namespace {
+
+// indexed by BinaryExpression::Operator
+constexpr BinaryExpression::Operation operations[] = {
+    &add,
+    &subtract,
+    &mult,
+    &div,
+    &greaterThan,
+    &greaterThanOrEqual,
+    &lessThan,
+    &lessThanOrEqual,
+    &equalTo,
+    &notEqualTo,
+    &logicAnd,
+    &logicOr
+};
+
+static_assert(std::size(operations) == static_cast<std::size_t>(BinaryExpression::Operator::OR) + 1);
+
+} // anonymous namespace
+
+BinaryExpression::BinaryExpression(std::unique_ptr<Expression> leftOperand,
+            Token op,
+            std::unique_ptr<Expression> rightOperand)
+    : leftOperand_(std::move(leftOperand))
+    , rightOperand_(std::move(rightOperand))
+    , operator_(op)
+    , op_(toOperator(std::get<std::string_view>(op.value)))
+    , apply_(Kernels::dynamicAppliers[static_cast<std::size_t>(op_)])
+    , calculateNumber_(&Kernels::calculateNumberDynamic)
+    , calculateBool_(&Kernels::calculateBoolDynamic) {}
+
+BinaryExpression::Operator BinaryExpression::toOperator(std::string_view op) {
+    static constexpr std::pair<std::string_view, Operator> operators[] = {
+        {"+" , Operator::ADD},
+        {"-" , Operator::SUBTRACT},
+        {"*" , Operator::MULT},
+        {"/" , Operator::DIV},
+        {">" , Operator::GREATER_THAN},
+        {">=" , Operator::GREATER_THAN_OR_EQUAL},
+        {"<" , Operator::LESS_THAN},
+        {"<=" , Operator::LESS_THAN_OR_EQUAL},
+        {"==", Operator::EQUAL_TO},
+        {"!=", Operator::NOT_EQUAL_TO},
+        {"&&", Operator::AND},
+        {"||", Operator::OR}
     };
+    for (auto &&[name, kind] : operators) {
+        if (name == op) {
+            return kind;
+        }
+    }
+    ErrorHandler::handleFromParser("Unknown binary operator '" + std::string(op) + "'");
+}
+
+BinaryExpression::Operation BinaryExpression::findOperation(Operator op) {
+    return operations[static_cast<std::size_t>(op)];
+}
+
+void BinaryExpression::setStaticType(Type type, bool isExact, Type::TypeClass operandsType) {
+    type_ = std::move(type);
+    isExact_ = isExact;
+    operandsType_ = operandsType;
+    switch (op_) {
+        case Operator::ADD:
+            Kernels::specializeArithmetic<std::plus<double>>(*this);
+            break;
+        case Operator::SUBTRACT:
+            Kernels::specializeArithmetic<std::minus<double>>(*this);
+            break;
+        case Operator::MULT:
+            Kernels::specializeMultiplicative<std::multiplies<double>>(*this);
+            break;
+        case Operator::DIV:
+            Kernels::specializeMultiplicative<std::divides<double>>(*this);
+            break;
+        case Operator::GREATER_THAN:
+            Kernels::specializeComparison<std::greater<double>>(*this);
+            break;
+        case Operator::GREATER_THAN_OR_EQUAL:
+            Kernels::specializeComparison<std::greater_equal<double>>(*this);
+            break;
+        case Operator::LESS_THAN:
+            Kernels::specializeComparison<std::less<double>>(*this);
+            break;
+        case Operator::LESS_THAN_OR_EQUAL:
+            Kernels::specializeComparison<std::less_equal<double>>(*this);
+            break;
+        case Operator::EQUAL_TO:
+            if (operandsType == Type::BOOL) {
+                Kernels::specializeLogic<std::equal_to<bool>>(*this);
+            } else {
+                Kernels::specializeComparison<std::equal_to<double>>(*this);
+            }
+            break;
+        case Operator::NOT_EQUAL_TO:
+            if (operandsType == Type::BOOL) {
+                Kernels::specializeLogic<std::not_equal_to<bool>>(*this);
+            } else {
+                Kernels::specializeComparison<std::not_equal_to<double>>(*this);
+            }
+            break;
+        case Operator::AND:
+            Kernels::specializeShortCircuit<std::logical_and<bool>, false>(*this);
+            break;
+        case Operator::OR:
+            Kernels::specializeShortCircuit<std::logical_or<bool>, true>(*this);
+            break;
+    }
+}
+
+bool BinaryExpression::isCalculatedRaw(Type::TypeClass typeClass) const {
+    if (typeClass == Type::NUMBER) {
+        return calculateNumber_ != &Kernels::calculateNumberDynamic;
+    }
+    return typeClass == Type::BOOL && calculateBool_ != &Kernels::calculateBoolDynamic;
+}
+
+void BinaryExpression::apply(Value &left, const Value &right) const {
+    apply_(*this, left, right);
+}
+
+Value BinaryExpression::calculate([[maybe_unused]] Interpreter &interpreter) const {
+    if (isExact_) {
+        // the result is created directly with its statically known type
+        if (type_.getTypeClass() == Type::BOOL) {
+            return Value(calculateBool_(*this, interpreter));
+        }
+        return Value(calculateNumber_(*this, interpreter), Type(type_));
+    }
     Value left = leftOperand_->calculate(interpreter);
-    Value right = rightOperand_->calculate(interpreter);
-    operations.at(std::get<std::string>(operator_.value))(left, right);
+    if (isDecidedBy(left)) {
+        return left;
+    }
+    std::optional<Value> temporary;
+    apply_(*this, left, rightOperand_->calculateRef(interpreter, temporary));
     return left;
 }
+
+std::optional<bool> BinaryExpression::getShortCircuitValue() const {
+    switch (op_) {
+        case Operator::AND:
+            return false;
+        case Operator::OR:
+            return true;
+        default:
+            return std::nullopt;
+    }
+}
+
+bool BinaryExpression::isDecidedBy(const Value &left) const {
+    std::optional<bool> decisive = getShortCircuitValue();
+    // operand of other type is reported by the operation
+    return decisive && left.type.getTypeClass() == Type::BOOL && left.asBool() == *decisive;
+}
+
+double BinaryExpression::calculateNumber(Interpreter &interpreter) const {
+    return calculateNumber_(*this, interpreter);
+}
+
+bool BinaryExpression::calculateBool(Interpreter &interpreter) const {
+    return calculateBool_(*this, interpreter);
+}
@@ -5,33 +5,137 @@
 #include "Value.h"
 #include "lexer/Lexer.h"
 #include "error/ErrorHandler.h"
+#include <cstdint>
 #include <string>
-#include <unordered_map>
 #include <memory>
-#include <functional>
+#include <optional>
 #include <sstream>
 
 class BinaryExpression : public Expression {
 public:
+    // applies the operator in place: left = left <op> right
+    using Operation = void(*)(Value &left, const Value &right);
+
+    enum class Operator : std::uint8_t {
+        ADD,
+        SUBTRACT,
+        MULT,
+        DIV,
+        GREATER_THAN,
+        GREATER_THAN_OR_EQUAL,
+        LESS_THAN,
+        LESS_THAN_OR_EQUAL,
+        EQUAL_TO,
+        NOT_EQUAL_TO,
+        AND,
+        OR
+    };
+
     BinaryExpression(std::unique_ptr<Expression> leftOperand,
                Token op,
-               std::unique_ptr<Expression> rightOperand)
-        : leftOperand_(std::move(leftOperand))
-        , rightOperand_(std::move(rightOperand))
-        , operator_(op) {}
+               std::unique_ptr<Expression> rightOperand);
+    
+    Value calculate([[maybe_unused]] Interpreter &interpreter) const override;
+    double calculateNumber(Interpreter &interpreter) const override;
+    bool calculateBool(Interpreter &interpreter) const override;
+    
+    // applies the operator to calculated operands in place: left = left <op> right
+    void apply(Value &left, const Value &right) const;
     
-    Value calculate([[maybe_unused]] Interpreter &interpreter) override;
+    // set by TypeChecker after the operand types were checked; exact type includes
+    // unit prefixes of the result, otherwise only the unit dimension is known
+    // and the prefixes are combined at run time
+    void setStaticType(Type type, bool isExact, Type::TypeClass operandsType);
+
+    // calculateNumber() (NUMBER) or calculateBool() (BOOL) calculates the operands
+    // as raw values too, without constructing Values
+    bool isCalculatedRaw(Type::TypeClass typeClass) const;
+
+    // static type of the result with unit prefixes, nullptr if it is not known exactly
+    const Type* getExactType() const {
+        return isExact_ ? &type_ : nullptr;
+    }
+
+    // type class of the operands, known when the static type is set
+    Type::TypeClass getOperandsType() const {
+        return operandsType_;
+    }
 
     std::string getRPN() const override {
         std::ostringstream os;
-        os << leftOperand_->getRPN() << rightOperand_->getRPN() << std::get<std::string>(operator_.value);
+        os << leftOperand_->getRPN() << rightOperand_->getRPN() << std::get<std::string_view>(operator_.value);
         return os.str();
     }
+    
+    void accept(CodeObjectVisitor &visitor) override {
+        visitor.visit(*this);
+    }
+    
+    Expression& getLeftOperand() const {
+        return *leftOperand_;
+    }
+    
+    Expression& getRightOperand() const {
+        return *rightOperand_;
+    }
+    
+    std::string_view getOperator() const {
+        return std::get<std::string_view>(operator_.value);
+    }
+
+    Operator getOperatorKind() const {
+        return op_;
+    }
+
+    // result of && (false) or || (true) decided by the left operand alone,
+    // without calculating the right one; nullopt for other operators
+    std::optional<bool> getShortCircuitValue() const;
+    
+    static Operation findOperation(Operator op);
+
+    // comparison (> >= < <= == !=) of operands calculated raw
+    template <typename T>
+    static bool compare(Operator op, T left, T right) {
+        switch (op) {
+            case Operator::GREATER_THAN:
+                return left > right;
+            case Operator::GREATER_THAN_OR_EQUAL:
+                return left >= right;
+            case Operator::LESS_THAN:
+                return left < right;
+            case Operator::LESS_THAN_OR_EQUAL:
+                return left <= right;
+            case Operator::EQUAL_TO:
+                return left == right;
+            default:
+                return left != right;
+        }
+    }
+
+private:
+    static Operator toOperator(std::string_view op);
+
+    // the left operand decides the result of && or ||
+    bool isDecidedBy(const Value &left) const;
+
+    // evaluation functions specialized for every operator (and operand types),
+    // so that evaluating the expression takes a single indirect call
+    struct Kernels;
 
 private:
     std::unique_ptr<Expression> leftOperand_;
     std::unique_ptr<Expression> rightOperand_;
     Token operator_;
+    Operator op_;
+    bool isExact_ = false;
+    Type type_;
+    Type::TypeClass operandsType_ = Type::VOID;
+    // until the types are checked, Operation of the operator checks them at run time
+    void (*apply_)(const BinaryExpression &expr, Value &left, const Value &right);
+    double (*calculateNumber_)(const BinaryExpression &expr, Interpreter &interpreter);
+    bool (*calculateBool_)(const BinaryExpression &expr, Interpreter &interpreter);
+
+    friend class ConstantFolder;
 };
 
 #endif // TKOMSIUNITS_CODE_OBJECTS_BINARY_EXPRESSION_H_INCLUDED
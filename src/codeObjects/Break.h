@@ -16,6 +16,10 @@ public:
         static const std::string INSTR_TYPE = "Break";
         return INSTR_TYPE;
     }
+    
+    void accept(CodeObjectVisitor &visitor) override {
+        visitor.visit(*this);
+    }
 };
 
 #endif // TKOMSIUNITS_CODE_OBJECTS_BREAK_H_INCLUDED
@@ -0,0 +1,44 @@
+#ifndef TKOMSIUNITS_CODE_OBJECTS_CODE_OBJECT_VISITOR_H_INCLUDED
+#define TKOMSIUNITS_CODE_OBJECTS_CODE_OBJECT_VISITOR_H_INCLUDED
+
+class Literal;
+class BinaryExpression;
+class VarReference;
+class FuncCall;
+class VarDefOrAssignment;
+class If;
+class While;
+class Return;
+class Break;
+class Continue;
+class InternalPrintInstr;
+
+namespace codeobj {
+class String;
+}
+
+// Visits Instruction and Expression nodes; used by passes that walk the
+// program tree (compilers, analyzers). FuncCall is both an Instruction and
+// an Expression - the visitor tracks in which role it is visited.
+class CodeObjectVisitor {
+public:
+    virtual ~CodeObjectVisitor() = default;
+
+    // expressions
+    virtual void visit(Literal &literal) = 0;
+    virtual void visit(BinaryExpression &expr) = 0;
+    virtual void visit(VarReference &varRef) = 0;
+    virtual void visit(codeobj::String &str) = 0;
+    virtual void visit(FuncCall &funcCall) = 0;
+
+    // instructions
+    virtual void visit(VarDefOrAssignment &instr) = 0;
+    virtual void visit(If &instr) = 0;
+    virtual void visit(While &instr) = 0;
+    virtual void visit(Return &instr) = 0;
+    virtual void visit(Break &instr) = 0;
+    virtual void visit(Continue &instr) = 0;
+    virtual void visit(InternalPrintInstr &instr) = 0;
+};
+
+#endif // TKOMSIUNITS_CODE_OBJECTS_CODE_OBJECT_VISITOR_H_INCLUDED
@@ -0,0 +1,145 @@
+#include "ConstantFolder.h"
+
+#include "Program.h"
+#include "FuncDef.h"
+#include "FuncCall.h"
+#include "BinaryExpression.h"
+#include "Literal.h"
+#include "VarReference.h"
+#include "String.h"
+#include "VarDefOrAssignment.h"
+#include "If.h"
+#include "While.h"
+#include "Return.h"
+#include "InternalPrintInstr.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// lengths of arrays are not checked statically; a mismatch is left to be reported
+// at run time, only if the operation is executed
+bool isFoldable(const Value &left, const Value &right) {
+    return left.type.getTypeClass() != Type::ARRAY || right.type.getTypeClass() != Type::ARRAY
+        || left.asArray().size() == right.asArray().size();
+}
+
+} // anonymous namespace
+
+void ConstantFolder::fold(Program &program) {
+    ConstantFolder folder;
+    folder.foldBlock(program.getInstructions());
+    for (auto &&[_, funcDef] : program.getFuncDefs()) {
+        (void)_;
+        folder.foldBlock(funcDef->getBody());
+    }
+}
+
+void ConstantFolder::foldBlock(const InstructionBlock &block) {
+    for (auto &&instr : block.getInstructions()) {
+        instr->accept(*this);
+    }
+}
+
+const Value* ConstantFolder::fold(std::unique_ptr<Expression> &expr) {
+    expr->accept(*this);
+    if (replacement_) {
+        expr = std::move(replacement_);
+    }
+    return std::exchange(constant_, nullptr);
+}
+
+void ConstantFolder::replaceWith(Value &&value) {
+    auto replacement = std::make_unique<Literal>(std::move(value));
+    constant_ = &replacement->getValue();
+    replacement_ = std::move(replacement);
+}
+
+void ConstantFolder::visit(Literal &literal) {
+    constant_ = &literal.getValue();
+}
+
+void ConstantFolder::visit(BinaryExpression &expr) {
+    const Value *left = fold(expr.leftOperand_);
+    if (left && expr.isDecidedBy(*left)) {
+        replaceWith(Value(*left));
+        return;
+    }
+    const Value *right = fold(expr.rightOperand_);
+    if (!left || !right || !isFoldable(*left, *right)) {
+        return;
+    }
+    Value result(*left);
+    expr.apply(result, *right);
+    replaceWith(std::move(result));
+}
+
+void ConstantFolder::visit([[maybe_unused]] VarReference &varRef) {
+    constant_ = nullptr;
+}
+
+void ConstantFolder::visit(codeobj::String &str) {
+    // adjacent constant parts are joined into one
+    std::vector<std::unique_ptr<Expression>> parts;
+    std::string text;
+    bool hasText = false;
+    for (auto &&part : str.parts_) {
+        if (const Value *constant = fold(part)) {
+            text += constant->toString();
+            hasText = true;
+            continue;
+        }
+        if (hasText) {
+            parts.push_back(std::make_unique<Literal>(Value(std::exchange(text, std::string()))));
+            hasText = false;
+        }
+        parts.push_back(std::move(part));
+    }
+    if (parts.empty()) {
+        replaceWith(Value(std::move(text)));
+        return;
+    }
+    if (hasText) {
+        parts.push_back(std::make_unique<Literal>(Value(std::move(text))));
+    }
+    str.parts_ = std::move(parts);
+}
+
+void ConstantFolder::visit(FuncCall &funcCall) {
+    // functions may have side effects, only their arguments are folded
+    for (auto &&arg : funcCall.args_) {
+        fold(arg);
+    }
+}
+
+void ConstantFolder::visit(VarDefOrAssignment &instr) {
+    fold(instr.expr_);
+}
+
+void ConstantFolder::visit(If &instr) {
+    if (instr.cond_) {
+        fold(instr.cond_);
+    }
+    foldBlock(instr.getPositiveBlock());
+    if (instr.getElseIf()) {
+        instr.getElseIf()->accept(*this);
+    }
+}
+
+void ConstantFolder::visit(While &instr) {
+    fold(instr.cond_);
+    foldBlock(instr.getBody());
+}
+
+void ConstantFolder::visit(Return &instr) {
+    if (instr.expr_) {
+        fold(instr.expr_);
+    }
+}
+
+void ConstantFolder::visit([[maybe_unused]] Break &instr) {}
+
+void ConstantFolder::visit([[maybe_unused]] Continue &instr) {}
+
+void ConstantFolder::visit([[maybe_unused]] InternalPrintInstr &instr) {}
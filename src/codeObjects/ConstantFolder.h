@@ -0,0 +1,47 @@
+#ifndef TKOMSIUNITS_CODE_OBJECTS_CONSTANT_FOLDER_H_INCLUDED
+#define TKOMSIUNITS_CODE_OBJECTS_CONSTANT_FOLDER_H_INCLUDED
+
+#include "CodeObjectVisitor.h"
+#include "Expression.h"
+#include <memory>
+
+class Program;
+class InstructionBlock;
+
+// Replaces constant subexpressions of Program checked by TypeChecker (operations
+// on literals, including the unit algebra, and string literals without interpolated
+// variables) with single Literals calculated before the program is executed.
+// Operands of && and || are folded also when the left constant decides the result.
+// Only operations that cannot fail are folded: TypeChecker reports errors of units
+// and types of constant operations, and operations on constant arrays are folded only
+// for arrays of the same length - others are left to be reported at run time.
+class ConstantFolder : private CodeObjectVisitor {
+public:
+    static void fold(Program &program);
+
+private:
+    void foldBlock(const InstructionBlock &block);
+    // folds the expression in place; returns its value if the expression is constant
+    const Value* fold(std::unique_ptr<Expression> &expr);
+    void replaceWith(Value &&value);
+
+    void visit(Literal &literal) override;
+    void visit(BinaryExpression &expr) override;
+    void visit(VarReference &varRef) override;
+    void visit(codeobj::String &str) override;
+    void visit(FuncCall &funcCall) override;
+    void visit(VarDefOrAssignment &instr) override;
+    void visit(If &instr) override;
+    void visit(While &instr) override;
+    void visit(Return &instr) override;
+    void visit(Break &instr) override;
+    void visit(Continue &instr) override;
+    void visit(InternalPrintInstr &instr) override;
+
+private:
+    // result of the visited expression
+    const Value *constant_ = nullptr;
+    std::unique_ptr<Expression> replacement_;
+};
+
+#endif // TKOMSIUNITS_CODE_OBJECTS_CONSTANT_FOLDER_H_INCLUDED
@@ -16,6 +16,10 @@ public:
         static const std::string INSTR_TYPE = "Continue";
         return INSTR_TYPE;
     }
+    
+    void accept(CodeObjectVisitor &visitor) override {
+        visitor.visit(*this);
+    }
 };
 
 #endif // TKOMSIUNITS_CODE_OBJECTS_CONTINUE_H_INCLUDED
@@ -0,0 +1,15 @@
+#include "Expression.h"
+
+#include "Value.h"
+
+double Expression::calculateNumber(Interpreter &interpreter) const {
+    return calculate(interpreter).asDouble();
+}
+
+bool Expression::calculateBool(Interpreter &interpreter) const {
+    return calculate(interpreter).asBool();
+}
+
+const Value& Expression::calculateRef(Interpreter &interpreter, std::optional<Value> &temporary) const {
+    return temporary.emplace(calculate(interpreter));
+}
@@ -1,20 +1,31 @@
 #ifndef TKOMSIUNITS_CODE_OBJECTS_EXPRESSION_H_INCLUDED
 #define TKOMSIUNITS_CODE_OBJECTS_EXPRESSION_H_INCLUDED
 
+#include "CodeObjectVisitor.h"
 #include "Instruction.h"
+#include "NodeArena.h"
 #include "lexer/Lexer.h"
+#include <optional>
 #include <string>
 
-class Value;
+struct Value;
 class Interpreter;
 
-class Expression {
+class Expression : public ArenaAllocated {
 public:
     Expression() {}
     virtual ~Expression() {}
     
-    virtual Value calculate([[maybe_unused]] Interpreter &interpreter) = 0;
+    virtual Value calculate([[maybe_unused]] Interpreter &interpreter) const = 0;
+    // calculate the raw value of an expression whose static type is known to be
+    // a number (or bool), without constructing the Value with its unit
+    virtual double calculateNumber(Interpreter &interpreter) const;
+    virtual bool calculateBool(Interpreter &interpreter) const;
+    // value of the expression without copying values stored elsewhere (literals,
+    // variables); a calculated value is stored in temporary and referred from there
+    virtual const Value& calculateRef(Interpreter &interpreter, std::optional<Value> &temporary) const;
     virtual std::string getRPN() const = 0;
+    virtual void accept(CodeObjectVisitor &visitor) = 0;
 };
 
 #endif // TKOMSIUNITS_CODE_OBJECTS_EXPRESSION_H_INCLUDED
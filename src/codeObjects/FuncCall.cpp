@@ -12,14 +12,15 @@ std::string FuncCall::getRPN() const {
     return output;
 }
 
-std::optional<Value> FuncCall::doCall(Interpreter &interpreter) const {
-    const FuncDef *funcDef = interpreter.getFuncDef(name_);
-
+std::vector<Value> FuncCall::calculateArgs(Interpreter &interpreter) const {
     std::vector<Value> argVals;
     argVals.reserve(args_.size());
     for (auto &&arg : args_) {
         argVals.push_back(arg->calculate(interpreter));
     }
-    
-    return funcDef->call(interpreter, std::move(argVals));
+    return argVals;
+}
+
+std::optional<Value> FuncCall::doCall(Interpreter &interpreter) const {
+    return funcDef_->call(interpreter, calculateArgs(interpreter));
 }
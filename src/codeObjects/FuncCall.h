@@ -10,6 +10,10 @@
 
 class FuncCall : public Instruction, public Expression {
 public:
+    // both bases are ArenaAllocated
+    using Instruction::operator new;
+    using Instruction::operator delete;
+
     FuncCall(
             const std::string &name,
             std::vector<std::unique_ptr<Expression>> &&args
@@ -22,12 +26,17 @@ public:
         return InstrResult::NORMAL;
     }
     
-    Value calculate([[maybe_unused]] Interpreter &interpreter) override {
+    // the call replaces the function call in which it is returned
+    void requestTailCall(Interpreter &interpreter) const {
+        interpreter.setTailCall(*funcDef_, calculateArgs(interpreter));
+    }
+    
+    Value calculate([[maybe_unused]] Interpreter &interpreter) const override {
         std::optional<Value> retVal = doCall(interpreter);
         if (!retVal) {
             ErrorHandler::handleTypeMismatch("Function call as expression cannot evaluate to type void");
         }
-        return retVal.value();
+        return std::move(*retVal);
     }
 
     const std::string& getInstrType() const {
@@ -39,14 +48,35 @@ public:
         return name_;
     }
     
+    const std::vector<std::unique_ptr<Expression>>& getArgs() const {
+        return args_;
+    }
+    
+    // called function, bound by Resolver
+    const FuncDef* getFuncDef() const {
+        return funcDef_;
+    }
+    
+    void setFuncDef(const FuncDef &funcDef) {
+        funcDef_ = &funcDef;
+    }
+    
+    void accept(CodeObjectVisitor &visitor) override {
+        visitor.visit(*this);
+    }
+    
     std::string getRPN() const override;
 
 private:
+    std::vector<Value> calculateArgs(Interpreter &interpreter) const;
     std::optional<Value> doCall(Interpreter &interpreter) const;
 
 private:
     const std::string name_;
-    const std::vector<std::unique_ptr<Expression>> args_;
+    std::vector<std::unique_ptr<Expression>> args_;
+    const FuncDef *funcDef_ = nullptr;
+
+    friend class ConstantFolder;
 };
 
 #endif // TKOMSIUNITS_CODE_OBJECTS_FUNC_CALL_H_INCLUDED
@@ -1,5 +1,7 @@
 #include "FuncDef.h"
 #include "Interpreter.h"
+#include "NativeStack.h"
+#include <string>
 
 FuncDef::FuncDef(
         const std::string &name,
@@ -10,7 +12,8 @@ FuncDef::FuncDef(
     : name_(name)
     , params_(std::move(params))
     , returnType_(std::move(returnType))
-    , body_(std::move(body)) {
+    , body_(std::move(body))
+    , frameSize_(params_.size()) {
     std::set<std::string_view> paramNames;
     for (auto &&param : params_) {
         auto result = paramNames.insert(param.getName());
@@ -23,22 +26,68 @@ FuncDef::FuncDef(
 }
 
 std::optional<Value> FuncDef::call(Interpreter &interpreter, std::vector<Value> &&args) const {
+    if (!isPure_ || !interpreter.isMemoizing()) {
+        return execute(interpreter, std::move(args));
+    }
+    if (const std::optional<Value> *memoized = interpreter.findMemoized(*this, args)) {
+        return *memoized;
+    }
+    std::vector<Value> memoizedArgs = args;
+    std::optional<Value> result = execute(interpreter, std::move(args));
+    interpreter.memoize(*this, std::move(memoizedArgs), result);
+    return result;
+}
+
+std::optional<Value> FuncDef::execute(Interpreter &interpreter, std::vector<Value> &&args) const {
+    enter(interpreter, std::move(args));
+    const FuncDef *funcDef = this;
+    InstrResult result = body_->execute(interpreter);
+    // tail calls run in a loop, so tail recursion uses neither native stack nor new contexts;
+    // types of values returned by tail calls are checked statically against this function
+    while (std::optional<Interpreter::TailCall> tailCall = interpreter.consumeTailCall()) {
+        funcDef = tailCall->funcDef;
+        funcDef->reenter(interpreter, std::move(tailCall->args));
+        result = funcDef->body_->execute(interpreter);
+    }
+    return funcDef->leave(interpreter, result);
+}
+
+void FuncDef::enter(Interpreter &interpreter, std::vector<Value> &&args) const {
     if (args.size() != params_.size()) {
         ErrorHandler::handleFunctionCallError("Argument and parameter count mismatch for function '" + name_ + "'");
     }
-    interpreter.newFuncCallContext();
-    if (!std::equal(args.cbegin(), args.cend(), params_.cbegin(), [&interpreter](const Value &arg, const Variable &param) {
-            if (arg.type == param.getType()) {
-                interpreter.addVariable(param.getName(), std::move(arg));
-                return true;
-            }
-            return false;
-        })) {
+    if (interpreter.getCallDepth() >= interpreter.getMaxCallDepth()) {
+        ErrorHandler::handleFunctionCallError(
+            "Maximum call depth of " + std::to_string(interpreter.getMaxCallDepth()) + " exceeded in call of function '" + name_ + "'"
+        );
+    }
+    if (NativeStack::isExhausted()) {
+        ErrorHandler::handleFunctionCallError("Native stack exhausted in call of function '" + name_ + "'");
+    }
+    interpreter.newFuncCallContext(frameSize_);
+    bindArgs(interpreter, std::move(args));
+}
+
+void FuncDef::reenter(Interpreter &interpreter, std::vector<Value> &&args) const {
+    if (args.size() != params_.size()) {
         interpreter.deleteFuncCallContext();
-        ErrorHandler::handleTypeMismatch("Argument and parameter types mismatch for function '" + name_ + "'");
+        ErrorHandler::handleFunctionCallError("Argument and parameter count mismatch for function '" + name_ + "'");
     }
+    interpreter.resetFuncCallContext(frameSize_);
+    bindArgs(interpreter, std::move(args));
+}
 
-    InstrResult result = body_->execute(interpreter);
+void FuncDef::bindArgs(Interpreter &interpreter, std::vector<Value> &&args) const {
+    for (std::size_t i = 0; i < args.size(); ++i) {
+        if (args[i].type != params_[i].getType()) {
+            interpreter.deleteFuncCallContext();
+            ErrorHandler::handleTypeMismatch("Argument and parameter types mismatch for function '" + name_ + "'");
+        }
+        interpreter.getLocalSlot(static_cast<std::uint32_t>(i)) = std::move(args[i]);
+    }
+}
+
+std::optional<Value> FuncDef::leave(Interpreter &interpreter, InstrResult result) const {
     std::optional<Value> retVal = interpreter.consumeReturnValue();
 
     switch (result) {
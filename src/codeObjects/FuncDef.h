@@ -2,10 +2,12 @@
 #define TKOMSIUNITS_CODE_OBJECTS_FUNC_DEF_H_INCLUDED
 
 #include "InstructionBlock.h"
+#include "NodeArena.h"
 #include "Variable.h"
 #include "Type.h"
 #include "Value.h"
 #include "error/ErrorHandler.h"
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <set>
@@ -13,7 +15,7 @@
 #include <functional>
 #include <string_view>
 
-class FuncDef {
+class FuncDef : public ArenaAllocated {
 public:
     FuncDef(
             const std::string &name,
@@ -22,8 +24,17 @@ public:
             std::unique_ptr<InstructionBlock> &&body
         );
     
+    // result of a pure function is memoized if the interpreter memoizes calls
     std::optional<Value> call(Interpreter &interpreter, std::vector<Value> &&args) const;
     
+    // creates function call context with parameters bound to args
+    void enter(Interpreter &interpreter, std::vector<Value> &&args) const;
+    // reuses the function call context of the function that made the tail call to this function
+    void reenter(Interpreter &interpreter, std::vector<Value> &&args) const;
+    // checks body execution result and returned value against the return type,
+    // deletes function call context created by enter()
+    std::optional<Value> leave(Interpreter &interpreter, InstrResult result) const;
+    
     std::string toString() const;
     
     const std::string& getName() const {
@@ -34,11 +45,50 @@ public:
         return returnType_;
     }
     
+    const std::vector<Variable>& getParams() const {
+        return params_;
+    }
+    
+    InstructionBlock& getBody() const {
+        return *body_;
+    }
+    
+    // number of variable slots needed by a call, parameters occupy the first slots
+    std::size_t getFrameSize() const {
+        return frameSize_;
+    }
+    
+    // VarSlot::binding of the parameter
+    std::uint32_t getParamBinding(std::size_t index) const {
+        return firstParamBinding_ + static_cast<std::uint32_t>(index);
+    }
+    
+    void setFrameLayout(std::size_t frameSize, std::uint32_t firstParamBinding) {
+        frameSize_ = frameSize;
+        firstParamBinding_ = firstParamBinding;
+    }
+    
+    // result depends only on the arguments, set by PurityAnalyzer
+    bool isPure() const {
+        return isPure_;
+    }
+    
+    void setPure(bool isPure) {
+        isPure_ = isPure;
+    }
+    
+private:
+    std::optional<Value> execute(Interpreter &interpreter, std::vector<Value> &&args) const;
+    void bindArgs(Interpreter &interpreter, std::vector<Value> &&args) const;
+
 private:
     const std::string name_;
     std::vector<Variable> params_;
     Type returnType_;
     std::unique_ptr<InstructionBlock> body_;
+    std::size_t frameSize_;
+    std::uint32_t firstParamBinding_ = 0;
+    bool isPure_ = false;
 };
 
 #endif // TKOMSIUNITS_CODE_OBJECTS_FUNC_DEF_H_INCLUDED
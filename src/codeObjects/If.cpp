@@ -4,11 +4,8 @@
 
 InstrResult If::execute([[maybe_unused]] Interpreter &interpreter) const {
     if (cond_) {
-        Value condResult = cond_->calculate(interpreter);
-        if (condResult.type.getTypeClass() != Type::BOOL) {
-            ErrorHandler::handleTypeMismatch("Expression used as If condition must result in bool value");
-        }
-        if (condResult.asBool()) {
+        // condition type is checked by TypeChecker
+        if (cond_->calculateBool(interpreter)) {
             // True
             return positiveBlock_->execute(interpreter);
         } else if (elseIf_) {
@@ -32,10 +32,29 @@ public:
         return INSTR_TYPE;
     }
     
+    void accept(CodeObjectVisitor &visitor) override {
+        visitor.visit(*this);
+    }
+    
+    // nullptr for Else
+    Expression* getCond() const {
+        return cond_.get();
+    }
+    
+    InstructionBlock& getPositiveBlock() const {
+        return *positiveBlock_;
+    }
+    
+    If* getElseIf() const {
+        return elseIf_.get();
+    }
+    
 private:
     std::unique_ptr<Expression> cond_;
     std::unique_ptr<InstructionBlock> positiveBlock_;
     std::unique_ptr<If> elseIf_;
+
+    friend class ConstantFolder;
 };
 
 #endif // TKOMSIUNITS_CODE_OBJECTS_IF_H_INCLUDED
@@ -1,17 +1,20 @@
 #ifndef TKOMSIUNITS_CODE_OBJECTS_INSTRUCTION_H_INCLUDED
 #define TKOMSIUNITS_CODE_OBJECTS_INSTRUCTION_H_INCLUDED
 
+#include "CodeObjectVisitor.h"
 #include "InstrResult.h"
+#include "NodeArena.h"
 #include <string>
 
 class Interpreter;
 
-class Instruction {
+class Instruction : public ArenaAllocated {
 public:
     virtual ~Instruction() = 0;
     
     virtual InstrResult execute(Interpreter &interpreter) const = 0;
     virtual const std::string& getInstrType() const = 0;
+    virtual void accept(CodeObjectVisitor &visitor) = 0;
 };
 
 #endif // TKOMSIUNITS_CODE_OBJECTS_INSTRUCTION_H_INCLUDED
@@ -2,13 +2,12 @@
 #include "Interpreter.h"
 
 InstrResult InstructionBlock::execute(Interpreter &interpreter) const {
+    // variables of the block are kept in frame slots assigned by Resolver
     InstrResult result = InstrResult::NORMAL;
-    interpreter.newScope();
     auto instrIter = instructions_.cbegin();
 
     for (; instrIter != instructions_.cend() && result == InstrResult::NORMAL; ++instrIter) {
         result = (*instrIter)->execute(interpreter);
     }
-    interpreter.deleteScope();
     return result;
 }
@@ -2,19 +2,24 @@
 #define TKOMSIUNITS_CODE_OBJECTS_INSTRUCTION_BLOCK_H_INCLUDED
 
 #include "Instruction.h"
+#include "NodeArena.h"
 #include <memory>
 #include <string>
 #include <vector>
 
 class Interpreter;
 
-class InstructionBlock {
+class InstructionBlock : public ArenaAllocated {
 public:
     InstructionBlock(std::vector<std::unique_ptr<Instruction>> &&instructions)
         : instructions_(std::move(instructions)) {}
     
     InstrResult execute(Interpreter &interpreter) const;
     
+    const std::vector<std::unique_ptr<Instruction>>& getInstructions() const {
+        return instructions_;
+    }
+    
 private:
     const std::vector<std::unique_ptr<Instruction>> instructions_;
 };
@@ -4,7 +4,7 @@
 #include "Value.h"
 
 InstrResult InternalPrintInstr::execute([[maybe_unused]] Interpreter &interpreter) const {
-    Value stringValue = interpreter.getVariableOrError(stringVariableName_);
+    const Value &stringValue = interpreter.getVariable(slot_, stringVariableName_);
     interpreter.printLineToStdout(stringValue.asString());
     return InstrResult::NORMAL;
 }
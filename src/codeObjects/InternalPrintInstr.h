@@ -2,6 +2,8 @@
 #define TKOMSIUNITS_CODE_OBJECTS_INTERNAL_PRINT_INSTR_H_INCLUDED
 
 #include "Instruction.h"
+#include "VarSlot.h"
+#include <string>
 
 class InternalPrintInstr : public Instruction {
 public:
@@ -14,9 +16,26 @@ public:
         static const std::string INSTR_TYPE = "InternalPrintInstr";
         return INSTR_TYPE;
     }
+    
+    void accept(CodeObjectVisitor &visitor) override {
+        visitor.visit(*this);
+    }
+    
+    const std::string& getStringVariableName() const {
+        return stringVariableName_;
+    }
+    
+    const VarSlot& getSlot() const {
+        return slot_;
+    }
+    
+    void setSlot(VarSlot slot) {
+        slot_ = slot;
+    }
 
 private:
     std::string stringVariableName_;
+    VarSlot slot_;
 };
 
 #endif // TKOMSIUNITS_CODE_OBJECTS_INTERNAL_PRINT_INSTR_H_INCLUDED
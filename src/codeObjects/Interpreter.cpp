@@ -1,72 +1,135 @@
 #include "Interpreter.h"
 
 #include "Program.h"
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+void Interpreter::reset(Sink &stdout, const Program &programToExecute) {
+    stdout_ = &stdout;
+    ownedStdout_.reset();
+    if (program_ != &programToExecute) {
+        program_ = &programToExecute;
+        memoTables_.clear();
+    } else {
+        for (auto &&[_, table] : memoTables_) {
+            (void)_;
+            table.clear();
+        }
+    }
+    inputValues_.clear();
+    returnValue_.reset();
+    tailCall_.reset();
+}
 
 int Interpreter::executeProgram() {
-    newFuncCallContext();
+    return executeProgram([this]() { return program_->execute(*this); });
+}
+
+int Interpreter::executeProgram(const std::function<int()> &engine) {
+    globals_.assign(program_->getGlobalNames().size(), std::nullopt);
+    for (std::size_t i = 0; i < inputValues_.size() && i < program_->getInputs().size(); ++i) {
+        globals_[i] = inputValues_[i];
+    }
+    newFuncCallContext(program_->getMainFrameSize());
     int exitStatus = 0;
     try {
-        exitStatus = program_.execute(*this);
+        exitStatus = engine();
+        stdout_->flush();
     } catch (const std::exception &e) {
-        deleteFuncCallContext();
-        std::cerr << e.what() << std::endl;
+        fccStack_ = {};
+        tailCall_.reset();
+        // output printed before the error precedes the error message
+        stdout_->flush();
+        *errorStream_ << e.what() << std::endl;
         return 1; // failure
     }
     deleteFuncCallContext();
     return exitStatus;
 }
 
-void Interpreter::addVariable(const std::string &name, Value value) {
-    assert(!fccStack_.empty());
-    if (!fccStack_.top().addVariable(name, std::move(value))) {
-        ErrorHandler::handleVariableAlreadyDefined("Variable '" + name + "' already defined in current scope");
-    }
+void Interpreter::reportNotDefined(const std::string &name) {
+    ErrorHandler::handleVariableNotDefined("Refernce to not-defined variable '" + name + "'");
 }
 
-void Interpreter::assignVariable(const std::string &name, Value value) {
-    assert(!fccStack_.empty());
-    if (fccStack_.top().assignVariable(name, std::move(value))) {
-        return;
+void Interpreter::reportNotResolved() {
+    ErrorHandler::handleFromInterpreter("Variable slot was not resolved before referencing it");
+}
+
+const std::optional<Value>* Interpreter::findMemoized(const FuncDef &funcDef, const std::vector<Value> &args) const {
+    auto table = memoTables_.find(&funcDef);
+    if (table == memoTables_.end()) {
+        return nullptr;
     }
-    if (mainContext_ != &fccStack_.top()) {
-        // search in global scope
-        if (auto iter = getGlobalScope().find(name); iter != getGlobalScope().end()) {
-            iter->second = std::move(value);
-            return;
-        }
+    auto result = table->second.find(args);
+    return result != table->second.end() ? &result->second : nullptr;
+}
+
+void Interpreter::memoize(const FuncDef &funcDef, std::vector<Value> &&args, std::optional<Value> result) {
+    MemoTable &table = memoTables_[&funcDef];
+    if (table.size() >= MAX_MEMOIZED_CALLS) {
+        // bounds memory of long runs calling with ever new arguments
+        table.clear();
     }
-    ErrorHandler::handleVariableNotDefined("Refernce to not-defined variable '" + name + "'");
+    table.insert_or_assign(std::move(args), std::move(result));
 }
-    
-std::optional<Value> Interpreter::getVariable(const std::string &name) const {
-    assert(!fccStack_.empty());
-    std::optional<Value> val = fccStack_.top().getVariable(name);
-    if (val) {
-        return val;
+
+namespace {
+
+// numbers are compared bit by bit, so that NaN arguments are found in the table
+// (and -0 is not taken for 0)
+bool isSameNumber(double left, double right) {
+    return std::memcmp(&left, &right, sizeof(double)) == 0;
+}
+
+bool isSameValue(const Value &left, const Value &right) {
+    if (left.value.index() != right.value.index()) {
+        return false;
     }
-    if (mainContext_ != &fccStack_.top()) {
-        // search in global scope
-        if (auto iter = getGlobalScope().find(name); iter != getGlobalScope().end()) {
-            return iter->second;
-        }
+    if (const double *number = std::get_if<double>(&left.value)) {
+        return isSameNumber(*number, std::get<double>(right.value));
     }
-    return std::nullopt;
-}
-    
-Value Interpreter::getVariableOrError(const std::string &name) const {
-    std::optional<Value> val = getVariable(name);
-    if (!val) {
-        ErrorHandler::handleVariableNotDefined("Refernce to not-defined variable '" + name + "'");
+    if (const auto *array = std::get_if<std::vector<double>>(&left.value)) {
+        const auto &rightArray = std::get<std::vector<double>>(right.value);
+        return array->size() == rightArray.size()
+            && (array->empty() || std::memcmp(array->data(), rightArray.data(), array->size() * sizeof(double)) == 0);
     }
-    return val.value();
+    return left.value == right.value;
+}
+
+} // anonymous namespace
+
+std::size_t Interpreter::ArgsHash::operator()(const std::vector<Value> &args) const {
+    // types are compared only for values with equal hashes
+    std::size_t hash = args.size();
+    for (auto &&arg : args) {
+        hash = hash * 31 + arg.value.index();
+        std::visit([&hash](auto &&value) {
+                using ValueType = std::decay_t<decltype(value)>;
+                if constexpr (std::is_same_v<ValueType, std::vector<double>>) {
+                    for (double element : value) {
+                        hash = hash * 31 + std::hash<double>{}(element);
+                    }
+                } else {
+                    hash = hash * 31 + std::hash<ValueType>{}(value);
+                }
+            }, arg.value);
+    }
+    return hash;
 }
 
-const FuncDef* Interpreter::getFuncDef(const std::string &name) const {
-    auto funcDef = program_.getFuncDef(name);
-    if (!funcDef) {
-        ErrorHandler::handleFunctionNotDefined(name);
+bool Interpreter::ArgsEqual::operator()(const std::vector<Value> &left, const std::vector<Value> &right) const {
+    if (left.size() != right.size()) {
+        return false;
     }
-    return funcDef;
+    for (std::size_t i = 0; i < left.size(); ++i) {
+        if (!isSameValue(left[i], right[i]) || !left[i].type.isIdenticalTo(right[i].type)) {
+            return false;
+        }
+    }
+    return true;
 }
 
 void Interpreter::setReturnValue(Value value) {
@@ -79,81 +142,27 @@ std::optional<Value> Interpreter::consumeReturnValue() {
     return temp;
 }
 
-void Interpreter::newFuncCallContext() {
-    fccStack_.emplace();
-    if (!mainContext_) {
-        mainContext_ = &fccStack_.top();
-    } else {
-        // create scope for function parameters
-        fccStack_.top().newScope();
-    }
+void Interpreter::setTailCall(const FuncDef &funcDef, std::vector<Value> &&args) {
+    tailCall_.emplace(TailCall{ &funcDef, std::move(args) });
 }
 
-void Interpreter::deleteFuncCallContext() {
-    assert(!fccStack_.empty());
-    fccStack_.pop();
+std::optional<Interpreter::TailCall> Interpreter::consumeTailCall() {
+    auto temp = std::move(tailCall_);
+    tailCall_.reset();
+    return temp;
 }
 
-void Interpreter::newScope() {
-    assert(!fccStack_.empty());
-    fccStack_.top().newScope();
+void Interpreter::newFuncCallContext(std::size_t frameSize) {
+    fccStack_.emplace(frameSize);
 }
 
-void Interpreter::deleteScope() {
+void Interpreter::resetFuncCallContext(std::size_t frameSize) {
     assert(!fccStack_.empty());
-    fccStack_.top().deleteScope();
-}
-
-const FuncCallContext::Scope& Interpreter::getGlobalScope() const {
-    if (!mainContext_ || mainContext_->scopeChain.empty()) {
-        ErrorHandler::handleFromInterpreter("Global scope was not created before referencing it");
-    }
-    return mainContext_->scopeChain.front();
+    // keeps the allocated frame
+    fccStack_.top().frame.assign(frameSize, std::nullopt);
 }
 
-FuncCallContext::Scope& Interpreter::getGlobalScope() {
-    return const_cast<FuncCallContext::Scope &>(std::as_const(*this).getGlobalScope());
-}
-
-std::ostream& Interpreter::getStdout() {
-    return stdout_;
-}
-
-void Interpreter::printLineToStdout(const std::string &text) {
-    stdout_ << text << std::endl;
-}
-
-void FuncCallContext::newScope() {
-    scopeChain.emplace_back();
-}
-
-void FuncCallContext::deleteScope() {
-    assert(!scopeChain.empty());
-    scopeChain.pop_back();
-}
-
-std::optional<Value> FuncCallContext::getVariable(const std::string &name) const {
-    auto riter = scopeChain.crbegin();
-    for (; riter != scopeChain.crend(); ++riter) {
-        if (auto varIt = riter->find(name); varIt != riter->end()) {
-            return varIt->second;
-        }
-    }
-    return std::nullopt;
-}
-
-bool FuncCallContext::addVariable(const std::string &name, Value value) {
-    auto result = scopeChain.back().insert({ name, std::move(value) });
-    return result.second;
-}
-
-bool FuncCallContext::assignVariable(const std::string &name, Value value) {
-    auto riter = scopeChain.rbegin();
-    for (; riter != scopeChain.rend(); ++riter) {
-        if (auto varIt = riter->find(name); varIt != riter->end()) {
-            varIt->second = std::move(value);
-            return true;
-        }
-    }
-    return false;
+void Interpreter::deleteFuncCallContext() {
+    assert(!fccStack_.empty());
+    fccStack_.pop();
 }
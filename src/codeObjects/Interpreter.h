@@ -2,9 +2,15 @@
 #define TKOMSIUNITS_CODE_OBJECTS_INTERPRETER_H_INCLUDED
 
 #include "Value.h"
+#include "VarSlot.h"
 #include "error/ErrorHandler.h"
+#include "sink/Sink.h"
+#include "sink/StreamSink.h"
 #include <cassert>
+#include <cstdint>
+#include <functional>
 #include <iostream>
+#include <memory>
 #include <optional>
 #include <stack>
 #include <unordered_map>
@@ -14,58 +20,181 @@ class Program;
 class FuncDef;
 
 struct FuncCallContext {
-    using Scope = std::unordered_map<std::string, Value>;
+    using Frame = std::vector<std::optional<Value>>;
 
-    void newScope();
-    void deleteScope();
-    
-    std::optional<Value> getVariable(const std::string &name) const;
-    bool addVariable(const std::string &name, Value value);
-    bool assignVariable(const std::string &name, Value value);
+    FuncCallContext(std::size_t frameSize)
+        : frame(frameSize) {}
 
 public:
-    std::vector<Scope> scopeChain;
+    // variables of the call indexed by slots assigned by Resolver;
+    // blocks reuse slots instead of creating new scopes
+    Frame frame;
 };
 
 class Interpreter {
 public:
-    Interpreter(std::ostream &stdout, Program &programToExecute)
-        : stdout_(stdout)
-        , program_(programToExecute) {}
+    // call of a function returned from another function, made in the function call
+    // context of the returning function
+    struct TailCall {
+        const FuncDef *funcDef;
+        std::vector<Value> args;
+    };
+
+    // bounds memory of the call frames; engines recursing on the native stack
+    // report its exhaustion (NativeStack) usually before reaching the limit
+    static constexpr std::size_t DEFAULT_MAX_CALL_DEPTH = 10000;
+    // memoized calls of one function kept in a run; the table is cleared when it is full
+    static constexpr std::size_t MAX_MEMOIZED_CALLS = 1 << 16;
+
+public:
+    // program output is buffered by the sink and flushed when the program finishes
+    // or before an error is reported to stderr
+    Interpreter(Sink &stdout, const Program &programToExecute)
+        : stdout_(&stdout)
+        , program_(&programToExecute) {}
+    Interpreter(std::ostream &stdout, const Program &programToExecute)
+        : ownedStdout_(std::make_unique<StreamSink>(stdout))
+        , stdout_(ownedStdout_.get())
+        , program_(&programToExecute) {}
+    
+    // prepares the interpreter for the next execution as if it was constructed again,
+    // keeping its allocated memory (frames of global variables, memoization tables);
+    // settings (error stream, memoization, maximum call depth) are kept
+    void reset(Sink &stdout, const Program &programToExecute);
     
     int executeProgram();
+    // executes the program with another execution engine (e.g. bytecode VM);
+    // engine is run inside the main function call context and returns exit status
+    int executeProgram(const std::function<int()> &engine);
+    
+    const Program& getProgram() const {
+        return *program_;
+    }
+    
+    // runtime errors are reported to the stream, std::cerr by default
+    void setErrorStream(std::ostream &errorStream) {
+        errorStream_ = &errorStream;
+    }
+    
+    // values of the inputs of the program (Program::getInputs()), stored in their global
+    // slots whenever the program is executed; inputs without values are not defined
+    void setInputValues(std::vector<Value> &&values) {
+        inputValues_ = std::move(values);
+    }
+    
+    // reports reference to not-defined variable if the slot is empty
+    const Value& getVariable(const VarSlot &slot, const std::string &name) {
+        if (slot.kind != VarSlot::UNRESOLVED) {
+            if (std::optional<Value> &storage = getSlot(slot); storage) {
+                return *storage;
+            }
+        }
+        reportNotDefined(name);
+    }
+    // storage the slot refers to at this point of execution
+    std::optional<Value>& getSlot(const VarSlot &slot) {
+        switch (slot.kind) {
+            case VarSlot::LOCAL:
+                return getLocalSlot(slot.local);
+            case VarSlot::GLOBAL:
+                return globals_[slot.global];
+            case VarSlot::GLOBAL_OR_LOCAL:
+                return isGlobalDefined(slot.global) ? globals_[slot.global] : getLocalSlot(slot.local);
+            default:
+                reportNotResolved();
+        }
+    }
+    
+    std::optional<Value>& getLocalSlot(std::uint32_t index) {
+        assert(!fccStack_.empty());
+        return fccStack_.top().frame[index];
+    }
+    
+    std::optional<Value>& getGlobalSlot(std::uint32_t index) {
+        return globals_[index];
+    }
     
-    // adds variable in current scope
-    void addVariable(const std::string &name, Value value);
-    void assignVariable(const std::string &name, Value value);
-    std::optional<Value> getVariable(const std::string &name) const;
-    Value getVariableOrError(const std::string &name) const;
+    const std::optional<Value>& getGlobalSlot(std::uint32_t index) const {
+        return globals_[index];
+    }
     
-    const FuncDef* getFuncDef(const std::string &name) const;
+    bool isGlobalDefined(std::uint32_t index) const {
+        return globals_[index].has_value();
+    }
+    
+    // calls of pure functions (FuncDef::isPure()) are memoized when enabled
+    void setMemoization(bool isEnabled) {
+        isMemoizing_ = isEnabled;
+    }
+    
+    bool isMemoizing() const {
+        return isMemoizing_;
+    }
+    
+    // result of an earlier call of the function with identical arguments, nullptr if there was none;
+    // tables are cleared by reset() and hold at most MAX_MEMOIZED_CALLS calls of a function
+    const std::optional<Value>* findMemoized(const FuncDef &funcDef, const std::vector<Value> &args) const;
+    void memoize(const FuncDef &funcDef, std::vector<Value> &&args, std::optional<Value> result);
     
     void setReturnValue(Value value);
     std::optional<Value> consumeReturnValue();
     
-    void newFuncCallContext();
-    void deleteFuncCallContext();
+    // requested by Return instead of setting the return value
+    void setTailCall(const FuncDef &funcDef, std::vector<Value> &&args);
+    std::optional<TailCall> consumeTailCall();
+    
+    // number of function calls in progress, not counting the main function call context;
+    // calls deeper than the maximum depth are reported as errors
+    std::size_t getCallDepth() const {
+        return fccStack_.empty() ? 0 : fccStack_.size() - 1;
+    }
     
-    void newScope();
-    void deleteScope();
+    std::size_t getMaxCallDepth() const {
+        return maxCallDepth_;
+    }
     
-    const FuncCallContext::Scope& getGlobalScope() const;
-    FuncCallContext::Scope& getGlobalScope();
+    void setMaxCallDepth(std::size_t depth) {
+        maxCallDepth_ = depth;
+    }
     
-    std::ostream& getStdout();
-    void printLineToStdout(const std::string &text);
+    void newFuncCallContext(std::size_t frameSize);
+    // clears the current function call context for the next call made in it
+    void resetFuncCallContext(std::size_t frameSize);
+    void deleteFuncCallContext();
+    
+    void printLineToStdout(const std::string &text) {
+        stdout_->writeLine(text);
+    }
+
+private:
+    // errors of getVariable() and getSlot(), kept out of their inlined bodies
+    [[noreturn]] static void reportNotDefined(const std::string &name);
+    [[noreturn]] static void reportNotResolved();
+
+    struct ArgsHash {
+        std::size_t operator()(const std::vector<Value> &args) const;
+    };
+    // values (numbers bit by bit) and types including unit prefixes are equal
+    struct ArgsEqual {
+        bool operator()(const std::vector<Value> &left, const std::vector<Value> &right) const;
+    };
+    using MemoTable = std::unordered_map<std::vector<Value>, std::optional<Value>, ArgsHash, ArgsEqual>;
 
 private:
-    std::ostream &stdout_;
-    Program &program_;
+    std::unique_ptr<Sink> ownedStdout_;
+    Sink *stdout_;
+    std::ostream *errorStream_ = &std::cerr;
+    const Program *program_;
+    std::vector<Value> inputValues_;
     // explicitly use std::deque because it guarantees stable references to elements
     std::stack<FuncCallContext, std::deque<FuncCallContext>> fccStack_;
-    FuncCallContext *mainContext_ = nullptr;
+    FuncCallContext::Frame globals_;
     // empty optional means void
     std::optional<Value> returnValue_;
+    std::optional<TailCall> tailCall_;
+    std::size_t maxCallDepth_ = DEFAULT_MAX_CALL_DEPTH;
+    bool isMemoizing_ = false;
+    std::unordered_map<const FuncDef *, MemoTable> memoTables_;
 };
 
 #endif // TKOMSIUNITS_CODE_OBJECTS_INTERPRETER_H_INCLUDED
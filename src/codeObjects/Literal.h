@@ -0,0 +1,49 @@
+#ifndef TKOMSIUNITS_CODE_OBJECTS_LITERAL_H_INCLUDED
+#define TKOMSIUNITS_CODE_OBJECTS_LITERAL_H_INCLUDED
+
+#include "Expression.h"
+#include "Value.h"
+#include <optional>
+#include <string>
+#include <utility>
+
+// Constant in the program code (number with unit, bool, string); Value itself
+// is not an Expression, so values calculated at run time carry no code object
+class Literal : public Expression {
+public:
+    explicit Literal(Value value)
+        : value_(std::move(value)) {}
+    
+    Value calculate([[maybe_unused]] Interpreter &interpreter) const override {
+        return value_;
+    }
+    
+    const Value& calculateRef([[maybe_unused]] Interpreter &interpreter, [[maybe_unused]] std::optional<Value> &temporary) const override {
+        return value_;
+    }
+    
+    double calculateNumber([[maybe_unused]] Interpreter &interpreter) const override {
+        return value_.asDouble();
+    }
+    
+    bool calculateBool([[maybe_unused]] Interpreter &interpreter) const override {
+        return value_.asBool();
+    }
+    
+    std::string getRPN() const override {
+        return value_.toString();
+    }
+    
+    void accept(CodeObjectVisitor &visitor) override {
+        visitor.visit(*this);
+    }
+    
+    const Value& getValue() const {
+        return value_;
+    }
+    
+private:
+    Value value_;
+};
+
+#endif // TKOMSIUNITS_CODE_OBJECTS_LITERAL_H_INCLUDED
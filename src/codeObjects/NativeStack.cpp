@@ -0,0 +1,24 @@
+#include "NativeStack.h"
+
+#include <pthread.h>
+
+std::uintptr_t NativeStack::getLimit() {
+    // found once per thread, the stack of a thread does not move
+    thread_local const std::uintptr_t limit = findLimit();
+    return limit;
+}
+
+std::uintptr_t NativeStack::findLimit() {
+    pthread_attr_t attributes;
+    if (pthread_getattr_np(pthread_self(), &attributes) != 0) {
+        return 0;
+    }
+    void *lowest = nullptr;
+    std::size_t size = 0;
+    int error = pthread_attr_getstack(&attributes, &lowest, &size);
+    pthread_attr_destroy(&attributes);
+    if (error != 0 || size <= 2 * RESERVE) {
+        return 0;
+    }
+    return reinterpret_cast<std::uintptr_t>(lowest) + RESERVE;
+}
@@ -0,0 +1,28 @@
+#ifndef TKOMSIUNITS_CODE_OBJECTS_NATIVE_STACK_H_INCLUDED
+#define TKOMSIUNITS_CODE_OBJECTS_NATIVE_STACK_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+
+// Native stack of the calling thread, used by the engines recursing on it for calls of
+// functions (the tree walker, FlatEvaluator). Stack used by a call depends on how deeply
+// the body of the function nests, so instead of counting calls, a call is made only when
+// RESERVE bytes of the stack are left - enough for any body and for reporting the error.
+// The stack grows down, as on all platforms the interpreter is built for.
+class NativeStack {
+public:
+    static constexpr std::size_t RESERVE = 256 * 1024;
+
+public:
+    // checks the frame of the caller
+    static bool isExhausted() {
+        return reinterpret_cast<std::uintptr_t>(__builtin_frame_address(0)) < getLimit();
+    }
+
+private:
+    // lowest address the frames may reach; 0 if the stack of the thread is unknown
+    static std::uintptr_t getLimit();
+    static std::uintptr_t findLimit();
+};
+
+#endif // TKOMSIUNITS_CODE_OBJECTS_NATIVE_STACK_H_INCLUDED
@@ -0,0 +1,53 @@
+#include "NodeArena.h"
+
+#include <algorithm>
+#include <new>
+
+namespace {
+
+// precedes every object allocated by ArenaAllocated, keeps the alignment of the object
+struct alignas(std::max_align_t) AllocationHeader {
+    bool isInArena;
+};
+
+constexpr std::size_t alignedSize(std::size_t size) {
+    constexpr std::size_t alignment = alignof(std::max_align_t);
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+} // anonymous namespace
+
+thread_local NodeArena *NodeArena::current_ = nullptr;
+
+void* NodeArena::allocate(std::size_t size) {
+    size = alignedSize(size);
+    if (static_cast<std::size_t>(end_ - next_) < size) {
+        // objects larger than a block get a block of their own
+        std::size_t blockSize = std::max(size, BLOCK_SIZE);
+        blocks_.emplace_back(new std::byte[blockSize]);
+        next_ = blocks_.back().get();
+        end_ = next_ + blockSize;
+    }
+    void *ptr = next_;
+    next_ += size;
+    allocatedSize_ += size;
+    return ptr;
+}
+
+void* ArenaAllocated::operator new(std::size_t size) {
+    NodeArena *arena = NodeArena::current();
+    std::size_t totalSize = sizeof(AllocationHeader) + size;
+    void *memory = arena ? arena->allocate(totalSize) : ::operator new(totalSize);
+    auto *header = new (memory) AllocationHeader{ arena != nullptr };
+    return header + 1;
+}
+
+void ArenaAllocated::operator delete(void *ptr) {
+    if (!ptr) {
+        return;
+    }
+    auto *header = static_cast<AllocationHeader *>(ptr) - 1;
+    if (!header->isInArena) {
+        ::operator delete(header);
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef TKOMSIUNITS_CODE_OBJECTS_NODE_ARENA_H_INCLUDED
+#define TKOMSIUNITS_CODE_OBJECTS_NODE_ARENA_H_INCLUDED
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Bump allocator owning memory of the code objects of a Program. Code objects created
+// while the arena is active in the thread (NodeArena::Scope) are placed next to each
+// other in the order they are parsed. Deleting such an object only runs its destructor;
+// the memory is released all at once with the arena, which outlives the code objects.
+class NodeArena {
+public:
+    // makes the arena active in the current thread until destroyed
+    class Scope {
+    public:
+        explicit Scope(NodeArena &arena)
+            : previous_(std::exchange(current_, &arena)) {}
+        ~Scope() {
+            current_ = previous_;
+        }
+        Scope(const Scope &) = delete;
+        Scope& operator=(const Scope &) = delete;
+    
+    private:
+        NodeArena *previous_;
+    };
+
+public:
+    NodeArena() = default;
+    NodeArena(const NodeArena &) = delete;
+    NodeArena& operator=(const NodeArena &) = delete;
+    
+    // aligned to alignof(std::max_align_t)
+    void* allocate(std::size_t size);
+    
+    // bytes taken by allocated objects
+    std::size_t getAllocatedSize() const {
+        return allocatedSize_;
+    }
+    
+    // nullptr if no arena is active in the current thread
+    static NodeArena* current() {
+        return current_;
+    }
+
+private:
+    static constexpr std::size_t BLOCK_SIZE = 64 * 1024;
+
+private:
+    std::vector<std::unique_ptr<std::byte[]>> blocks_;
+    std::byte *next_ = nullptr;
+    std::byte *end_ = nullptr;
+    std::size_t allocatedSize_ = 0;
+    
+    static thread_local NodeArena *current_;
+};
+
+// Base of code objects: allocates them in the active NodeArena, or on the heap if there
+// is none (e.g. code objects built directly, outside the Parser).
+class ArenaAllocated {
+public:
+    static void* operator new(std::size_t size);
+    static void operator delete(void *ptr);
+};
+
+#endif // TKOMSIUNITS_CODE_OBJECTS_NODE_ARENA_H_INCLUDED
@@ -1,19 +1,37 @@
 #include "Program.h"
 #include "Interpreter.h"
+#include "Resolver.h"
+#include "TypeChecker.h"
+#include "ConstantFolder.h"
+#include "PurityAnalyzer.h"
 
 Program::Program(
         std::vector<std::unique_ptr<FuncDef>> &&funcDefs,
-        std::vector<std::unique_ptr<Instruction>> &&instructions
+        std::vector<std::unique_ptr<Instruction>> &&instructions,
+        std::unique_ptr<NodeArena> &&arena,
+        std::vector<Variable> &&inputs
     )
-    : instructions_(std::move(instructions)) {
+    : arena_(std::move(arena))
+    , instructions_(std::move(instructions))
+    , inputs_(std::move(inputs)) {
+    // taken over before anything can throw: functions left after a redefinition are
+    // destroyed during unwinding, while the arena (destroyed after the body) still holds them
+    std::vector<std::unique_ptr<FuncDef>> ownFuncDefs(std::move(funcDefs));
     addPredefinedPrintFunc();
-    for (auto &&func : funcDefs) {
+    for (auto &&func : ownFuncDefs) {
         addFuncDef(std::move(func));
     }
+    Resolver::resolve(*this);
+    TypeChecker::check(*this);
+    ConstantFolder::fold(*this);
+    PurityAnalyzer::analyze(*this);
 }
 
 int Program::execute(Interpreter &interpreter) const {
-    InstrResult result = instructions_.execute(interpreter);
+    return finish(interpreter, instructions_.execute(interpreter));
+}
+
+int Program::finish(Interpreter &interpreter, InstrResult result) const {
     switch (result) {
         case InstrResult::BREAK:
             ErrorHandler::handleJumpInstrOutsideWhile("Break not inside While");
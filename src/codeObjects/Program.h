@@ -4,7 +4,9 @@
 #include "InstructionBlock.h"
 #include "InternalPrintInstr.h"
 #include "FuncDef.h"
+#include "NodeArena.h"
 #include "Value.h"
+#include "Variable.h"
 #include "error/ErrorHandler.h"
 #include <memory>
 #include <unordered_map>
@@ -17,22 +19,62 @@ class Interpreter;
 
 class Program {
 public:
+    // code objects may be allocated in the arena, which is then owned by the Program;
+    // inputs are global variables defined before the first instruction, with values
+    // provided for every execution (Interpreter::setInputValues())
     Program(
             std::vector<std::unique_ptr<FuncDef>> &&funcDefs,
-            std::vector<std::unique_ptr<Instruction>> &&instructions
+            std::vector<std::unique_ptr<Instruction>> &&instructions,
+            std::unique_ptr<NodeArena> &&arena = nullptr,
+            std::vector<Variable> &&inputs = {}
         );
     
     int execute(Interpreter &interpreter) const;
+    // maps result of executing top-level instructions to program exit status
+    int finish(Interpreter &interpreter, InstrResult result) const;
     
     const FuncDef* getFuncDef(const std::string &name) const;
+    
+    const std::unordered_map<std::string, std::unique_ptr<FuncDef>>& getFuncDefs() const {
+        return funcDefs_;
+    }
+    
+    const InstructionBlock& getInstructions() const {
+        return instructions_;
+    }
+    
+    // occupy the first global variable slots, in order
+    const std::vector<Variable>& getInputs() const {
+        return inputs_;
+    }
+    
+    // number of local variable slots needed by top-level instructions (outside the global scope)
+    std::size_t getMainFrameSize() const {
+        return mainFrameSize_;
+    }
+    
+    // names of global variables indexed by their slots
+    const std::vector<std::string>& getGlobalNames() const {
+        return globalNames_;
+    }
+    
+    void setFrameLayout(std::size_t mainFrameSize, std::vector<std::string> &&globalNames) {
+        mainFrameSize_ = mainFrameSize;
+        globalNames_ = std::move(globalNames);
+    }
 
 private:
     void addFuncDef(std::unique_ptr<FuncDef> funcDef);
     void addPredefinedPrintFunc();
 
 private:
+    // destroyed after the code objects allocated in it
+    std::unique_ptr<NodeArena> arena_;
     std::unordered_map<std::string, std::unique_ptr<FuncDef>> funcDefs_;
     InstructionBlock instructions_;
+    std::vector<Variable> inputs_;
+    std::size_t mainFrameSize_ = 0;
+    std::vector<std::string> globalNames_;
 };
 
 #endif // TKOMSIUNITS_CODE_OBJECTS_PROGRAM_H_INCLUDED
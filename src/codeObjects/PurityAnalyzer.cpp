@@ -0,0 +1,123 @@
+#include "PurityAnalyzer.h"
+
+#include "Program.h"
+#include "FuncDef.h"
+#include "FuncCall.h"
+#include "BinaryExpression.h"
+#include "Literal.h"
+#include "VarReference.h"
+#include "String.h"
+#include "VarDefOrAssignment.h"
+#include "If.h"
+#include "While.h"
+#include "Return.h"
+#include "InternalPrintInstr.h"
+#include <unordered_map>
+
+void PurityAnalyzer::analyze(Program &program) {
+    struct Function {
+        FuncDef *funcDef;
+        bool isPure;
+        std::vector<const FuncDef *> callees;
+    };
+    std::unordered_map<const FuncDef *, Function> functions;
+    for (auto &&[_, funcDef] : program.getFuncDefs()) {
+        (void)_;
+        PurityAnalyzer analyzer;
+        analyzer.analyzeBlock(funcDef->getBody());
+        functions[funcDef.get()] = Function{ funcDef.get(), !analyzer.hasSideEffects_, std::move(analyzer.callees_) };
+    }
+
+    // function calling an impure function is impure; recursive calls keep functions pure
+    bool hasChanged = true;
+    while (hasChanged) {
+        hasChanged = false;
+        for (auto &&[_, function] : functions) {
+            (void)_;
+            if (!function.isPure) {
+                continue;
+            }
+            for (const FuncDef *callee : function.callees) {
+                if (!functions.at(callee).isPure) {
+                    function.isPure = false;
+                    hasChanged = true;
+                    break;
+                }
+            }
+        }
+    }
+    for (auto &&[_, function] : functions) {
+        (void)_;
+        function.funcDef->setPure(function.isPure);
+    }
+}
+
+void PurityAnalyzer::analyzeBlock(const InstructionBlock &block) {
+    for (auto &&instr : block.getInstructions()) {
+        instr->accept(*this);
+    }
+}
+
+void PurityAnalyzer::visit([[maybe_unused]] Literal &literal) {}
+
+void PurityAnalyzer::visit(BinaryExpression &expr) {
+    expr.getLeftOperand().accept(*this);
+    expr.getRightOperand().accept(*this);
+}
+
+void PurityAnalyzer::visit(VarReference &varRef) {
+    if (varRef.getSlot().kind != VarSlot::LOCAL) {
+        hasSideEffects_ = true;
+    }
+}
+
+void PurityAnalyzer::visit(codeobj::String &str) {
+    for (auto &&part : str.getParts()) {
+        part->accept(*this);
+    }
+}
+
+void PurityAnalyzer::visit(FuncCall &funcCall) {
+    for (auto &&arg : funcCall.getArgs()) {
+        arg->accept(*this);
+    }
+    callees_.push_back(funcCall.getFuncDef());
+}
+
+void PurityAnalyzer::visit(VarDefOrAssignment &instr) {
+    instr.getExpr().accept(*this);
+    bool isLocal = instr.getSlot().kind == VarSlot::LOCAL
+        && (instr.getMode() == VarDefOrAssignment::Mode::DEFINE || instr.getMode() == VarDefOrAssignment::Mode::ASSIGN);
+    if (!isLocal) {
+        hasSideEffects_ = true;
+    }
+}
+
+void PurityAnalyzer::visit(If &instr) {
+    if (instr.getCond()) {
+        instr.getCond()->accept(*this);
+    }
+    analyzeBlock(instr.getPositiveBlock());
+    if (instr.getElseIf()) {
+        instr.getElseIf()->accept(*this);
+    }
+}
+
+void PurityAnalyzer::visit(While &instr) {
+    instr.getCond().accept(*this);
+    analyzeBlock(instr.getBody());
+}
+
+void PurityAnalyzer::visit(Return &instr) {
+    if (instr.getExpr()) {
+        instr.getExpr()->accept(*this);
+    }
+}
+
+void PurityAnalyzer::visit([[maybe_unused]] Break &instr) {}
+
+void PurityAnalyzer::visit([[maybe_unused]] Continue &instr) {}
+
+void PurityAnalyzer::visit([[maybe_unused]] InternalPrintInstr &instr) {
+    hasSideEffects_ = true;
+}
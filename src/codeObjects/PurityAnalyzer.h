@@ -0,0 +1,40 @@
+#ifndef TKOMSIUNITS_CODE_OBJECTS_PURITY_ANALYZER_H_INCLUDED
+#define TKOMSIUNITS_CODE_OBJECTS_PURITY_ANALYZER_H_INCLUDED
+
+#include "CodeObjectVisitor.h"
+#include <vector>
+
+class Program;
+class FuncDef;
+class InstructionBlock;
+
+// Finds functions of Program resolved by Resolver whose result depends only on their
+// arguments: they do not print, do not refer to global variables (neither read nor
+// assign them) and call only such functions. Calls of pure functions may be memoized.
+class PurityAnalyzer : private CodeObjectVisitor {
+public:
+    static void analyze(Program &program);
+
+private:
+    void analyzeBlock(const InstructionBlock &block);
+
+    void visit(Literal &literal) override;
+    void visit(BinaryExpression &expr) override;
+    void visit(VarReference &varRef) override;
+    void visit(codeobj::String &str) override;
+    void visit(FuncCall &funcCall) override;
+    void visit(VarDefOrAssignment &instr) override;
+    void visit(If &instr) override;
+    void visit(While &instr) override;
+    void visit(Return &instr) override;
+    void visit(Break &instr) override;
+    void visit(Continue &instr) override;
+    void visit(InternalPrintInstr &instr) override;
+
+private:
+    // of the analyzed function, not counting its callees
+    bool hasSideEffects_ = false;
+    std::vector<const FuncDef *> callees_;
+};
+
+#endif // TKOMSIUNITS_CODE_OBJECTS_PURITY_ANALYZER_H_INCLUDED
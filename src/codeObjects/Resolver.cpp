@@ -0,0 +1,236 @@
+#include "Resolver.h"
+
+#include "Program.h"
+#include "FuncDef.h"
+#include "FuncCall.h"
+#include "BinaryExpression.h"
+#include "Literal.h"
+#include "VarReference.h"
+#include "String.h"
+#include "VarDefOrAssignment.h"
+#include "If.h"
+#include "While.h"
+#include "Return.h"
+#include "InternalPrintInstr.h"
+#include "error/ErrorHandler.h"
+#include <algorithm>
+
+void Resolver::resolve(Program &program) {
+    Resolver resolver(program);
+    resolver.resolveMain(program);
+    // in order of names, so that the reported error does not depend on hashing
+    std::vector<FuncDef *> functions;
+    for (auto &&[_, funcDef] : program.getFuncDefs()) {
+        (void)_;
+        functions.push_back(funcDef.get());
+    }
+    std::sort(functions.begin(), functions.end(), [](const FuncDef *left, const FuncDef *right) {
+            return left->getName() < right->getName();
+        });
+    for (FuncDef *funcDef : functions) {
+        resolver.resolveFunction(*funcDef);
+    }
+}
+
+void Resolver::resolveMain(Program &program) {
+    std::vector<std::string> globalNames;
+    for (auto &&input : program.getInputs()) {
+        auto [_, inserted] = globalSlots_.insert({ input.getName(), static_cast<std::uint32_t>(globalNames.size()) });
+        (void)_;
+        if (!inserted) {
+            ErrorHandler::handleFromCodeObject("Redefinition of input variable named '" + input.getName() + "'");
+        }
+        if (input.getType().getTypeClass() == Type::VOID) {
+            ErrorHandler::handleTypeMismatch("Input variable '" + input.getName() + "' cannot be of type void");
+        }
+        globalNames.push_back(input.getName());
+    }
+    const auto &instructions = program.getInstructions().getInstructions();
+    for (auto &&instr : instructions) {
+        if (auto varDef = dynamic_cast<const VarDefOrAssignment *>(instr.get())) {
+            auto [_, inserted] = globalSlots_.insert({ varDef->getName(), static_cast<std::uint32_t>(globalNames.size()) });
+            (void)_;
+            if (inserted) {
+                globalNames.push_back(varDef->getName());
+            }
+        }
+    }
+
+    // top-level instructions block is the global scope, inputs are defined before its instructions
+    scopes_.assign(1, Scope());
+    for (auto &&input : program.getInputs()) {
+        scopes_.back()[input.getName()] = VarSlot{ VarSlot::GLOBAL, 0, globalSlots_.at(input.getName()) };
+    }
+    inFunction_ = false;
+    localCount_ = 0;
+    frameSize_ = 0;
+    for (auto &&instr : instructions) {
+        instr->accept(*this);
+    }
+    program.setFrameLayout(frameSize_, std::move(globalNames));
+}
+
+void Resolver::resolveFunction(FuncDef &funcDef) {
+    // parameters have separate scope from variables defined in the body
+    scopes_.assign(1, Scope());
+    inFunction_ = true;
+    localCount_ = 0;
+    frameSize_ = 0;
+    std::uint32_t firstParamBinding = bindingCount_;
+    for (auto &&param : funcDef.getParams()) {
+        scopes_.back()[param.getName()] = newLocal();
+    }
+    resolveBlock(funcDef.getBody());
+    funcDef.setFrameLayout(frameSize_, firstParamBinding);
+}
+
+void Resolver::resolveBlock(InstructionBlock &block) {
+    std::uint32_t blockStart = localCount_;
+    scopes_.emplace_back();
+    for (auto &&instr : block.getInstructions()) {
+        instr->accept(*this);
+    }
+    scopes_.pop_back();
+    // slots of sibling blocks overlap
+    localCount_ = blockStart;
+}
+
+VarSlot Resolver::lookup(const std::string &name) const {
+    for (auto riter = scopes_.crbegin(); riter != scopes_.crend(); ++riter) {
+        if (auto varIt = riter->find(name); varIt != riter->end()) {
+            return varIt->second;
+        }
+    }
+    if (inFunction_) {
+        if (auto iter = globalSlots_.find(name); iter != globalSlots_.end()) {
+            return VarSlot{ VarSlot::GLOBAL, 0, iter->second };
+        }
+    }
+    return VarSlot{};
+}
+
+VarSlot Resolver::defineInCurrentScope(const std::string &name) {
+    VarSlot slot = inGlobalScope()
+        ? VarSlot{ VarSlot::GLOBAL, 0, globalSlots_.at(name) }
+        : newLocal();
+    scopes_.back()[name] = slot;
+    return slot;
+}
+
+std::uint32_t Resolver::allocateLocal() {
+    std::uint32_t slot = localCount_++;
+    if (localCount_ > frameSize_) {
+        frameSize_ = localCount_;
+    }
+    return slot;
+}
+
+VarSlot Resolver::newLocal() {
+    VarSlot slot{ VarSlot::LOCAL, allocateLocal(), 0 };
+    slot.binding = bindingCount_++;
+    return slot;
+}
+
+bool Resolver::inGlobalScope() const {
+    return !inFunction_ && scopes_.size() == 1;
+}
+
+void Resolver::visit([[maybe_unused]] Literal &literal) {}
+
+void Resolver::visit(BinaryExpression &expr) {
+    expr.getLeftOperand().accept(*this);
+    expr.getRightOperand().accept(*this);
+}
+
+void Resolver::visit(VarReference &varRef) {
+    varRef.setSlot(lookup(varRef.getName()));
+}
+
+void Resolver::visit(codeobj::String &str) {
+    for (auto &&part : str.getParts()) {
+        part->accept(*this);
+    }
+}
+
+void Resolver::visit(FuncCall &funcCall) {
+    const FuncDef *funcDef = program_.getFuncDef(funcCall.getName());
+    if (!funcDef) {
+        ErrorHandler::handleFunctionNotDefined(funcCall.getName());
+    }
+    funcCall.setFuncDef(*funcDef);
+    for (auto &&arg : funcCall.getArgs()) {
+        arg->accept(*this);
+    }
+}
+
+void Resolver::visit(VarDefOrAssignment &instr) {
+    // expression is calculated before the variable is defined
+    instr.getExpr().accept(*this);
+
+    const std::string &name = instr.getName();
+    Scope &currentScope = scopes_.back();
+    if (instr.getDeclaredType()) {
+        // definition with type declaration always defines variable in current scope
+        auto iter = currentScope.find(name);
+        if (iter == currentScope.end()) {
+            instr.setTarget(defineInCurrentScope(name), VarDefOrAssignment::Mode::DEFINE);
+        } else if (iter->second.kind == VarSlot::GLOBAL_OR_LOCAL) {
+            // previous definition in this scope assigned global variable if it was defined
+            iter->second.kind = VarSlot::LOCAL;
+            iter->second.binding = bindingCount_++;
+            instr.setTarget(iter->second, VarDefOrAssignment::Mode::DEFINE_IF_GLOBAL);
+        } else {
+            instr.setTarget(iter->second, VarDefOrAssignment::Mode::REDEFINITION);
+        }
+        return;
+    }
+
+    VarSlot visible = lookup(name);
+    if (visible.kind == VarSlot::UNRESOLVED) {
+        instr.setTarget(defineInCurrentScope(name), VarDefOrAssignment::Mode::DEFINE);
+    } else if (visible.kind == VarSlot::GLOBAL && inFunction_) {
+        // in function body global variable is assigned if it is already defined,
+        // otherwise the variable is defined locally
+        VarSlot slot = newLocal();
+        slot.kind = VarSlot::GLOBAL_OR_LOCAL;
+        slot.global = visible.global;
+        currentScope[name] = slot;
+        instr.setTarget(slot, VarDefOrAssignment::Mode::DEFINE_OR_ASSIGN);
+    } else {
+        instr.setTarget(visible, VarDefOrAssignment::Mode::ASSIGN);
+    }
+}
+
+void Resolver::visit(If &instr) {
+    if (instr.getCond()) {
+        instr.getCond()->accept(*this);
+    }
+    resolveBlock(instr.getPositiveBlock());
+    if (instr.getElseIf()) {
+        instr.getElseIf()->accept(*this);
+    }
+}
+
+void Resolver::visit(While &instr) {
+    instr.getCond().accept(*this);
+    resolveBlock(instr.getBody());
+}
+
+void Resolver::visit(Return &instr) {
+    if (instr.getExpr()) {
+        instr.getExpr()->accept(*this);
+    }
+    // nothing is executed after a returned call in a function body, so its function call
+    // context can be reused; returning from main sets the exit status instead
+    if (auto *funcCall = dynamic_cast<const FuncCall *>(instr.getExpr()); funcCall && inFunction_) {
+        instr.setTailCall(*funcCall);
+    }
+}
+
+void Resolver::visit([[maybe_unused]] Break &instr) {}
+
+void Resolver::visit([[maybe_unused]] Continue &instr) {}
+
+void Resolver::visit(InternalPrintInstr &instr) {
+    instr.setSlot(lookup(instr.getStringVariableName()));
+}
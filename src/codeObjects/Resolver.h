@@ -0,0 +1,69 @@
+#ifndef TKOMSIUNITS_CODE_OBJECTS_RESOLVER_H_INCLUDED
+#define TKOMSIUNITS_CODE_OBJECTS_RESOLVER_H_INCLUDED
+
+#include "CodeObjectVisitor.h"
+#include "VarSlot.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Program;
+class FuncDef;
+class InstructionBlock;
+
+// Assigns frame slots to variables of Program and all its functions, so that variables
+// are accessed by index instead of by name in a chain of scopes.
+// Variable definition and visibility depend only on the order of instructions inside
+// blocks, so they are resolved statically; the only exception are global variables
+// referenced from function bodies, which may be not yet defined at the time of the call.
+// Function calls are bound to the called functions; calls of not-defined functions are
+// reported before the program is executed. Input variables of the Program take the
+// first global slots.
+class Resolver : private CodeObjectVisitor {
+public:
+    static void resolve(Program &program);
+
+private:
+    using Scope = std::unordered_map<std::string, VarSlot>;
+
+private:
+    explicit Resolver(const Program &program)
+        : program_(program) {}
+
+    void resolveMain(Program &program);
+    void resolveFunction(FuncDef &funcDef);
+    void resolveBlock(InstructionBlock &block);
+
+    VarSlot lookup(const std::string &name) const;
+    VarSlot defineInCurrentScope(const std::string &name);
+    std::uint32_t allocateLocal();
+    VarSlot newLocal();
+    bool inGlobalScope() const;
+
+    void visit(Literal &literal) override;
+    void visit(BinaryExpression &expr) override;
+    void visit(VarReference &varRef) override;
+    void visit(codeobj::String &str) override;
+    void visit(FuncCall &funcCall) override;
+    void visit(VarDefOrAssignment &instr) override;
+    void visit(If &instr) override;
+    void visit(While &instr) override;
+    void visit(Return &instr) override;
+    void visit(Break &instr) override;
+    void visit(Continue &instr) override;
+    void visit(InternalPrintInstr &instr) override;
+
+private:
+    const Program &program_;
+    // names defined directly in top-level instructions
+    std::unordered_map<std::string, std::uint32_t> globalSlots_;
+    std::vector<Scope> scopes_;
+    bool inFunction_ = false;
+    std::uint32_t localCount_ = 0;
+    std::uint32_t frameSize_ = 0;
+    std::uint32_t bindingCount_ = 0;
+};
+
+#endif // TKOMSIUNITS_CODE_OBJECTS_RESOLVER_H_INCLUDED
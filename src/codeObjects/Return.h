@@ -3,6 +3,7 @@
 
 #include "Instruction.h"
 #include "Expression.h"
+#include "FuncCall.h"
 #include <memory>
 #include <string>
 
@@ -12,7 +13,9 @@ public:
         : expr_(std::move(expr)) {}
         
     InstrResult execute([[maybe_unused]] Interpreter &interpreter) const override {
-        if (expr_) {
+        if (tailCall_) {
+            tailCall_->requestTailCall(interpreter);
+        } else if (expr_) {
             Value value = expr_->calculate(interpreter);
             interpreter.setReturnValue(std::move(value));
         }
@@ -24,8 +27,30 @@ public:
         return INSTR_TYPE;
     }
     
+    void accept(CodeObjectVisitor &visitor) override {
+        visitor.visit(*this);
+    }
+    
+    // nullptr when no value is returned
+    Expression* getExpr() const {
+        return expr_.get();
+    }
+    
+    // returned expression if it is a call of a function made from a function body,
+    // executed as a tail call; set by Resolver
+    const FuncCall* getTailCall() const {
+        return tailCall_;
+    }
+    
+    void setTailCall(const FuncCall &tailCall) {
+        tailCall_ = &tailCall;
+    }
+    
 private:
     std::unique_ptr<Expression> expr_;
+    const FuncCall *tailCall_ = nullptr;
+
+    friend class ConstantFolder;
 };
 
 #endif // TKOMSIUNITS_CODE_OBJECTS_RETURN_H_INCLUDED
@@ -4,8 +4,11 @@
 #include "Expression.h"
 #include "Value.h"
 #include <memory>
+#include <optional>
 #include <vector>
 
+class ConstantFolder;
+
 namespace codeobj {
 
 class String : public Expression {
@@ -13,10 +16,11 @@ public:
     String(std::vector<std::unique_ptr<Expression>> &&parts)
         : parts_(std::move(parts)) {}
     
-    Value calculate([[maybe_unused]] Interpreter &interpreter) override {
+    Value calculate([[maybe_unused]] Interpreter &interpreter) const override {
         std::string value;
         for (auto &&part : parts_) {
-            value += part->calculate(interpreter).toString();
+            std::optional<Value> temporary;
+            value += part->calculateRef(interpreter, temporary).toString();
         }
         return Value(std::move(value));
     }
@@ -24,9 +28,19 @@ public:
     std::string getRPN() const override {
         return "<str>";
     }
+    
+    void accept(CodeObjectVisitor &visitor) override {
+        visitor.visit(*this);
+    }
+    
+    const std::vector<std::unique_ptr<Expression>>& getParts() const {
+        return parts_;
+    }
 
 private:
     std::vector<std::unique_ptr<Expression>> parts_;
+
+    friend class ::ConstantFolder;
 };
 
 } // namespace codeobj
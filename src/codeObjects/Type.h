@@ -4,6 +4,7 @@
 #include "Unit.h"
 #include <cassert>
 #include <string>
+#include <utility>
 #include <variant>
 
 class Type {
@@ -12,19 +13,26 @@ public:
         NUMBER,
         BOOL,
         VOID,
-        STRING
+        STRING,
+        // numbers of the same unit, operated on element-wise
+        ARRAY
     };
     
 public:
     Type(TypeClass typeClass = TypeClass::VOID) : unit_(), type_(typeClass) {}
     Type(codeobj::Unit &&unit) : unit_(std::move(unit)), type_(NUMBER) {}
+    // NUMBER or ARRAY
+    Type(TypeClass typeClass, codeobj::Unit &&unit) : unit_(std::move(unit)), type_(typeClass) {
+        assert(typeClass == NUMBER || typeClass == ARRAY);
+    }
 
     TypeClass getTypeClass() const noexcept {
         return type_;
     }
     
+    // unit of a number or of the elements of an array
     const codeobj::Unit& asUnit() const {
-        assert(type_ == NUMBER);
+        assert(type_ == NUMBER || type_ == ARRAY);
         return unit_;
     }
     
@@ -42,6 +50,9 @@ public:
                 return "[void]";
             case STRING:
                 return "[str]";
+            case ARRAY:
+                // "[array 1]" or "[array (m)/(s)]"
+                return "[array " + unit_.toString().substr(1);
             default:
                 return "<unknown type>";
         }
@@ -55,6 +66,11 @@ public:
         return !(*this == other);   
     }
     
+    // unlike operator==, takes unit prefixes into account
+    bool isIdenticalTo(const Type &other) const {
+        return type_ == other.type_ && unit_.isIdenticalTo(other.unit_);
+    }
+    
 private:
     codeobj::Unit unit_;
     TypeClass type_;
@@ -0,0 +1,335 @@
+#include "TypeChecker.h"
+
+#include "Program.h"
+#include "FuncDef.h"
+#include "FuncCall.h"
+#include "BinaryExpression.h"
+#include "Literal.h"
+#include "VarReference.h"
+#include "String.h"
+#include "VarDefOrAssignment.h"
+#include "If.h"
+#include "While.h"
+#include "Return.h"
+#include "InternalPrintInstr.h"
+#include "error/ErrorHandler.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+// value of the type, used to apply operations to types only
+Value sampleValue(const Type &type) {
+    switch (type.getTypeClass()) {
+        case Type::NUMBER:
+            return Value(1.0, Type(type));
+        case Type::BOOL:
+            return Value(false);
+        case Type::ARRAY:
+            return Value(std::vector<double>{ 1.0 }, Type(type));
+        default:
+            return Value(std::string());
+    }
+}
+
+Type withoutPrefixes(Type type) {
+    if (type.getTypeClass() == Type::NUMBER || type.getTypeClass() == Type::ARRAY) {
+        type.asUnit().clearPrefixes();
+    }
+    return type;
+}
+
+} // anonymous namespace
+
+void TypeChecker::check(Program &program) {
+    TypeChecker checker(program);
+    do {
+        checker.hasChanged_ = false;
+        checker.checkProgram();
+    } while (checker.hasChanged_);
+    checker.isFinalPass_ = true;
+    checker.checkProgram();
+}
+
+TypeChecker::TypeChecker(Program &program)
+    : program_(program)
+    , globals_(program.getGlobalNames().size()) {
+    // values of inputs are provided at run time, with any unit prefixes
+    const auto &inputs = program.getInputs();
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+        globals_[i] = Binding{ inputs[i].getType(), false };
+    }
+    for (auto &&[_, funcDef] : program.getFuncDefs()) {
+        (void)_;
+        functions_.push_back(funcDef.get());
+        const auto &params = funcDef->getParams();
+        for (std::size_t i = 0; i < params.size(); ++i) {
+            paramTypes_[funcDef->getParamBinding(i)] = &params[i].getType();
+        }
+    }
+    std::sort(functions_.begin(), functions_.end(), [](const FuncDef *left, const FuncDef *right) {
+            return left->getName() < right->getName();
+        });
+}
+
+void TypeChecker::checkProgram() {
+    currentFunction_ = nullptr;
+    checkBlock(program_.getInstructions());
+    for (FuncDef *funcDef : functions_) {
+        checkFunction(*funcDef);
+    }
+}
+
+void TypeChecker::checkFunction(FuncDef &funcDef) {
+    currentFunction_ = &funcDef;
+    checkBlock(funcDef.getBody());
+    currentFunction_ = nullptr;
+}
+
+void TypeChecker::checkBlock(const InstructionBlock &block) {
+    for (auto &&instr : block.getInstructions()) {
+        asStatement_ = true;
+        instr->accept(*this);
+    }
+}
+
+TypeChecker::StaticType TypeChecker::infer(Expression &expr) {
+    asStatement_ = false;
+    expr.accept(*this);
+    return std::move(result_);
+}
+
+void TypeChecker::store(Binding &binding, const StaticType &value) {
+    if (!value.type || !binding.isExact) {
+        return;
+    }
+    if (!binding.type) {
+        binding.type = value.type;
+        binding.isExact = value.isExact;
+        hasChanged_ = true;
+    } else if (!value.isExact || !binding.type->isIdenticalTo(*value.type)) {
+        binding.isExact = false;
+        hasChanged_ = true;
+    }
+}
+
+TypeChecker::Binding& TypeChecker::variableBinding(const VarSlot &slot) {
+    if (slot.kind == VarSlot::GLOBAL) {
+        return globals_[slot.global];
+    }
+    return locals_[slot.binding];
+}
+
+TypeChecker::StaticType TypeChecker::loadVariable(const VarSlot &slot) {
+    switch (slot.kind) {
+        case VarSlot::UNRESOLVED:
+            return StaticType{};
+        case VarSlot::GLOBAL_OR_LOCAL:
+            // the global variable has the same dimension or its assignment fails
+            return StaticType{ locals_[slot.binding].type, false };
+        default:
+            break;
+    }
+    const Binding &binding = variableBinding(slot);
+    if (!binding.type && slot.kind == VarSlot::LOCAL) {
+        // parameter of a function not called yet
+        if (auto iter = paramTypes_.find(slot.binding); iter != paramTypes_.end()) {
+            return StaticType{ *iter->second, true };
+        }
+    }
+    return StaticType{ binding.type, binding.isExact };
+}
+
+TypeChecker::StaticType TypeChecker::loadReturnValue(const FuncDef &funcDef) {
+    const Binding &binding = returnValues_[&funcDef];
+    if (!binding.type) {
+        return StaticType{ funcDef.getType(), true };
+    }
+    return StaticType{ binding.type, binding.isExact };
+}
+
+void TypeChecker::visit(Literal &literal) {
+    result_ = StaticType{ literal.getValue().type, true };
+}
+
+void TypeChecker::visit(BinaryExpression &expr) {
+    StaticType left = infer(expr.getLeftOperand());
+    StaticType right = infer(expr.getRightOperand());
+    if (!left.type || !right.type) {
+        result_ = StaticType{};
+        return;
+    }
+
+    // the operation applied to sample values reports type mismatches the same way
+    // as at run time; prefixes of the operands may change, so only dimensions are checked
+    BinaryExpression::Operation operation = BinaryExpression::findOperation(expr.getOperatorKind());
+    Value sample = sampleValue(withoutPrefixes(*left.type));
+    operation(sample, sampleValue(withoutPrefixes(*right.type)));
+    if (left.type->getTypeClass() == Type::ARRAY || right.type->getTypeClass() == Type::ARRAY) {
+        // the operation checks and combines units once per array at run time,
+        // so it is not specialized; prefixes of the result are not tracked
+        result_ = StaticType{ std::move(sample.type), false };
+        return;
+    }
+    StaticType type{ std::move(sample.type), true };
+
+    if (type.type->getTypeClass() == Type::NUMBER) {
+        if (expr.getOperatorKind() == BinaryExpression::Operator::MULT
+            || expr.getOperatorKind() == BinaryExpression::Operator::DIV
+        ) {
+            type.isExact = false;
+            if (left.isExact && right.isExact) {
+                try {
+                    Value exact = sampleValue(*left.type);
+                    operation(exact, sampleValue(*right.type));
+                    type = StaticType{ std::move(exact.type), true };
+                } catch (const std::runtime_error &) {
+                    // units with different prefixes; exactness may be refined in later passes
+                    if (isFinalPass_) {
+                        throw;
+                    }
+                }
+            }
+        } else {
+            // result has the type of the left operand
+            type = left;
+        }
+    }
+
+    if (isFinalPass_) {
+        expr.setStaticType(*type.type, type.isExact, left.type->getTypeClass());
+    }
+    result_ = std::move(type);
+}
+
+void TypeChecker::visit(VarReference &varRef) {
+    result_ = loadVariable(varRef.getSlot());
+}
+
+void TypeChecker::visit(codeobj::String &str) {
+    for (auto &&part : str.getParts()) {
+        infer(*part);
+    }
+    result_ = StaticType{ Type(Type::STRING), true };
+}
+
+void TypeChecker::visit(FuncCall &funcCall) {
+    bool asStatement = asStatement_;
+    const FuncDef *funcDef = funcCall.getFuncDef();
+    std::vector<StaticType> args;
+    for (auto &&arg : funcCall.getArgs()) {
+        args.push_back(infer(*arg));
+        if (!args.back().type) {
+            result_ = StaticType{};
+            return;
+        }
+    }
+    const auto &params = funcDef->getParams();
+    if (args.size() != params.size()) {
+        ErrorHandler::handleFunctionCallError("Argument and parameter count mismatch for function '" + funcDef->getName() + "'");
+    }
+    for (std::size_t i = 0; i < args.size(); ++i) {
+        if (*args[i].type != params[i].getType()) {
+            ErrorHandler::handleTypeMismatch("Argument and parameter types mismatch for function '" + funcDef->getName() + "'");
+        }
+        store(locals_[funcDef->getParamBinding(i)], args[i]);
+    }
+
+    result_ = loadReturnValue(*funcDef);
+    if (!asStatement && result_.type->getTypeClass() == Type::VOID) {
+        ErrorHandler::handleTypeMismatch("Function call as expression cannot evaluate to type void");
+    }
+}
+
+void TypeChecker::visit(VarDefOrAssignment &instr) {
+    StaticType value = infer(instr.getExpr());
+    if (!value.type) {
+        return;
+    }
+
+    const std::string &name = instr.getName();
+    if (instr.getDeclaredType() && *instr.getDeclaredType() != *value.type) {
+        ErrorHandler::handleTypeMismatch("Expression result type does not match declared variable type in variable '" + name + "' definition");
+    }
+    const VarSlot &slot = instr.getSlot();
+    bool assignsNumberInPlace = false;
+    switch (instr.getMode()) {
+        case VarDefOrAssignment::Mode::DEFINE:
+        case VarDefOrAssignment::Mode::DEFINE_IF_GLOBAL:
+            store(variableBinding(slot), value);
+            break;
+        case VarDefOrAssignment::Mode::ASSIGN: {
+            Binding &variable = variableBinding(slot);
+            if (variable.type && *variable.type != *value.type) {
+                ErrorHandler::handleTypeMismatch("Expression result type does not match variable type in variable '" + name + "' assignment");
+            }
+            store(variable, value);
+            if (slot.kind == VarSlot::GLOBAL_OR_LOCAL) {
+                // global variable may be assigned - its type is checked at run time
+                store(globals_[slot.global], value);
+                return;
+            }
+            assignsNumberInPlace = variable.isExact && value.type->getTypeClass() == Type::NUMBER;
+            break;
+        }
+        case VarDefOrAssignment::Mode::DEFINE_OR_ASSIGN:
+            // global variable is assigned if it is defined at the time of the call,
+            // its type is checked at run time
+            store(locals_[slot.binding], StaticType{ value.type, false });
+            store(globals_[slot.global], value);
+            return;
+        case VarDefOrAssignment::Mode::REDEFINITION:
+            return;
+    }
+    if (isFinalPass_) {
+        instr.setTypeChecked(assignsNumberInPlace);
+    }
+}
+
+void TypeChecker::visit(If &instr) {
+    if (instr.getCond()) {
+        StaticType cond = infer(*instr.getCond());
+        if (cond.type && cond.type->getTypeClass() != Type::BOOL) {
+            ErrorHandler::handleTypeMismatch("Expression used as If condition must result in bool value");
+        }
+    }
+    checkBlock(instr.getPositiveBlock());
+    if (instr.getElseIf()) {
+        instr.getElseIf()->accept(*this);
+    }
+}
+
+void TypeChecker::visit(While &instr) {
+    StaticType cond = infer(instr.getCond());
+    if (cond.type && cond.type->getTypeClass() != Type::BOOL) {
+        ErrorHandler::handleTypeMismatch("Expression used as While condition must result in bool value");
+    }
+    checkBlock(instr.getBody());
+}
+
+void TypeChecker::visit(Return &instr) {
+    if (!instr.getExpr()) {
+        return;
+    }
+    StaticType value = infer(*instr.getExpr());
+    if (!value.type) {
+        return;
+    }
+    if (!currentFunction_) {
+        if (value.type->getTypeClass() != Type::NUMBER || !value.type->asUnit().isScalar()) {
+            ErrorHandler::handleTypeMismatch("Return value from main can only of scalar type");
+        }
+        return;
+    }
+    const Type &returnType = currentFunction_->getType();
+    if (returnType.getTypeClass() == Type::VOID || returnType != *value.type) {
+        ErrorHandler::handleTypeMismatch("Value returned form function '" + currentFunction_->getName() + "' does not match its return type");
+    }
+    store(returnValues_[currentFunction_], value);
+}
+
+void TypeChecker::visit([[maybe_unused]] Break &instr) {}
+
+void TypeChecker::visit([[maybe_unused]] Continue &instr) {}
+
+void TypeChecker::visit([[maybe_unused]] InternalPrintInstr &instr) {}
@@ -0,0 +1,85 @@
+#ifndef TKOMSIUNITS_CODE_OBJECTS_TYPE_CHECKER_H_INCLUDED
+#define TKOMSIUNITS_CODE_OBJECTS_TYPE_CHECKER_H_INCLUDED
+
+#include "CodeObjectVisitor.h"
+#include "Type.h"
+#include "VarSlot.h"
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+class Program;
+class FuncDef;
+class Expression;
+class InstructionBlock;
+
+// Infers static types of expressions of Program resolved by Resolver and reports
+// type mismatches before the program is executed.
+// Types are compared regardless of unit prefixes, so a variable may hold values
+// with different prefixes at run time (e.g. [km] and [m]) - statically only the
+// unit dimensions are known in general. The type of an expression is exact (with
+// prefixes) when all values stored in the variables it refers to have identical
+// types; such expressions are calculated on raw values, without unit algebra.
+class TypeChecker : private CodeObjectVisitor {
+public:
+    static void check(Program &program);
+
+private:
+    // unknown type: calculating the expression always reports an error
+    // (reference to not-defined variable)
+    struct StaticType {
+        std::optional<Type> type;
+        bool isExact = true;
+    };
+
+    // values stored in a variable or returned from a function
+    struct Binding {
+        std::optional<Type> type;   // no value stored yet
+        bool isExact = true;        // all stored values have identical types
+    };
+
+private:
+    explicit TypeChecker(Program &program);
+
+    void checkProgram();
+    void checkFunction(FuncDef &funcDef);
+    void checkBlock(const InstructionBlock &block);
+    StaticType infer(Expression &expr);
+
+    void store(Binding &binding, const StaticType &value);
+    Binding& variableBinding(const VarSlot &slot);
+    StaticType loadVariable(const VarSlot &slot);
+    StaticType loadReturnValue(const FuncDef &funcDef);
+
+    void visit(Literal &literal) override;
+    void visit(BinaryExpression &expr) override;
+    void visit(VarReference &varRef) override;
+    void visit(codeobj::String &str) override;
+    void visit(FuncCall &funcCall) override;
+    void visit(VarDefOrAssignment &instr) override;
+    void visit(If &instr) override;
+    void visit(While &instr) override;
+    void visit(Return &instr) override;
+    void visit(Break &instr) override;
+    void visit(Continue &instr) override;
+    void visit(InternalPrintInstr &instr) override;
+
+private:
+    Program &program_;
+    // in order of names, so that the reported error does not depend on hashing
+    std::vector<FuncDef *> functions_;
+    // exactness of types is refined until no binding changes; only the final pass
+    // reports errors depending on it and annotates the code objects
+    bool isFinalPass_ = false;
+    bool hasChanged_ = false;
+    const FuncDef *currentFunction_ = nullptr;
+    bool asStatement_ = false;
+    StaticType result_;
+    std::vector<Binding> globals_;
+    std::unordered_map<std::uint32_t, Binding> locals_;
+    std::unordered_map<std::uint32_t, const Type *> paramTypes_;
+    std::unordered_map<const FuncDef *, Binding> returnValues_;
+};
+
+#endif // TKOMSIUNITS_CODE_OBJECTS_TYPE_CHECKER_H_INCLUDED
@@ -4,7 +4,10 @@
 #include "error/ErrorHandler.h"
 #include "lexer/Lexer.h"
 #include "utils/printUtils.h"
-#include <map>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <sstream>
 #include <ostream>
 
@@ -16,46 +19,126 @@ std::ostream& operator<<(std::ostream &os, const codeobj::Unit &unit);
 
 namespace codeobj {
 
+// Unit kept as an exponent of every unit type (negative exponents form the denominator)
+// and the prefix of the unit type; fixed size, so units are copied and combined without
+// allocations. Prefix of a unit type with zero exponent is always NONE.
 class Unit {
 public:
-    Unit() : isScalar_(true) {}
+    using Exponent = std::int16_t;
 
-    explicit Unit(::Unit unitToken) : isScalar_(false) {
-        numerator_.insert({ unitToken.unit, unitToken });
+public:
+    constexpr Unit() : exponents_{}, prefixes_{} {
+        for (auto &prefix : prefixes_) {
+            prefix = UnitPrefix::NONE;
+        }
+    }
+
+    constexpr explicit Unit(::Unit unitToken) : Unit() {
+        std::size_t index = static_cast<std::size_t>(unitToken.unit);
+        exponents_[index] = toExponent(unitToken.power);
+        prefixes_[index] = unitToken.prefix;
     }
 
     void combineWithUnit(Token op, const Unit &unit);
 
-    void multWithUnit(const Unit &unit) {
-        combineWithUnit(Token{TokenType::OP_MULT, "*"}, unit);
+    constexpr void multWithUnit(const Unit &unit) {
+        combine(unit, 1);
     }
-    void divWithUnit(const Unit &unit) {
-        combineWithUnit(Token{TokenType::OP_MULT, "/"}, unit);
+    constexpr void divWithUnit(const Unit &unit) {
+        combine(unit, -1);
     }
-    
-    bool isScalar() const noexcept {
-        return isScalar_;
+
+    constexpr bool isScalar() const noexcept {
+        for (auto exponent : exponents_) {
+            if (exponent != 0) {
+                return false;
+            }
+        }
+        return true;
     }
-    
+
     std::string toString() const {
         std::ostringstream os;
         os << *this;
         return os.str();
     }
-    
-    bool isAddCompatibileWith(const Unit &other) const;
+
+    constexpr bool isAddCompatibileWith(const Unit &other) const noexcept {
+        for (std::size_t i = 0; i < unitTypesCount; ++i) {
+            if (exponents_[i] != other.exponents_[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // same units with the same powers and prefixes
+    constexpr bool isIdenticalTo(const Unit &other) const noexcept {
+        for (std::size_t i = 0; i < unitTypesCount; ++i) {
+            if (exponents_[i] != other.exponents_[i] || prefixes_[i] != other.prefixes_[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    constexpr int getExponent(UnitType unitType) const noexcept {
+        return exponents_[static_cast<std::size_t>(unitType)];
+    }
+
+    constexpr UnitPrefix getPrefix(UnitType unitType) const noexcept {
+        return prefixes_[static_cast<std::size_t>(unitType)];
+    }
+
+    // value of the unit in units without prefixes, e.g. 1000 for [km], 0.001 for [1/km]
+    constexpr double getScale() const noexcept {
+        double scale = 1.0;
+        for (std::size_t i = 0; i < unitTypesCount; ++i) {
+            for (int power = exponents_[i]; power > 0; --power) {
+                scale *= prefixScale(prefixes_[i]);
+            }
+            for (int power = exponents_[i]; power < 0; ++power) {
+                scale /= prefixScale(prefixes_[i]);
+            }
+        }
+        return scale;
+    }
+
+    // keeps only the dimension of the unit
+    constexpr void clearPrefixes() noexcept {
+        for (auto &prefix : prefixes_) {
+            prefix = UnitPrefix::NONE;
+        }
+    }
 
 private:
-    void updateIsScalar();
+    // exponents out of the range of Exponent are reported instead of wrapping around
+    static constexpr Exponent toExponent(int exponent) {
+        if (exponent < std::numeric_limits<Exponent>::min() || exponent > std::numeric_limits<Exponent>::max()) {
+            ErrorHandler::handleTypeMismatch("Exponent of unit out of range");
+        }
+        return static_cast<Exponent>(exponent);
+    }
 
-    void reduceFraction();
+    // sign: 1 for multiplication, -1 for division
+    constexpr void combine(const Unit &unit, int sign) {
+        for (std::size_t i = 0; i < unitTypesCount; ++i) {
+            if (unit.exponents_[i] == 0) {
+                continue;
+            }
+            if (exponents_[i] != 0 && prefixes_[i] != unit.prefixes_[i]) {
+                ErrorHandler::handleFromParser("Cannot combine units with different prefixes");
+            }
+            exponents_[i] = toExponent(exponents_[i] + sign * unit.exponents_[i]);
+            prefixes_[i] = exponents_[i] != 0 ? unit.prefixes_[i] : UnitPrefix::NONE;
+        }
+    }
 
 private:
-    // map, not unordered_map, beceuse the elements have to be ordered
-    std::map<UnitType, ::Unit> numerator_;
-    std::map<UnitType, ::Unit> denominator_;
-    bool isScalar_;
-    
+    // indexed by UnitType, ordered as the units are printed
+    std::array<Exponent, unitTypesCount> exponents_;
+    std::array<UnitPrefix, unitTypesCount> prefixes_;
+
     friend std::ostream& ::operator<<(std::ostream &os, const Unit &unit);
 };
 
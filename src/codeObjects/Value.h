@@ -1,12 +1,15 @@
 #ifndef TKOMSIUNITS_CODE_OBJECTS_VALUE_H_INCLUDED
 #define TKOMSIUNITS_CODE_OBJECTS_VALUE_H_INCLUDED
 
-#include "Expression.h"
 #include "Type.h"
+#include "error/ErrorHandler.h"
+#include <string>
 #include <variant>
+#include <vector>
 #include <sstream>
 
-struct Value : public Expression {
+// Value of an expression calculated at run time, or of a Literal
+struct Value {
     Value(double value, Type &&type)
         : value(value), type(std::move(type)) {
         if (type.getTypeClass() != Type::NUMBER) {
@@ -17,15 +20,13 @@ struct Value : public Expression {
         : value(value), type(Type::BOOL) {}
     Value(std::string value)
         : value(std::move(value)), type(Type::STRING) {}
-        
-    Value calculate([[maybe_unused]] Interpreter &interpreter) override {
-        return *this;
-    }
-    
-    std::string getRPN() const override {
-        return toString();
+    Value(std::vector<double> values, Type &&type)
+        : value(std::move(values)), type(std::move(type)) {
+        if (this->type.getTypeClass() != Type::ARRAY) {
+            ErrorHandler::handleFromCodeObject("Array value with type not ARRAY");
+        }
     }
-    
+        
     std::string toString() const {
         std::ostringstream os;
 
@@ -35,6 +36,17 @@ struct Value : public Expression {
             if (!unit.isScalar()) {
                 os << unit;
             }
+        } else if (std::holds_alternative<std::vector<double>>(value)) {
+            os << '[';
+            const std::vector<double> &elements = asArray();
+            for (std::size_t i = 0; i < elements.size(); ++i) {
+                os << (i > 0 ? ", " : "") << elements[i];
+            }
+            os << ']';
+            const codeobj::Unit &unit = type.asUnit();
+            if (!unit.isScalar()) {
+                os << unit;
+            }
         } else if (std::holds_alternative<bool>(value)) {
             os << (asBool() ? "true" : "false");
         } else { // string
@@ -56,6 +68,14 @@ struct Value : public Expression {
         return std::get<std::string>(value);
     }
     
+    const std::vector<double>& asArray() const {
+        return std::get<std::vector<double>>(value);
+    }
+    
+    std::vector<double>& asArray() {
+        return std::get<std::vector<double>>(value);
+    }
+    
     bool operator==(const Value &other) const {
         return value == other.value && type == other.type;
     }
@@ -64,7 +84,7 @@ struct Value : public Expression {
         return !(*this == other);
     }
     
-    std::variant<double, bool, std::string> value;
+    std::variant<double, bool, std::string, std::vector<double>> value;
     Type type;
 };
 
@@ -1,24 +1,57 @@
 #include "VarDefOrAssignment.h"
 
 InstrResult VarDefOrAssignment::execute([[maybe_unused]] Interpreter &interpreter) const {
-    Value value = expr_->calculate(interpreter);
-
-    if (declaredType_) {
-        // this is variable definition
-        if (declaredType_ != value.type) {
-            ErrorHandler::handleTypeMismatch("Expression result type does not match declared variable type in variable '" + name_ + "' definition");
-        }
-        interpreter.addVariable(name_, std::move(value));
-    } else if (auto val = interpreter.getVariable(name_); !val) {
-        // this is variable definition without type declaration
-        interpreter.addVariable(name_, std::move(value));
-    } else {
-        // this is variable assignment
-        if (val->type != value.type) {
-            ErrorHandler::handleTypeMismatch("Expression result type does not match variable type in variable '" + name_ + "' assignment");
-        }
-        interpreter.assignVariable(name_, std::move(value));
+    if (assignsNumberInPlace_) {
+        storeNumber(interpreter, expr_->calculateNumber(interpreter));
+        return InstrResult::NORMAL;
     }
-    
+    store(interpreter, expr_->calculate(interpreter));
     return InstrResult::NORMAL;
 }
+
+void VarDefOrAssignment::store(Interpreter &interpreter, Value value) const {
+    if (assignsNumberInPlace_) {
+        storeNumber(interpreter, value.asDouble());
+        return;
+    }
+    auto assign = [this](std::optional<Value> &variable, Value &&newValue) {
+            if (variable->type != newValue.type) {
+                ErrorHandler::handleTypeMismatch("Expression result type does not match variable type in variable '" + name_ + "' assignment");
+            }
+            variable = std::move(newValue);
+        };
+    auto reportRedefinition = [this]() {
+            ErrorHandler::handleVariableAlreadyDefined("Variable '" + name_ + "' already defined in current scope");
+        };
+
+    if (!isTypeChecked_ && declaredType_ && declaredType_ != value.type) {
+        ErrorHandler::handleTypeMismatch("Expression result type does not match declared variable type in variable '" + name_ + "' definition");
+    }
+    switch (mode_) {
+        case Mode::DEFINE:
+            interpreter.getSlot(slot_) = std::move(value);
+            break;
+        case Mode::ASSIGN:
+            if (isTypeChecked_) {
+                interpreter.getSlot(slot_) = std::move(value);
+            } else {
+                assign(interpreter.getSlot(slot_), std::move(value));
+            }
+            break;
+        case Mode::DEFINE_OR_ASSIGN:
+            if (interpreter.isGlobalDefined(slot_.global)) {
+                assign(interpreter.getGlobalSlot(slot_.global), std::move(value));
+            } else {
+                interpreter.getLocalSlot(slot_.local) = std::move(value);
+            }
+            break;
+        case Mode::DEFINE_IF_GLOBAL:
+            if (!interpreter.isGlobalDefined(slot_.global)) {
+                reportRedefinition();
+            }
+            interpreter.getLocalSlot(slot_.local) = std::move(value);
+            break;
+        case Mode::REDEFINITION:
+            reportRedefinition();
+    }
+}
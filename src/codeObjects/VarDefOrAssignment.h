@@ -6,12 +6,25 @@
 #include "Type.h"
 #include "Value.h"
 #include "Interpreter.h"
+#include "VarSlot.h"
 #include <memory>
 #include <optional>
 #include <string>
 
 class VarDefOrAssignment : public Instruction {
 public:
+    // how the variable is stored, decided by Resolver
+    enum class Mode {
+        DEFINE,
+        ASSIGN,
+        // in function body: assign global variable if it is defined, define local otherwise
+        DEFINE_OR_ASSIGN,
+        // in function body: define local variable if previous definition in the current scope
+        // assigned global variable, otherwise report redefinition
+        DEFINE_IF_GLOBAL,
+        REDEFINITION
+    };
+
     VarDefOrAssignment(const std::string &name,
         std::unique_ptr<Expression> expr,
         std::optional<Type> declatedType
@@ -22,6 +35,14 @@ public:
     
     InstrResult execute([[maybe_unused]] Interpreter &interpreter) const override;
     
+    // defines or assigns the variable with already calculated expression value
+    void store(Interpreter &interpreter, Value value) const;
+    
+    // assigns the number in place, when assignsNumberInPlace()
+    void storeNumber(Interpreter &interpreter, double value) const {
+        std::get<double>(interpreter.getSlot(slot_)->value) = value;
+    }
+    
     const std::string& getInstrType() const {
         static const std::string INSTR_TYPE = "VarDefOrAssignment";
         return INSTR_TYPE;
@@ -31,10 +52,53 @@ public:
         return name_;
     }
     
+    Expression& getExpr() const {
+        return *expr_;
+    }
+    
+    const std::optional<Type>& getDeclaredType() const {
+        return declaredType_;
+    }
+    
+    const VarSlot& getSlot() const {
+        return slot_;
+    }
+    
+    Mode getMode() const {
+        return mode_;
+    }
+    
+    void setTarget(VarSlot slot, Mode mode) {
+        slot_ = slot;
+        mode_ = mode;
+    }
+    
+    // set by TypeChecker: types of the definition or assignment were checked statically
+    // (except assignment of global variable from function body); assignsNumberInPlace
+    // when the variable always holds a number of the exact type of the expression
+    void setTypeChecked(bool assignsNumberInPlace) {
+        isTypeChecked_ = true;
+        assignsNumberInPlace_ = assignsNumberInPlace;
+    }
+    
+    bool assignsNumberInPlace() const {
+        return assignsNumberInPlace_;
+    }
+    
+    void accept(CodeObjectVisitor &visitor) override {
+        visitor.visit(*this);
+    }
+    
 private:
     std::string name_;
     std::unique_ptr<Expression> expr_;
     std::optional<Type> declaredType_;
+    VarSlot slot_;
+    Mode mode_ = Mode::DEFINE;
+    bool isTypeChecked_ = false;
+    bool assignsNumberInPlace_ = false;
+
+    friend class ConstantFolder;
 };
 
 #endif // TKOMSIUNITS_CODE_OBJECTS_VAR_DEF_H_INCLUDED
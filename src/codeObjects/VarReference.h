@@ -4,6 +4,7 @@
 #include "Expression.h"
 #include "Value.h"
 #include "Interpreter.h"
+#include "VarSlot.h"
 #include <string>
 
 class VarReference : public Expression {
@@ -15,20 +16,45 @@ public:
         return INSTR_TYPE;
     }
     
-    Value calculate([[maybe_unused]] Interpreter &interpreter) override {
-        return interpreter.getVariableOrError(name_);
+    Value calculate([[maybe_unused]] Interpreter &interpreter) const override {
+        return interpreter.getVariable(slot_, name_);
+    }
+    
+    const Value& calculateRef(Interpreter &interpreter, [[maybe_unused]] std::optional<Value> &temporary) const override {
+        return interpreter.getVariable(slot_, name_);
+    }
+    
+    double calculateNumber([[maybe_unused]] Interpreter &interpreter) const override {
+        return interpreter.getVariable(slot_, name_).asDouble();
+    }
+    
+    bool calculateBool([[maybe_unused]] Interpreter &interpreter) const override {
+        return interpreter.getVariable(slot_, name_).asBool();
     }
     
     const std::string& getName() const {
         return name_;
     }
     
+    const VarSlot& getSlot() const {
+        return slot_;
+    }
+    
+    void setSlot(VarSlot slot) {
+        slot_ = slot;
+    }
+    
     std::string getRPN() const override {
         return name_;
     }
     
+    void accept(CodeObjectVisitor &visitor) override {
+        visitor.visit(*this);
+    }
+    
 private:
     std::string name_;
+    VarSlot slot_;
 };
 
 #endif // TKOMSIUNITS_CODE_OBJECTS_VAR_REFERENCE_H_INCLUDED
@@ -0,0 +1,23 @@
+#ifndef TKOMSIUNITS_CODE_OBJECTS_VAR_SLOT_H_INCLUDED
+#define TKOMSIUNITS_CODE_OBJECTS_VAR_SLOT_H_INCLUDED
+
+#include <cstdint>
+
+// Location of a variable assigned by Resolver: index into the frame of the current
+// function call context (local) and/or into the global frame.
+struct VarSlot {
+    enum Kind : std::uint8_t {
+        UNRESOLVED,         // variable is not defined at this point of program
+        LOCAL,
+        GLOBAL,             // may be not defined yet when referenced from function body
+        GLOBAL_OR_LOCAL     // in function body: global if it is defined, local otherwise
+    };
+
+    Kind kind = UNRESOLVED;
+    std::uint32_t local = 0;
+    std::uint32_t global = 0;
+    // identifies the local variable definition in the whole program (for static analyses)
+    std::uint32_t binding = 0;
+};
+
+#endif // TKOMSIUNITS_CODE_OBJECTS_VAR_SLOT_H_INCLUDED
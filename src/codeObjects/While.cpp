@@ -1,12 +1,9 @@
 #include "While.h"
 
 InstrResult While::execute([[maybe_unused]] Interpreter &interpreter) const {
+    // condition type is checked by TypeChecker
     auto calcCond = [&interpreter, cond = cond_.get()]() {
-            Value condResult = cond->calculate(interpreter);
-            if (condResult.type.getTypeClass() != Type::BOOL) {
-                ErrorHandler::handleTypeMismatch("Expression used as While condition must result in bool value");
-            }
-            return condResult.asBool();
+            return cond->calculateBool(interpreter);
         };
     auto notBreakOrReturn = [](InstrResult result) {
             switch (result) {
@@ -19,7 +16,8 @@ InstrResult While::execute([[maybe_unused]] Interpreter &interpreter) const {
         };
     InstrResult result = InstrResult::NORMAL;
 
-    for (bool cond = calcCond(); cond && notBreakOrReturn(result); cond = calcCond()) {
+    // condition is not evaluated again after the body breaks or returns
+    while (notBreakOrReturn(result) && calcCond()) {
         result = body_->execute(interpreter);
     }
     
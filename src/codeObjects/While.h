@@ -23,10 +23,24 @@ public:
         static const std::string INSTR_TYPE = "While";
         return INSTR_TYPE;
     }
+    
+    void accept(CodeObjectVisitor &visitor) override {
+        visitor.visit(*this);
+    }
+    
+    Expression& getCond() const {
+        return *cond_;
+    }
+    
+    InstructionBlock& getBody() const {
+        return *body_;
+    }
 
 private:
     std::unique_ptr<Expression> cond_;
     std::unique_ptr<InstructionBlock> body_;
+
+    friend class ConstantFolder;
 };
 
 #endif // TKOMSIUNITS_CODE_OBJECTS_WHILE_H_INCLUDED
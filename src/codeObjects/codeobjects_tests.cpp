@@ -1,6 +1,11 @@
 #include "Program.h"
 #include "FuncDef.h"
 #include "Unit.h"
+#include "BinaryExpression.h"
+#include "Literal.h"
+#include "NodeArena.h"
+#include "Return.h"
+#include <limits>
 #include <memory>
 #include <gtest/gtest.h>
 
@@ -33,3 +38,80 @@ TEST(CodeObjectsTests, ProgramWithDuplicateFunctionNamesThrows) {
         std::runtime_error
     );
 }
+
+TEST(CodeObjectsTests, UnitCombinationReducesFractionAndChecksPrefixes) {
+    codeobj::Unit speed(Unit{ UnitPrefix::KILO, UnitType::METER, 1 });
+    speed.divWithUnit(codeobj::Unit(Unit{ UnitPrefix::NONE, UnitType::SECOND, 1 }));
+    EXPECT_EQ("[(km)/(s)]", speed.toString());
+
+    codeobj::Unit distance = speed;
+    distance.multWithUnit(codeobj::Unit(Unit{ UnitPrefix::NONE, UnitType::SECOND, 2 }));
+    EXPECT_EQ("[(s*km)/()]", distance.toString());
+    distance.divWithUnit(codeobj::Unit(Unit{ UnitPrefix::NONE, UnitType::SECOND, 1 }));
+    EXPECT_TRUE(distance.isIdenticalTo(codeobj::Unit(Unit{ UnitPrefix::KILO, UnitType::METER, 1 })));
+    distance.divWithUnit(codeobj::Unit(Unit{ UnitPrefix::KILO, UnitType::METER, 1 }));
+    EXPECT_TRUE(distance.isScalar());
+
+    EXPECT_THROW({
+            speed.multWithUnit(codeobj::Unit(Unit{ UnitPrefix::NONE, UnitType::METER, 1 }));
+        },
+        std::runtime_error
+    );
+}
+
+TEST(CodeObjectsTests, UnitExponentsDoNotWrapAround) {
+    codeobj::Unit volume(Unit{ UnitPrefix::NONE, UnitType::METER, 3 });
+    codeobj::Unit power = volume;
+    for (int i = 1; i < 45; ++i) {
+        power.multWithUnit(volume);
+    }
+    EXPECT_EQ(135, power.getExponent(UnitType::METER));
+    EXPECT_EQ("[(m135)/()]", power.toString());
+
+    constexpr int maxExponent = std::numeric_limits<codeobj::Unit::Exponent>::max();
+    codeobj::Unit largest(Unit{ UnitPrefix::NONE, UnitType::METER, maxExponent });
+    EXPECT_THROW(largest.multWithUnit(codeobj::Unit(Unit{ UnitPrefix::NONE, UnitType::METER, 1 })), std::runtime_error);
+    EXPECT_THROW(largest.divWithUnit(codeobj::Unit(Unit{ UnitPrefix::NONE, UnitType::METER, -maxExponent })), std::runtime_error);
+    EXPECT_THROW(codeobj::Unit(Unit{ UnitPrefix::NONE, UnitType::METER, maxExponent + 1 }), std::runtime_error);
+}
+
+TEST(CodeObjectsTests, BinaryExpressionResolvesOperatorOnConstruction) {
+    BinaryExpression expr(std::make_unique<Literal>(Value(1.0, Type(codeobj::Unit()))),
+            Token{ TokenType::OP_REL, "<=" },
+            std::make_unique<Literal>(Value(2.0, Type(codeobj::Unit())))
+        );
+    EXPECT_EQ(BinaryExpression::Operator::LESS_THAN_OR_EQUAL, expr.getOperatorKind());
+    EXPECT_EQ("<=", expr.getOperator());
+
+    EXPECT_THROW({
+            BinaryExpression unknown(std::make_unique<Literal>(Value(true)), Token{ TokenType::OP_REL, "<>" }, std::make_unique<Literal>(Value(false)));
+        },
+        std::runtime_error
+    );
+}
+
+TEST(CodeObjectsTests, CodeObjectsAreAllocatedInActiveNodeArena) {
+    auto arena = std::make_unique<NodeArena>();
+    const Value one(1.0, Type(codeobj::Unit()));
+    std::unique_ptr<Expression> outside = std::make_unique<Literal>(one);
+    std::vector<std::unique_ptr<Instruction>> instructions;
+    {
+        NodeArena::Scope scope(*arena);
+        std::unique_ptr<Expression> first = std::make_unique<Literal>(one);
+        std::unique_ptr<Expression> second = std::make_unique<Literal>(one);
+        EXPECT_LT(first.get(), second.get());
+        std::size_t allocatedSize = arena->getAllocatedSize();
+        EXPECT_GE(allocatedSize, 2 * sizeof(Literal));
+        instructions.push_back(std::make_unique<Return>(std::make_unique<BinaryExpression>(
+                std::move(first), Token{ TokenType::OP_ADD, "+" }, std::move(second)
+            )));
+        EXPECT_GT(arena->getAllocatedSize(), allocatedSize);
+    }
+    std::size_t allocatedSize = arena->getAllocatedSize();
+    outside = std::make_unique<Literal>(one);
+    EXPECT_EQ(allocatedSize, arena->getAllocatedSize());
+    // the program owns the arena and destroys its code objects before it; the folded
+    // constant replacing the expression is allocated on the heap
+    Program program({}, std::move(instructions), std::move(arena));
+    EXPECT_EQ("2", dynamic_cast<Return &>(*program.getInstructions().getInstructions().front()).getExpr()->getRPN());
+}
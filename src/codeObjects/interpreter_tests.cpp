@@ -2,18 +2,24 @@
 #include "Interpreter.h"
 #include "Value.h"
 #include "BinaryExpression.h"
+#include "Literal.h"
+#include "VarDefOrAssignment.h"
+#include "Return.h"
+#include "FuncDef.h"
 #include "source/StringSource.h"
 #include "lexer/Lexer.h"
 #include "parser/Parser.h"
+#include <limits>
 #include <memory>
+#include <tuple>
 #include <gtest/gtest.h>
 #include <iostream>
 
 TEST(InterpreterTests, ExpressionSingleValueCalculate) {
     Program dummyProgram({}, {});
     Interpreter dummyInterp(std::cout, dummyProgram);
-    Unit unit{ "m", UnitType::METER, 2 };
-    std::unique_ptr<Expression> expr = std::make_unique<Value>(5.0, Type(codeobj::Unit(unit)));
+    Unit unit{ UnitPrefix::MILLI, UnitType::METER, 2 };
+    std::unique_ptr<Expression> expr = std::make_unique<Literal>(Value(5.0, Type(codeobj::Unit(unit))));
     Value result = expr->calculate(dummyInterp);
     ASSERT_EQ(Type::NUMBER, result.type.getTypeClass());
     EXPECT_EQ("5[(mm2)/()]", result.toString());
@@ -23,9 +29,9 @@ TEST(InterpreterTests, ExpressionSingleValueCalculate) {
 TEST(InterpreterTests, SimpleExpressionCalculate) {
     Program dummyProgram({}, {});
     Interpreter dummyInterp(std::cout, dummyProgram);
-    Unit unit{ "", UnitType::METER, 1 };
-    auto val1 = std::make_unique<Value>(3.5, Type(codeobj::Unit(unit)));
-    auto val2 = std::make_unique<Value>(5.0, Type(codeobj::Unit(unit)));
+    Unit unit{ UnitPrefix::NONE, UnitType::METER, 1 };
+    auto val1 = std::make_unique<Literal>(Value(3.5, Type(codeobj::Unit(unit))));
+    auto val2 = std::make_unique<Literal>(Value(5.0, Type(codeobj::Unit(unit))));
     std::unique_ptr<Expression> expr = std::make_unique<BinaryExpression>(
             std::move(val1), Token{TokenType::OP_ADD, "-"}, std::move(val2)
         );
@@ -36,7 +42,7 @@ TEST(InterpreterTests, SimpleExpressionCalculate) {
 }
 
 TEST(InterpreterTests, VarDefinition) {
-    Unit resultUnit{ "", UnitType::METER, 1 };
+    Unit resultUnit{ UnitPrefix::NONE, UnitType::METER, 1 };
     std::string varName = "a";
     std::string input = varName + " = 1[m] + 5[m] - 3[m]\n";
     std::unique_ptr<Source> src = std::make_unique<StringSource>(input);
@@ -49,7 +55,7 @@ TEST(InterpreterTests, VarDefinition) {
 }
 
 TEST(InterpreterTests, VarDefinitionWithTypeDecl) {
-    Unit resultUnit{ "", UnitType::SECOND, 2 };
+    Unit resultUnit{ UnitPrefix::NONE, UnitType::SECOND, 2 };
     std::string varName = "a";
     std::string input = varName + "[s2] = 1[s2] + 5[s2] - 3[s2]\n";
     std::unique_ptr<Source> src = std::make_unique<StringSource>(input);
@@ -62,7 +68,7 @@ TEST(InterpreterTests, VarDefinitionWithTypeDecl) {
 }
 
 TEST(InterpreterTests, VarAssignment) {
-    Unit resultUnit{ "", UnitType::METER, 1 };
+    Unit resultUnit{ UnitPrefix::NONE, UnitType::METER, 1 };
     std::string varName = "a";
     std::string input = varName + " = 1[m] + 5[m] - 3[m]\n" +
                         varName + " = 45[m]\n";
@@ -76,7 +82,7 @@ TEST(InterpreterTests, VarAssignment) {
 }
 
 TEST(InterpreterTests, IfTrue) {
-    Unit resultUnit{ "", UnitType::METER, 1 };
+    Unit resultUnit{ UnitPrefix::NONE, UnitType::METER, 1 };
     std::string input = "if true { a = 5[m]\n } else { a = 0\n }\n";
     std::unique_ptr<Source> src = std::make_unique<StringSource>(input);
     Lexer lexer(*src);
@@ -381,3 +387,389 @@ TEST(InterpreterTests, AllOperators) {
     int result = interp.executeProgram();
     EXPECT_EQ(5, result);
 }
+
+TEST(InterpreterTests, FunctionAssignsGlobalIfDefinedOtherwiseDefinesLocal) {
+    std::string input =
+        "func setX () {"
+        "    x = 5\n"
+        "    print(\"in setX {x}\")\n"
+        "}\n"
+        "setX()\n"
+        "x = 1\n"
+        "print(\"global {x}\")\n"
+        "setX()\n"
+        "print(\"global {x}\")\n";
+    std::string expectedOutput = "in setX 5\nglobal 1\nin setX 5\nglobal 5\n";
+    std::stringstream testStdout;
+    std::unique_ptr<Source> src = std::make_unique<StringSource>(input);
+    Lexer lexer(*src);
+    Parser parser(lexer);
+    std::unique_ptr<Program> program = parser.parse();
+    Interpreter interp(testStdout,  *program.get());
+    int result = interp.executeProgram();
+    EXPECT_EQ(0, result);
+    EXPECT_EQ(expectedOutput, testStdout.str());
+}
+
+TEST(InterpreterTests, BlockVariablesAreNotVisibleAfterBlock) {
+    std::string input =
+        "if true { a = 5[m]\n }\n"
+        "if true { b = 3\n }\n"
+        "a = 2\n"
+        "return a\n";
+    std::unique_ptr<Source> src = std::make_unique<StringSource>(input);
+    Lexer lexer(*src);
+    Parser parser(lexer);
+    std::unique_ptr<Program> program = parser.parse();
+    Interpreter interp(std::cout,  *program.get());
+    int result = interp.executeProgram();
+    EXPECT_EQ(2, result);
+}
+
+TEST(InterpreterTests, WhileBodyDefinesVariablesOnEachIteration) {
+    std::string input =
+        "i = 0\n"
+        "while i < 3 {"
+        "    if i == 1 { i = i + 1\n continue\n }\n"
+        "    step[1] = 1\n"
+        "    i = i + step\n"
+        "}\n"
+        "return i\n";
+    std::unique_ptr<Source> src = std::make_unique<StringSource>(input);
+    Lexer lexer(*src);
+    Parser parser(lexer);
+    std::unique_ptr<Program> program = parser.parse();
+    Interpreter interp(std::cout,  *program.get());
+    int result = interp.executeProgram();
+    EXPECT_EQ(3, result);
+}
+
+TEST(InterpreterTests, TypedRedefinitionInSameScopeFails) {
+    std::string input =
+        "a[m] = 1[m]\n"
+        "if true { a[s] = 2[s]\n }\n"
+        "a[m] = 2[m]\n";
+    std::unique_ptr<Source> src = std::make_unique<StringSource>(input);
+    Lexer lexer(*src);
+    Parser parser(lexer);
+    std::unique_ptr<Program> program = parser.parse();
+    Interpreter interp(std::cout,  *program.get());
+    int result = interp.executeProgram();
+    EXPECT_EQ(1, result);
+}
+
+TEST(InterpreterTests, TypeMismatchIsReportedBeforeExecution) {
+    std::string inputs[] = {
+        "print(\"before\")\n a = 1[m] + 1[s]\n",
+        "func f () { }\n if false { a = f()\n }\n",
+        "func f (a [m]) -> [m] { return a * a\n }\n",
+        "while 1[m] { }\n",
+        "a = 1[km]\n b = a * 1[m]\n"
+    };
+    for (auto &&input : inputs) {
+        std::unique_ptr<Source> src = std::make_unique<StringSource>(input);
+        Lexer lexer(*src);
+        Parser parser(lexer);
+        EXPECT_THROW({
+                std::unique_ptr<Program> program = parser.parse();
+            },
+            std::runtime_error
+        );
+    }
+}
+
+TEST(InterpreterTests, UnitPrefixesOfVariablesAreKeptAtRunTime) {
+    std::string input =
+        "i = 0[m]\n"
+        "while i < 3[m] { i = i + 1[m]\n }\n"
+        "area = i * i\n"
+        "a = 1[km]\n"
+        "a = 5[m]\n"
+        "b = a * area\n"
+        "print(\"{i} {area} {b}\")\n";
+    std::string expectedOutput = "3[(m)/()] 9[(m2)/()] 45[(m3)/()]\n";
+    std::stringstream testStdout;
+    std::unique_ptr<Source> src = std::make_unique<StringSource>(input);
+    Lexer lexer(*src);
+    Parser parser(lexer);
+    std::unique_ptr<Program> program = parser.parse();
+    Interpreter interp(testStdout,  *program.get());
+    int result = interp.executeProgram();
+    EXPECT_EQ(0, result);
+    EXPECT_EQ(expectedOutput, testStdout.str());
+}
+
+TEST(InterpreterTests, LogicOperatorsDoNotCalculateDecidedRightOperand) {
+    std::string input =
+        "func check (x [1]) -> [bool] {"
+        "    print(\"check {x}\")\n"
+        "    return x > 0\n"
+        "}\n"
+        "a = false && check(1)\n"
+        "b = true || check(2)\n"
+        "c = true && check(3)\n"
+        "d = false || check(4)\n"
+        "if check(0) && check(5) || check(6) {"
+        "    print(\"then\")\n"
+        "}\n"
+        "print(\"{a} {b} {c} {d}\")\n";
+    std::string expectedOutput = "check 3\ncheck 4\ncheck 0\ncheck 6\nthen\nfalse true true true\n";
+    std::stringstream testStdout;
+    std::unique_ptr<Source> src = std::make_unique<StringSource>(input);
+    Lexer lexer(*src);
+    Parser parser(lexer);
+    std::unique_ptr<Program> program = parser.parse();
+    Interpreter interp(testStdout,  *program.get());
+    int result = interp.executeProgram();
+    EXPECT_EQ(0, result);
+    EXPECT_EQ(expectedOutput, testStdout.str());
+}
+
+TEST(InterpreterTests, ConstantExpressionsAreFoldedBeforeExecution) {
+    std::string input =
+        "a = 2[km] * 3[km] + 1[km2]\n"
+        "b = a * (4[s] / 2[s]) - a\n"
+        "c = false && b > a\n"
+        "print(\"{a} is {b}, \")\n"
+        "return 2 * 3 - 1\n";
+    std::unique_ptr<Source> src = std::make_unique<StringSource>(input);
+    Lexer lexer(*src);
+    Parser parser(lexer);
+    std::unique_ptr<Program> program = parser.parse();
+    const auto &instructions = program->getInstructions().getInstructions();
+    auto rpn = [&instructions](std::size_t i) {
+        if (auto *ret = dynamic_cast<Return *>(instructions[i].get())) {
+            return ret->getExpr()->getRPN();
+        }
+        return dynamic_cast<VarDefOrAssignment &>(*instructions[i]).getExpr().getRPN();
+    };
+    EXPECT_EQ("7[(km2)/()]", rpn(0));
+    EXPECT_EQ("a2*a-", rpn(1));
+    EXPECT_EQ("false", rpn(2));
+    EXPECT_EQ("5", rpn(4));
+    std::stringstream testStdout;
+    Interpreter interp(testStdout, *program.get());
+    EXPECT_EQ(5, interp.executeProgram());
+    EXPECT_EQ("7[(km2)/()] is 7[(km2)/()], \n", testStdout.str());
+}
+
+TEST(InterpreterTests, CallOfUndefinedFunctionIsReportedBeforeExecution) {
+    std::vector<std::string> inputs {
+        "print(\"before\")\n undefinedFunc(1)\n",
+        "if false { a = undefinedFunc()\n }\n",
+        "func f () { undefinedFunc()\n }\n"
+    };
+    for (const auto &input : inputs) {
+        std::unique_ptr<Source> src = std::make_unique<StringSource>(input);
+        Lexer lexer(*src);
+        Parser parser(lexer);
+        EXPECT_THROW(parser.parse(), std::runtime_error) << "not met for: " << input;
+    }
+}
+
+TEST(InterpreterTests, MemoizationReusesResultsOfPureFunctionsOnly) {
+    std::string input =
+        "func fibonacci (steps [1]) -> [m] {"
+        "    if steps < 2 {"
+        "        return steps * 1[m]\n"
+        "    }\n"
+        "    return fibonacci(steps - 1) + fibonacci(steps - 2)\n"
+        "}\n"
+        "func logged (x [km]) -> [km] {"
+        "    print(\"logged {x}\")\n"
+        "    return x\n"
+        "}\n"
+        "offset = 1[km]\n"
+        "func shifted (x [km]) -> [km] {"
+        "    return x + offset\n"
+        "}\n"
+        "a = logged(1[km]) + logged(1[km])\n"
+        "b = shifted(1[km])\n"
+        "offset = 2[km]\n"
+        "b = shifted(1[km]) - b\n"
+        "c = fibonacci(80)\n"
+        "print(\"{a} {b} {c}\")\n";
+    std::stringstream testStdout;
+    std::unique_ptr<Source> src = std::make_unique<StringSource>(input);
+    Lexer lexer(*src);
+    Parser parser(lexer);
+    std::unique_ptr<Program> program = parser.parse();
+    EXPECT_TRUE(program->getFuncDef("fibonacci")->isPure());
+    EXPECT_FALSE(program->getFuncDef("logged")->isPure());
+    EXPECT_FALSE(program->getFuncDef("shifted")->isPure());
+    Interpreter interp(testStdout, *program.get());
+    interp.setMemoization(true);
+    EXPECT_EQ(0, interp.executeProgram());
+    EXPECT_EQ("logged 1[(km)/()]\nlogged 1[(km)/()]\n2[(km)/()] 1[(km)/()] 2.34167e+16[(m)/()]\n", testStdout.str());
+}
+
+TEST(InterpreterTests, MemoizedCallsAreFoundByBitsOfArgumentsAndBounded) {
+    StringSource src("func square (x [1]) -> [1] {\n    return x * x\n}\n");
+    Lexer lexer(src);
+    Parser parser(lexer);
+    std::unique_ptr<Program> program = parser.parse();
+    const FuncDef &square = *program->getFuncDef("square");
+    std::stringstream testStdout;
+    Interpreter interp(testStdout, *program.get());
+    auto args = [](double x) {
+        return std::vector<Value>{ Value(x, Type(codeobj::Unit())) };
+    };
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    interp.memoize(square, args(nan), Value(nan, Type(codeobj::Unit())));
+    EXPECT_NE(nullptr, interp.findMemoized(square, args(nan)));
+    interp.memoize(square, args(0.0), Value(0.0, Type(codeobj::Unit())));
+    EXPECT_EQ(nullptr, interp.findMemoized(square, args(-0.0)));
+
+    // calls with ever new arguments do not grow the table without bound
+    for (std::size_t i = 0; i <= Interpreter::MAX_MEMOIZED_CALLS; ++i) {
+        interp.memoize(square, args(static_cast<double>(i) + 0.5), std::nullopt);
+    }
+    EXPECT_EQ(nullptr, interp.findMemoized(square, args(0.5)));
+    EXPECT_NE(nullptr, interp.findMemoized(square, args(Interpreter::MAX_MEMOIZED_CALLS + 0.5)));
+}
+
+TEST(InterpreterTests, TailCallsDoNotGrowCallStack) {
+    // recursion this deep overflows the native stack without tail calls
+    std::string input =
+        "func sum (n [1], acc [m]) -> [m] {"
+        "    if n == 0 {"
+        "        return acc\n"
+        "    }\n"
+        "    return sum(n - 1, acc + 1[m])\n"
+        "}\n"
+        "func isEven (n [1]) -> [bool] {"
+        "    if n == 0 {"
+        "        return true\n"
+        "    }\n"
+        "    return isOdd(n - 1)\n"
+        "}\n"
+        "func isOdd (n [1]) -> [bool] {"
+        "    if n == 0 {"
+        "        return false\n"
+        "    }\n"
+        "    return isEven(n - 1)\n"
+        "}\n"
+        "a = sum(200 000, 0[m])\n"
+        "b = isEven(100 001)\n"
+        "print(\"{a} {b}\")\n"
+        "return sum(3, 0[m]) / 1[m]\n";
+    std::stringstream testStdout;
+    std::unique_ptr<Source> src = std::make_unique<StringSource>(input);
+    Lexer lexer(*src);
+    Parser parser(lexer);
+    std::unique_ptr<Program> program = parser.parse();
+    const auto &sumBody = program->getFuncDef("sum")->getBody().getInstructions();
+    EXPECT_NE(nullptr, dynamic_cast<Return &>(*sumBody.back()).getTailCall());
+    const auto &instructions = program->getInstructions().getInstructions();
+    EXPECT_EQ(nullptr, dynamic_cast<Return &>(*instructions.back()).getTailCall());
+    Interpreter interp(testStdout, *program.get());
+    EXPECT_EQ(3, interp.executeProgram());
+    EXPECT_EQ("200000[(m)/()] false\n", testStdout.str());
+}
+
+TEST(InterpreterTests, CallsDeeperThanMaxCallDepthAreReported) {
+    std::string input =
+        "func depth (n [1]) -> [1] {"
+        "    if n == 0 {"
+        "        return 0\n"
+        "    }\n"
+        "    return depth(n - 1) + 1\n"
+        "}\n"
+        "print(\"start\")\n"
+        "return depth(limit)\n";
+    auto run = [&input](int limit, std::size_t maxCallDepth) {
+        std::unique_ptr<Source> src = std::make_unique<StringSource>("limit = " + std::to_string(limit) + "\n" + input);
+        Lexer lexer(*src);
+        Parser parser(lexer);
+        std::unique_ptr<Program> program = parser.parse();
+        std::stringstream testStdout;
+        Interpreter interp(testStdout, *program.get());
+        interp.setMaxCallDepth(maxCallDepth);
+        int firstResult = interp.executeProgram();
+        // state of the interpreter is cleaned up after the error
+        EXPECT_EQ(firstResult, interp.executeProgram());
+        EXPECT_EQ(0u, interp.getCallDepth());
+        return std::make_pair(firstResult, testStdout.str());
+    };
+    EXPECT_EQ(std::make_pair(100, std::string("start\nstart\n")), run(100, 101));
+    EXPECT_EQ(std::make_pair(1, std::string("start\nstart\n")), run(100, 100));
+    EXPECT_EQ(2500, run(2500, Interpreter::DEFAULT_MAX_CALL_DEPTH).first);
+}
+
+TEST(InterpreterTests, ArraysAreCalculatedElementWise) {
+    std::string input =
+        "func kinetic (mass [kg], v [array m/s]) -> [array kg*m2/s2] {\n"
+        "    return mass * v * v / 2\n"
+        "}\n"
+        "xs = [1, 2.5, -4][m]\n"
+        "ts = [0.5, 1, 2][s]\n"
+        "speeds = xs / ts\n"
+        "energy = kinetic(2[kg], speeds)\n"
+        "isFast = speeds > 1[m/s]\n"
+        "shifted [array m] = 1[km] - xs\n"
+        "none = [][s]\n"
+        "print(\"{speeds} {energy} {isFast} {shifted} {none}\")\n";
+    std::stringstream testStdout;
+    StringSource src(input);
+    Lexer lexer(src);
+    Parser parser(lexer);
+    std::unique_ptr<Program> program = parser.parse();
+    Interpreter interp(testStdout, *program.get());
+    EXPECT_EQ(0, interp.executeProgram());
+    EXPECT_EQ("[2, 2.5, -2][(m)/(s)] [4, 6.25, 4][(kg*m2)/(s2)] [1, 1, 0] [0, -1.5, 5][(km)/()] [][(s)/()]\n", testStdout.str());
+}
+
+TEST(InterpreterTests, UnitsOfArraysAreChecked) {
+    auto parse = [](const std::string &input) {
+        StringSource src(input);
+        Lexer lexer(src);
+        Parser parser(lexer);
+        return parser.parse();
+    };
+    EXPECT_THROW(parse("a = [1, 2][m] + [1, 2][s]\n"), std::runtime_error);
+    EXPECT_THROW(parse("a = [1, 2][m] + 1\n"), std::runtime_error);
+    EXPECT_THROW(parse("a = [1, 2][m] && true\n"), std::runtime_error);
+    EXPECT_THROW(parse("if [1] > 0 {\n}\n"), std::runtime_error);
+    EXPECT_THROW(parse("a [array s] = [1, 2][m]\n"), std::runtime_error);
+    EXPECT_THROW(parse("a [m] = [1, 2][m]\n"), std::runtime_error);
+
+    // lengths of arrays are known only at run time
+    std::unique_ptr<Program> program = parse("a = [1, 2][m]\nb = [1, 2, 3][m]\nc = a + b\n");
+    std::stringstream testStdout;
+    std::ostringstream testStderr;
+    Interpreter interp(testStdout, *program.get());
+    interp.setErrorStream(testStderr);
+    EXPECT_EQ(1, interp.executeProgram());
+    EXPECT_NE("", testStderr.str());
+
+    // also of constant arrays, which are not folded then; code not executed does not fail
+    for (auto [input, exitStatus, expectedStdout] : {
+            std::tuple{ "print(\"start\")\nif false {\n  x = [1, 2][m] + [1, 2, 3][m]\n}\n", 0, "start\n" },
+            std::tuple{ "print(\"start\")\nx = [1, 2][m] + [1, 2, 3][m]\nprint(\"end\")\n", 1, "start\n" } }) {
+        std::unique_ptr<Program> constantProgram = parse(input);
+        std::stringstream constantStdout;
+        std::ostringstream constantStderr;
+        Interpreter constantInterp(constantStdout, *constantProgram.get());
+        constantInterp.setErrorStream(constantStderr);
+        EXPECT_EQ(exitStatus, constantInterp.executeProgram()) << "not met for: " << input;
+        EXPECT_EQ(expectedStdout, constantStdout.str()) << "not met for: " << input;
+        EXPECT_EQ(exitStatus != 0, !constantStderr.str().empty()) << "not met for: " << input;
+    }
+}
+
+TEST(InterpreterTests, HighPowersOfUnitsAreKept) {
+    std::string input = "a = 2[m3]\nb = a";
+    for (int i = 1; i < 45; ++i) {
+        input += " * a";
+    }
+    input += "\nprint(\"{b}\")\n";
+    StringSource src(input);
+    Lexer lexer(src);
+    Parser parser(lexer);
+    std::unique_ptr<Program> program = parser.parse();
+    std::stringstream testStdout;
+    Interpreter interp(testStdout, *program.get());
+    EXPECT_EQ(0, interp.executeProgram());
+    EXPECT_EQ("3.51844e+13[(m135)/()]\n", testStdout.str());
+}
@@ -30,6 +30,18 @@ public:
         throw std::runtime_error(os.str());
     }
 
+    [[noreturn]] static void handleFromCache(const std::string &msg) {
+        std::ostringstream os;
+        os << "Cache error: " << msg;
+        throw std::runtime_error(os.str());
+    }
+
+    [[noreturn]] static void handleFromTable(const std::string &msg) {
+        std::ostringstream os;
+        os << "Table error: " << msg;
+        throw std::runtime_error(os.str());
+    }
+
     [[noreturn]] static void handleTypeMismatch(const std::string &msg) {
         std::ostringstream os;
         os << "Type Mismatch error: " << msg;
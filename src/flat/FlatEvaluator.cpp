@@ -0,0 +1,253 @@
+#include "FlatEvaluator.h"
+
+#include "codeObjects/Program.h"
+#include "codeObjects/VarDefOrAssignment.h"
+#include "error/ErrorHandler.h"
+#include <string>
+#include <utility>
+
+int FlatEvaluator::execute() {
+    return interpreter_.executeProgram([this]() { return run(); });
+}
+
+int FlatEvaluator::run() {
+    tailCall_.reset();
+    return tree_.program->finish(interpreter_, executeBlock(tree_.main));
+}
+
+InstrResult FlatEvaluator::executeNode(NodeIndex node) {
+    switch (tree_.kinds[node]) {
+        case NodeKind::CALL:
+            call(tree_.operands[node], calculateArgs(node));
+            return InstrResult::NORMAL;
+        case NodeKind::TAIL_CALL:
+            tailCall_.emplace(TailCall{ tree_.operands[node], calculateArgs(node) });
+            return InstrResult::RETURN;
+        case NodeKind::STORE:
+            tree_.assignments[tree_.operands[node]]->store(interpreter_, calculate(tree_.first[node]));
+            return InstrResult::NORMAL;
+        case NodeKind::STORE_NUMBER:
+            tree_.assignments[tree_.operands[node]]->storeNumber(interpreter_, calculateNumber(tree_.first[node]));
+            return InstrResult::NORMAL;
+        case NodeKind::BLOCK:
+            return executeBlock(node);
+        case NodeKind::IF:
+            // else-if chain is walked in a loop; condition type is checked by TypeChecker
+            for (NodeIndex branch = node; branch != NO_NODE; branch = tree_.operands[branch]) {
+                NodeIndex cond = tree_.first[branch];
+                if (cond == NO_NODE || calculateBool(cond)) {
+                    return executeBlock(tree_.second[branch]);
+                }
+            }
+            return InstrResult::NORMAL;
+        case NodeKind::WHILE:
+            while (calculateBool(tree_.first[node])) {
+                InstrResult result = executeBlock(tree_.second[node]);
+                if (result == InstrResult::BREAK) {
+                    break;
+                }
+                if (result == InstrResult::RETURN) {
+                    return result;
+                }
+            }
+            return InstrResult::NORMAL;
+        case NodeKind::RETURN:
+            if (tree_.first[node] != NO_NODE) {
+                interpreter_.setReturnValue(calculate(tree_.first[node]));
+            }
+            return InstrResult::RETURN;
+        case NodeKind::BREAK:
+            return InstrResult::BREAK;
+        case NodeKind::CONTINUE:
+            return InstrResult::CONTINUE;
+        case NodeKind::PRINT:
+            interpreter_.printLineToStdout(getVariable(tree_.operands[node]).asString());
+            return InstrResult::NORMAL;
+        default:
+            ErrorHandler::handleFromInterpreter("Expression executed as instruction");
+    }
+}
+
+InstrResult FlatEvaluator::executeBlock(NodeIndex block) {
+    // variables of the block are kept in frame slots assigned by Resolver
+    const NodeIndex *instr = tree_.children.data() + tree_.first[block];
+    const NodeIndex *end = instr + tree_.second[block];
+    InstrResult result = InstrResult::NORMAL;
+    for (; instr != end && result == InstrResult::NORMAL; ++instr) {
+        result = executeNode(*instr);
+    }
+    return result;
+}
+
+Value FlatEvaluator::calculate(NodeIndex node) {
+    switch (tree_.kinds[node]) {
+        case NodeKind::LITERAL:
+            return tree_.constants[tree_.operands[node]];
+        case NodeKind::VARIABLE:
+            return getVariable(tree_.operands[node]);
+        case NodeKind::ADD_NUMBERS:
+        case NodeKind::SUBTRACT_NUMBERS:
+        case NodeKind::MULT_NUMBERS:
+        case NodeKind::DIV_NUMBERS:
+            // the result is created directly with its statically known type
+            if (const Type *type = tree_.binaryExpressions[tree_.operands[node]]->getExactType()) {
+                return Value(calculateNumber(node), Type(*type));
+            }
+            return calculateBinary(node);
+        case NodeKind::COMPARE_NUMBERS:
+        case NodeKind::COMPARE_BOOLS:
+        case NodeKind::AND:
+        case NodeKind::OR:
+            return Value(calculateBool(node));
+        case NodeKind::BINARY:
+            return calculateBinary(node);
+        case NodeKind::STRING:
+            return calculateString(node);
+        case NodeKind::CALL:
+            return calculateCall(node);
+        default:
+            ErrorHandler::handleFromInterpreter("Instruction calculated as expression");
+    }
+}
+
+double FlatEvaluator::calculateNumber(NodeIndex node) {
+    switch (tree_.kinds[node]) {
+        case NodeKind::ADD_NUMBERS: {
+            double left = numberOperand(tree_.first[node]);
+            return left + numberOperand(tree_.second[node]);
+        }
+        case NodeKind::SUBTRACT_NUMBERS: {
+            double left = numberOperand(tree_.first[node]);
+            return left - numberOperand(tree_.second[node]);
+        }
+        case NodeKind::MULT_NUMBERS: {
+            double left = numberOperand(tree_.first[node]);
+            return left * numberOperand(tree_.second[node]);
+        }
+        case NodeKind::DIV_NUMBERS: {
+            double left = numberOperand(tree_.first[node]);
+            return left / numberOperand(tree_.second[node]);
+        }
+        case NodeKind::LITERAL:
+        case NodeKind::VARIABLE:
+            return numberOperand(node);
+        default:
+            return calculate(node).asDouble();
+    }
+}
+
+bool FlatEvaluator::calculateBool(NodeIndex node) {
+    switch (tree_.kinds[node]) {
+        case NodeKind::COMPARE_NUMBERS: {
+            double left = numberOperand(tree_.first[node]);
+            double right = numberOperand(tree_.second[node]);
+            return BinaryExpression::compare(tree_.operators[tree_.operands[node]], left, right);
+        }
+        case NodeKind::COMPARE_BOOLS: {
+            bool left = boolOperand(tree_.first[node]);
+            bool right = boolOperand(tree_.second[node]);
+            return BinaryExpression::compare(tree_.operators[tree_.operands[node]], left, right);
+        }
+        // the right operand is not calculated when the left one decides the result
+        case NodeKind::AND:
+            return boolOperand(tree_.first[node]) && boolOperand(tree_.second[node]);
+        case NodeKind::OR:
+            return boolOperand(tree_.first[node]) || boolOperand(tree_.second[node]);
+        case NodeKind::LITERAL:
+        case NodeKind::VARIABLE:
+            return boolOperand(node);
+        default:
+            return calculate(node).asBool();
+    }
+}
+
+Value FlatEvaluator::calculateBinary(NodeIndex node) {
+    const BinaryExpression &expr = *tree_.binaryExpressions[tree_.operands[node]];
+    Value left = calculate(tree_.first[node]);
+    // result of && and || may be decided by the left operand
+    std::optional<bool> decisive = expr.getShortCircuitValue();
+    if (decisive && left.type.getTypeClass() == Type::BOOL && left.asBool() == *decisive) {
+        return left;
+    }
+    std::optional<Value> temporary;
+    expr.apply(left, calculateRef(tree_.second[node], temporary));
+    return left;
+}
+
+Value FlatEvaluator::calculateString(NodeIndex node) {
+    std::string str;
+    const NodeIndex *part = tree_.children.data() + tree_.first[node];
+    for (const NodeIndex *end = part + tree_.second[node]; part != end; ++part) {
+        std::optional<Value> temporary;
+        str += calculateRef(*part, temporary).toString();
+    }
+    return Value(std::move(str));
+}
+
+Value FlatEvaluator::calculateCall(NodeIndex node) {
+    std::optional<Value> retVal = call(tree_.operands[node], calculateArgs(node));
+    if (!retVal) {
+        ErrorHandler::handleTypeMismatch("Function call as expression cannot evaluate to type void");
+    }
+    return std::move(*retVal);
+}
+
+const Value& FlatEvaluator::calculateRef(NodeIndex node, std::optional<Value> &temporary) {
+    switch (tree_.kinds[node]) {
+        case NodeKind::LITERAL:
+            return tree_.constants[tree_.operands[node]];
+        case NodeKind::VARIABLE:
+            return getVariable(tree_.operands[node]);
+        default:
+            return temporary.emplace(calculate(node));
+    }
+}
+
+const Value& FlatEvaluator::getVariable(std::uint32_t index) {
+    const FlatVariable &var = tree_.variables[index];
+    return interpreter_.getVariable(var.slot, tree_.names[var.name]);
+}
+
+std::vector<Value> FlatEvaluator::calculateArgs(NodeIndex call) {
+    std::vector<Value> args;
+    args.reserve(tree_.second[call]);
+    const NodeIndex *arg = tree_.children.data() + tree_.first[call];
+    for (const NodeIndex *end = arg + tree_.second[call]; arg != end; ++arg) {
+        args.push_back(calculate(*arg));
+    }
+    return args;
+}
+
+std::optional<Value> FlatEvaluator::call(std::uint32_t function, std::vector<Value> &&args) {
+    const FuncDef &funcDef = *tree_.functions[function].funcDef;
+    if (!funcDef.isPure() || !interpreter_.isMemoizing()) {
+        return executeFunction(function, std::move(args));
+    }
+    return callMemoized(function, std::move(args));
+}
+
+std::optional<Value> FlatEvaluator::callMemoized(std::uint32_t function, std::vector<Value> &&args) {
+    const FuncDef &funcDef = *tree_.functions[function].funcDef;
+    if (const std::optional<Value> *memoized = interpreter_.findMemoized(funcDef, args)) {
+        return *memoized;
+    }
+    std::vector<Value> memoizedArgs = args;
+    std::optional<Value> result = executeFunction(function, std::move(args));
+    interpreter_.memoize(funcDef, std::move(memoizedArgs), result);
+    return result;
+}
+
+std::optional<Value> FlatEvaluator::executeFunction(std::uint32_t function, std::vector<Value> &&args) {
+    const FlatFunction *callee = &tree_.functions[function];
+    callee->funcDef->enter(interpreter_, std::move(args));
+    InstrResult result = executeBlock(callee->body);
+    // tail calls continue in the function call context of the replaced call
+    while (tailCall_) {
+        TailCall tailCall = std::move(*tailCall_);
+        tailCall_.reset();
+        callee = &tree_.functions[tailCall.function];
+        callee->funcDef->reenter(interpreter_, std::move(tailCall.args));
+        result = executeBlock(callee->body);
+    }
+    return callee->funcDef->leave(interpreter_, result);
+}
@@ -0,0 +1,84 @@
+#ifndef TKOMSIUNITS_FLAT_FLAT_EVALUATOR_H_INCLUDED
+#define TKOMSIUNITS_FLAT_FLAT_EVALUATOR_H_INCLUDED
+
+#include "FlatTree.h"
+#include "codeObjects/InstrResult.h"
+#include "codeObjects/Interpreter.h"
+#include "codeObjects/Value.h"
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// Walks FlatTree the same way the Interpreter walks code objects. Variable frames and
+// function call contexts are kept by the Interpreter, so semantics and error messages
+// are shared with the object tree walker.
+class FlatEvaluator {
+public:
+    FlatEvaluator(Interpreter &interpreter, const FlatTree &tree)
+        : interpreter_(interpreter)
+        , tree_(tree) {}
+    
+    // executes the program the same way as Interpreter::executeProgram(), returns exit status
+    int execute();
+    
+    // executes the program inside already created main function call context
+    int run();
+
+private:
+    // requested by a TAIL_CALL node, made by the function call it replaces
+    struct TailCall {
+        std::uint32_t function;
+        std::vector<Value> args;
+    };
+
+private:
+    InstrResult executeNode(NodeIndex node);
+    InstrResult executeBlock(NodeIndex block);
+    Value calculate(NodeIndex node);
+    // value of the node without copying values stored elsewhere (constants, variables)
+    const Value& calculateRef(NodeIndex node, std::optional<Value> &temporary);
+    // number or bool calculated raw, without constructing Values, where the types are
+    // checked by TypeChecker; a Value of other type is reported as by Value::asDouble()
+    double calculateNumber(NodeIndex node);
+    bool calculateBool(NodeIndex node);
+    // operands of raw operations; constants and variables are read without recursion
+    double numberOperand(NodeIndex node) {
+        switch (tree_.kinds[node]) {
+            case NodeKind::LITERAL:
+                return tree_.constants[tree_.operands[node]].asDouble();
+            case NodeKind::VARIABLE:
+                return getVariable(tree_.operands[node]).asDouble();
+            default:
+                return calculateNumber(node);
+        }
+    }
+    bool boolOperand(NodeIndex node) {
+        switch (tree_.kinds[node]) {
+            case NodeKind::LITERAL:
+                return tree_.constants[tree_.operands[node]].asBool();
+            case NodeKind::VARIABLE:
+                return getVariable(tree_.operands[node]).asBool();
+            default:
+                return calculateBool(node);
+        }
+    }
+    // less frequent cases of calculate(), kept out of it so that its stack frame,
+    // taken by every level of nested function calls, stays small
+    Value calculateBinary(NodeIndex node);
+    Value calculateString(NodeIndex node);
+    Value calculateCall(NodeIndex node);
+    const Value& getVariable(std::uint32_t index);
+    
+    std::vector<Value> calculateArgs(NodeIndex call);
+    // result of a pure function is memoized if the interpreter memoizes calls
+    std::optional<Value> call(std::uint32_t function, std::vector<Value> &&args);
+    std::optional<Value> callMemoized(std::uint32_t function, std::vector<Value> &&args);
+    std::optional<Value> executeFunction(std::uint32_t function, std::vector<Value> &&args);
+
+private:
+    Interpreter &interpreter_;
+    const FlatTree &tree_;
+    std::optional<TailCall> tailCall_;
+};
+
+#endif // TKOMSIUNITS_FLAT_FLAT_EVALUATOR_H_INCLUDED
@@ -0,0 +1,83 @@
+#ifndef TKOMSIUNITS_FLAT_FLAT_TREE_H_INCLUDED
+#define TKOMSIUNITS_FLAT_FLAT_TREE_H_INCLUDED
+
+#include "codeObjects/BinaryExpression.h"
+#include "codeObjects/FuncDef.h"
+#include "codeObjects/Value.h"
+#include "codeObjects/VarSlot.h"
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+class Program;
+class VarDefOrAssignment;
+
+using NodeIndex = std::uint32_t;
+
+inline constexpr NodeIndex NO_NODE = std::numeric_limits<NodeIndex>::max();
+
+// meaning of first, second and operand of the node
+enum class NodeKind : std::uint8_t {
+    LITERAL,    // operand: index in constants
+    VARIABLE,   // operand: index in variables
+    BINARY,     // first, second: left and right operand; operand: index in binaryExpressions
+    // binary expressions calculated on raw numbers and bools, as by BinaryExpression::calculateNumber()
+    // and calculateBool(); the operand types are checked by TypeChecker; first, second, operand as BINARY
+    ADD_NUMBERS,
+    SUBTRACT_NUMBERS,
+    MULT_NUMBERS,
+    DIV_NUMBERS,
+    COMPARE_NUMBERS,
+    COMPARE_BOOLS,
+    AND,
+    OR,
+    STRING,     // first, second: start and count of parts in children
+    CALL,       // first, second: start and count of arguments in children; operand: index in functions
+    TAIL_CALL,  // as CALL, replaces the function call in which it is returned
+    STORE,      // first: stored value; operand: index in assignments
+    STORE_NUMBER, // as STORE, the value is calculated raw and assigned in place
+    BLOCK,      // first, second: start and count of instructions in children
+    IF,         // first: condition (NO_NODE for else), second: block; operand: else-if node (NO_NODE if none)
+    WHILE,      // first: condition, second: body block
+    RETURN,     // first: returned value (NO_NODE if none)
+    BREAK,
+    CONTINUE,
+    PRINT       // operand: index in variables of the printed string
+};
+
+struct FlatVariable {
+    VarSlot slot;
+    std::uint32_t name; // index in names
+};
+
+struct FlatFunction {
+    const FuncDef *funcDef;
+    NodeIndex body;
+};
+
+// Code objects of a Program laid out as a struct of arrays indexed by NodeIndex: node i
+// is kinds[i], first[i], second[i] and operands[i]. Children refer to each other by
+// 32-bit indices and precede their parents, so walking the tree reads a few contiguous
+// arrays instead of following pointers between objects scattered over the heap.
+// Refers to code objects of the source Program, which has to outlive it.
+struct FlatTree {
+    const Program *program = nullptr;
+    NodeIndex main = NO_NODE;
+    std::vector<NodeKind> kinds;
+    std::vector<NodeIndex> first;
+    std::vector<NodeIndex> second;
+    std::vector<std::uint32_t> operands;
+    // children of blocks, strings and calls, each in a contiguous range
+    std::vector<NodeIndex> children;
+    std::vector<FlatFunction> functions;
+    std::vector<Value> constants;
+    std::vector<std::string> names;
+    std::vector<FlatVariable> variables;
+    std::vector<const VarDefOrAssignment *> assignments;
+    std::vector<const BinaryExpression *> binaryExpressions;
+    // operator of each of binaryExpressions
+    std::vector<BinaryExpression::Operator> operators;
+};
+
+#endif // TKOMSIUNITS_FLAT_FLAT_TREE_H_INCLUDED
@@ -0,0 +1,197 @@
+#include "FlatTreeBuilder.h"
+
+#include "codeObjects/Program.h"
+#include "codeObjects/FuncCall.h"
+#include "codeObjects/Literal.h"
+#include "codeObjects/VarReference.h"
+#include "codeObjects/String.h"
+#include "codeObjects/VarDefOrAssignment.h"
+#include "codeObjects/If.h"
+#include "codeObjects/While.h"
+#include "codeObjects/Return.h"
+#include "codeObjects/Break.h"
+#include "codeObjects/Continue.h"
+#include "codeObjects/InternalPrintInstr.h"
+#include "error/ErrorHandler.h"
+#include <utility>
+
+FlatTree FlatTreeBuilder::build(const Program &program) {
+    FlatTreeBuilder builder(program);
+    builder.tree_.main = builder.buildBlock(program.getInstructions());
+    // functions vector grows while building functions called from other functions
+    for (std::size_t i = 0; i < builder.tree_.functions.size(); ++i) {
+        builder.buildFunction(i);
+    }
+    return std::move(builder.tree_);
+}
+
+FlatTreeBuilder::FlatTreeBuilder(const Program &program) {
+    tree_.program = &program;
+}
+
+void FlatTreeBuilder::buildFunction(std::size_t index) {
+    NodeIndex body = buildBlock(tree_.functions[index].funcDef->getBody());
+    tree_.functions[index].body = body;
+}
+
+NodeIndex FlatTreeBuilder::buildBlock(const InstructionBlock &block) {
+    std::vector<NodeIndex> instructions;
+    for (auto &&instr : block.getInstructions()) {
+        instructions.push_back(build(*instr));
+    }
+    return addParent(NodeKind::BLOCK, instructions);
+}
+
+NodeIndex FlatTreeBuilder::build(Instruction &instr) {
+    instr.accept(*this);
+    return result_;
+}
+
+NodeIndex FlatTreeBuilder::build(Expression &expr) {
+    expr.accept(*this);
+    return result_;
+}
+
+NodeIndex FlatTreeBuilder::addParent(NodeKind kind, const std::vector<NodeIndex> &children, std::uint32_t operand) {
+    auto start = static_cast<NodeIndex>(tree_.children.size());
+    tree_.children.insert(tree_.children.end(), children.begin(), children.end());
+    return addNode(kind, start, static_cast<NodeIndex>(children.size()), operand);
+}
+
+NodeIndex FlatTreeBuilder::addNode(NodeKind kind, NodeIndex first, NodeIndex second, std::uint32_t operand) {
+    if (tree_.kinds.size() >= NO_NODE) {
+        ErrorHandler::handleFromInterpreter("Too many code objects for flat tree");
+    }
+    tree_.kinds.push_back(kind);
+    tree_.first.push_back(first);
+    tree_.second.push_back(second);
+    tree_.operands.push_back(operand);
+    return static_cast<NodeIndex>(tree_.kinds.size() - 1);
+}
+
+NodeIndex FlatTreeBuilder::addCall(NodeKind kind, const FuncCall &funcCall) {
+    std::vector<NodeIndex> args;
+    for (auto &&arg : funcCall.getArgs()) {
+        args.push_back(build(*arg));
+    }
+    return addParent(kind, args, functionIndex(*funcCall.getFuncDef()));
+}
+
+void FlatTreeBuilder::visit(Literal &literal) {
+    tree_.constants.push_back(literal.getValue());
+    result_ = addNode(NodeKind::LITERAL, NO_NODE, NO_NODE, static_cast<std::uint32_t>(tree_.constants.size() - 1));
+}
+
+void FlatTreeBuilder::visit(BinaryExpression &expr) {
+    NodeIndex left = build(expr.getLeftOperand());
+    NodeIndex right = build(expr.getRightOperand());
+    tree_.binaryExpressions.push_back(&expr);
+    tree_.operators.push_back(expr.getOperatorKind());
+    result_ = addNode(binaryKind(expr), left, right, static_cast<std::uint32_t>(tree_.binaryExpressions.size() - 1));
+}
+
+NodeKind FlatTreeBuilder::binaryKind(const BinaryExpression &expr) {
+    using Operator = BinaryExpression::Operator;
+    if (!expr.isCalculatedRaw(Type::NUMBER) && !expr.isCalculatedRaw(Type::BOOL)) {
+        return NodeKind::BINARY;
+    }
+    switch (expr.getOperatorKind()) {
+        case Operator::ADD:
+            return NodeKind::ADD_NUMBERS;
+        case Operator::SUBTRACT:
+            return NodeKind::SUBTRACT_NUMBERS;
+        case Operator::MULT:
+            return NodeKind::MULT_NUMBERS;
+        case Operator::DIV:
+            return NodeKind::DIV_NUMBERS;
+        case Operator::EQUAL_TO:
+        case Operator::NOT_EQUAL_TO:
+            return expr.getOperandsType() == Type::BOOL ? NodeKind::COMPARE_BOOLS : NodeKind::COMPARE_NUMBERS;
+        case Operator::AND:
+            return NodeKind::AND;
+        case Operator::OR:
+            return NodeKind::OR;
+        default:
+            return NodeKind::COMPARE_NUMBERS;
+    }
+}
+
+void FlatTreeBuilder::visit(VarReference &varRef) {
+    result_ = addNode(NodeKind::VARIABLE, NO_NODE, NO_NODE, variableIndex(varRef.getSlot(), varRef.getName()));
+}
+
+void FlatTreeBuilder::visit(codeobj::String &str) {
+    std::vector<NodeIndex> parts;
+    for (auto &&part : str.getParts()) {
+        parts.push_back(build(*part));
+    }
+    result_ = addParent(NodeKind::STRING, parts);
+}
+
+void FlatTreeBuilder::visit(FuncCall &funcCall) {
+    // the same node is executed as instruction (result discarded) or calculated as expression
+    result_ = addCall(NodeKind::CALL, funcCall);
+}
+
+void FlatTreeBuilder::visit(VarDefOrAssignment &instr) {
+    NodeIndex value = build(instr.getExpr());
+    tree_.assignments.push_back(&instr);
+    NodeKind kind = instr.assignsNumberInPlace() ? NodeKind::STORE_NUMBER : NodeKind::STORE;
+    result_ = addNode(kind, value, NO_NODE, static_cast<std::uint32_t>(tree_.assignments.size() - 1));
+}
+
+void FlatTreeBuilder::visit(If &instr) {
+    NodeIndex cond = instr.getCond() ? build(*instr.getCond()) : NO_NODE;
+    NodeIndex block = buildBlock(instr.getPositiveBlock());
+    NodeIndex elseIf = instr.getElseIf() ? build(*instr.getElseIf()) : NO_NODE;
+    result_ = addNode(NodeKind::IF, cond, block, elseIf);
+}
+
+void FlatTreeBuilder::visit(While &instr) {
+    NodeIndex cond = build(instr.getCond());
+    NodeIndex body = buildBlock(instr.getBody());
+    result_ = addNode(NodeKind::WHILE, cond, body);
+}
+
+void FlatTreeBuilder::visit(Return &instr) {
+    if (const FuncCall *tailCall = instr.getTailCall()) {
+        result_ = addCall(NodeKind::TAIL_CALL, *tailCall);
+        return;
+    }
+    NodeIndex value = instr.getExpr() ? build(*instr.getExpr()) : NO_NODE;
+    result_ = addNode(NodeKind::RETURN, value);
+}
+
+void FlatTreeBuilder::visit([[maybe_unused]] Break &instr) {
+    result_ = addNode(NodeKind::BREAK);
+}
+
+void FlatTreeBuilder::visit([[maybe_unused]] Continue &instr) {
+    result_ = addNode(NodeKind::CONTINUE);
+}
+
+void FlatTreeBuilder::visit(InternalPrintInstr &instr) {
+    result_ = addNode(NodeKind::PRINT, NO_NODE, NO_NODE, variableIndex(instr.getSlot(), instr.getStringVariableName()));
+}
+
+std::uint32_t FlatTreeBuilder::nameIndex(const std::string &name) {
+    auto [iter, inserted] = nameIndices_.insert({ name, static_cast<std::uint32_t>(tree_.names.size()) });
+    if (inserted) {
+        tree_.names.push_back(name);
+    }
+    return iter->second;
+}
+
+std::uint32_t FlatTreeBuilder::variableIndex(const VarSlot &slot, const std::string &name) {
+    tree_.variables.push_back(FlatVariable{ slot, nameIndex(name) });
+    return static_cast<std::uint32_t>(tree_.variables.size() - 1);
+}
+
+std::uint32_t FlatTreeBuilder::functionIndex(const FuncDef &funcDef) {
+    auto [iter, inserted] = functionIndices_.insert({ &funcDef, static_cast<std::uint32_t>(tree_.functions.size()) });
+    if (inserted) {
+        // built after the current tree
+        tree_.functions.push_back(FlatFunction{ &funcDef, NO_NODE });
+    }
+    return iter->second;
+}
@@ -0,0 +1,60 @@
+#ifndef TKOMSIUNITS_FLAT_FLAT_TREE_BUILDER_H_INCLUDED
+#define TKOMSIUNITS_FLAT_FLAT_TREE_BUILDER_H_INCLUDED
+
+#include "FlatTree.h"
+#include "codeObjects/CodeObjectVisitor.h"
+#include "codeObjects/Expression.h"
+#include "codeObjects/Instruction.h"
+#include "codeObjects/InstructionBlock.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Program;
+
+// Lays out Program top-level instructions and all functions called from it as FlatTree.
+class FlatTreeBuilder : private CodeObjectVisitor {
+public:
+    static FlatTree build(const Program &program);
+
+private:
+    explicit FlatTreeBuilder(const Program &program);
+
+    void buildFunction(std::size_t index);
+    NodeIndex buildBlock(const InstructionBlock &block);
+    NodeIndex build(Instruction &instr);
+    NodeIndex build(Expression &expr);
+    // node with children, added after all of them are built
+    NodeIndex addParent(NodeKind kind, const std::vector<NodeIndex> &children, std::uint32_t operand = 0);
+    NodeIndex addNode(NodeKind kind, NodeIndex first = NO_NODE, NodeIndex second = NO_NODE, std::uint32_t operand = 0);
+    NodeIndex addCall(NodeKind kind, const FuncCall &funcCall);
+    // kind of node calculating the expression raw, BINARY if its operand types are not known
+    static NodeKind binaryKind(const BinaryExpression &expr);
+
+    void visit(Literal &literal) override;
+    void visit(BinaryExpression &expr) override;
+    void visit(VarReference &varRef) override;
+    void visit(codeobj::String &str) override;
+    void visit(FuncCall &funcCall) override;
+    void visit(VarDefOrAssignment &instr) override;
+    void visit(If &instr) override;
+    void visit(While &instr) override;
+    void visit(Return &instr) override;
+    void visit(Break &instr) override;
+    void visit(Continue &instr) override;
+    void visit(InternalPrintInstr &instr) override;
+
+    std::uint32_t nameIndex(const std::string &name);
+    std::uint32_t variableIndex(const VarSlot &slot, const std::string &name);
+    std::uint32_t functionIndex(const FuncDef &funcDef);
+
+private:
+    FlatTree tree_;
+    // node of the last visited code object
+    NodeIndex result_ = NO_NODE;
+    std::unordered_map<std::string, std::uint32_t> nameIndices_;
+    std::unordered_map<const FuncDef *, std::uint32_t> functionIndices_;
+};
+
+#endif // TKOMSIUNITS_FLAT_FLAT_TREE_BUILDER_H_INCLUDED
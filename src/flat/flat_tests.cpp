@@ -0,0 +1,141 @@
+#include "FlatTreeBuilder.h"
+#include "FlatEvaluator.h"
+#include "utils/engineTestUtils.h"
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <gtest/gtest.h>
+
+namespace {
+
+using engineTests::RunResult;
+using engineTests::parse;
+using engineTests::run;
+using engineTests::runTreeWalker;
+
+int executeFlat(Interpreter &interp, const Program &program) {
+    FlatTree tree = FlatTreeBuilder::build(program);
+    FlatEvaluator evaluator(interp, tree);
+    return evaluator.execute();
+}
+
+RunResult runFlat(const std::string &input, bool memoize = false) {
+    return run(input, executeFlat, memoize);
+}
+
+void expectParity(const std::string &input, bool memoize = false) {
+    engineTests::expectParity(input, executeFlat, memoize);
+}
+
+} // anonymous namespace
+
+TEST(FlatTests, ChildrenPrecedeParents) {
+    std::unique_ptr<Program> program = parse(
+            "x = 2[m]\n"
+            "a = (x + 1[m]) * x - x * x / 2\n"
+            "print(\"{a}\")\n"
+        );
+    FlatTree tree = FlatTreeBuilder::build(*program);
+    ASSERT_EQ(tree.kinds.size(), tree.first.size());
+    ASSERT_EQ(tree.kinds.size(), tree.second.size());
+    ASSERT_EQ(tree.kinds.size(), tree.operands.size());
+    EXPECT_EQ(NodeKind::BLOCK, tree.kinds[tree.main]);
+    for (NodeIndex i = 0; i < tree.second[tree.main]; ++i) {
+        EXPECT_LT(tree.children[tree.first[tree.main] + i], tree.main);
+    }
+    EXPECT_EQ(5u, tree.binaryExpressions.size());
+    for (NodeIndex node = 0; node < tree.kinds.size(); ++node) {
+        // BINARY and the kinds of binary expressions calculated raw follow it
+        if (tree.kinds[node] >= NodeKind::BINARY && tree.kinds[node] <= NodeKind::OR) {
+            EXPECT_LT(tree.first[node], node);
+            EXPECT_LT(tree.second[node], node);
+        }
+    }
+    ASSERT_EQ(1u, tree.functions.size());
+    EXPECT_EQ("print", tree.functions.front().funcDef->getName());
+}
+
+TEST(FlatTests, ExecutesLikeTreeWalker) {
+    std::string input = "a = 10\n b = 0\n"
+                        "while a > 0 {"
+                        "    a = a - 1\n"
+                        "    if a > 7 { continue\n } elif a == 7 { b = b + 10\n } else { b = b + 0\n }\n"
+                        "    c = a * 1[m]\n"
+                        "    b = b + 1\n"
+                        "    if a < 3 { break\n }\n"
+                        "}\n"
+                        "func fibonacci (steps [1]) -> [m] {"
+                        "    if steps < 2 {"
+                        "        return steps * 1[m]\n"
+                        "    }\n"
+                        "    return fibonacci(steps - 1) + fibonacci(steps - 2)\n"
+                        "}\n"
+                        "func sum (n [1], acc [km]) -> [km] {"
+                        "    if n == 0 {"
+                        "        return acc\n"
+                        "    }\n"
+                        "    return sum(n - 1, acc + 1[km])\n"
+                        "}\n"
+                        "f = fibonacci(15)\n"
+                        "total = sum(10 000, 0[km])\n"
+                        "l = b > 100 && fibonacci(30) > 0[m] || false\n"
+                        "print(\"a = {a}, b = {b}, {f} {total} {l}\")\n"
+                        "return b\n";
+    RunResult result = runFlat(input);
+    EXPECT_EQ(16, result.exitStatus);
+    EXPECT_EQ("a = 2, b = 16, 610[(m)/()] 10000[(km)/()] false\n", result.stdout);
+    expectParity(input);
+    expectParity(input, true);
+}
+
+TEST(FlatTests, StaticallyTypedExpressionsAreCalculatedRaw) {
+    std::string input =
+        "func isPositive (x [m]) -> [bool] {"
+        "    return x > 0[m]\n"
+        "}\n"
+        "i = 0\n"
+        "distance = 0[km]\n"
+        "time = 0[s]\n"
+        "isFar = false\n"
+        "while i < 10 && (i == 0 || distance / 2[km] < 100) {"
+        "    distance = distance + 2[km] * i\n"
+        "    time = time + 1[s]\n"
+        "    i = i + 1\n"
+        "    if i == 3 { continue\n }\n"
+        "    isFar = distance > 10[km] == true\n"
+        "    if isFar != (time < 7[s]) && isPositive(distance / 1[km] * 1[m]) {"
+        "        print(\"far {i}\")\n"
+        "    }\n"
+        "}\n"
+        "speed = distance / time\n"
+        "print(\"{speed} {isFar}\")\n"
+        "return i - 10 + speed / 1[km/s] - 1 + undefinedVar\n";
+    std::unique_ptr<Program> program = parse(input);
+    FlatTree tree = FlatTreeBuilder::build(*program);
+    auto countOf = [&tree](NodeKind kind) {
+            return std::count(tree.kinds.begin(), tree.kinds.end(), kind);
+        };
+    // numbers of exact types are operated on without their Values, only the type of
+    // the sum with not-defined variable is unknown
+    EXPECT_EQ(1, countOf(NodeKind::BINARY));
+    EXPECT_EQ(3, countOf(NodeKind::STORE_NUMBER));
+    EXPECT_EQ(2, countOf(NodeKind::COMPARE_BOOLS));
+    EXPECT_EQ(2, countOf(NodeKind::AND));
+    EXPECT_EQ(1, countOf(NodeKind::OR));
+    RunResult result = runFlat(input);
+    EXPECT_EQ(1, result.exitStatus);
+    EXPECT_EQ("far 2\nfar 7\nfar 8\nfar 9\nfar 10\n9[(km)/(s)] true\n", result.stdout);
+    expectParity(input);
+}
+
+TEST(FlatTests, RuntimeErrorsMatchTreeWalker) {
+    expectParity("break\n");
+    expectParity("func f () { continue\n }\n f()\n");
+    expectParity("func f () -> [m] { }\n a = f()\n");
+    expectParity("func f () { return\n }\n f()\n");
+    expectParity("print(b)\n");
+    expectParity("a = 1[km]\n a = 1[m]\n b = a * 1[km]\n");
+    expectParity("func getZ () -> [m] { return z\n }\n w = getZ()\n z = 1[m]\n");
+    expectParity("print(\"start\")\n if false { x = [1][m] + [1, 2][m]\n }\n y = [1][m] - [1, 2][m]\n");
+    expectParity("func depth (n [1]) -> [1] { return depth(n + 1) + 1\n }\n print(\"start\")\n d = depth(0)\n");
+}
@@ -1,65 +1,83 @@
 #include "Lexer.h"
-#include "error/ErrorHandler.h"
+#include "Spellings.h"
 #include "error/LexerError.h"
 #include "error/UnknownLexemeError.h"
+#include "source/BufferSource.h"
+#include <algorithm>
 #include <cassert>
 #include <cctype>
+#include <cstring>
 #include <stdexcept>
 #include <sstream>
 #include <vector>
 
-const std::unordered_map<std::string, TokenType> Lexer::keywords_ {
-    { "bool"     , TokenType::KEYWORD_BOOL     },
-    { "break"    , TokenType::KEYWORD_BREAK    },
-    { "continue" , TokenType::KEYWORD_CONTINUE },
-    { "elif"     , TokenType::KEYWORD_ELIF     },
-    { "else"     , TokenType::KEYWORD_ELSE     },
-    { "false"    , TokenType::KEYWORD_FALSE    },
-    { "func"     , TokenType::KEYWORD_FUNC     },
-    { "if"       , TokenType::KEYWORD_IF       },
-    { "in"       , TokenType::KEYWORD_IN       },
-    { "return"   , TokenType::KEYWORD_RETURN   },
-    { "str"      , TokenType::KEYWORD_STR      },
-    { "true"     , TokenType::KEYWORD_TRUE     },
-    { "while"    , TokenType::KEYWORD_WHILE    }
-};
-
-const std::vector<std::pair<std::string, UnitType>> units {
-    { "s", UnitType::SECOND },
-    { "g", UnitType::GRAM },
-    { "m", UnitType::METER },
-    { "N", UnitType::NEWTON },
-    { "Pa", UnitType::PASCAL },
-    { "J", UnitType::JOULE }
-};
-
-const std::vector<std::pair<std::string, int>> unitPowers {
-    { "", 1 },
-    { "2", 2 },
-    { "3", 3 }
-};
-
-std::unordered_map<std::string, Unit> createUnitsMap() {
-    std::unordered_map<std::string, Unit> unitsMap;
-    for (auto &&[pref, _] : unitPrefixes) {
-        (void)_;
-        for (auto &&[unit, unitVal] : units) {
-            for (auto &&[power, powerVal] : unitPowers) {
-                std::string unitString = pref + unit + power;
-                Unit unitStructure {pref, unitVal, powerVal};
-                unitsMap.insert({ std::move(unitString), std::move(unitStructure) });
+Lexer::Lexer(Source &source) {
+    if (auto *bufferSource = dynamic_cast<BufferSource *>(&source)) {
+        input_ = bufferSource->getBuffer();
+    } else {
+        source_ = &source;
+    }
+}
+
+Lexer::Lexer(std::string_view input)
+    : input_(input) {
+}
+
+PosInStream Lexer::currentPosition() const {
+    if (source_) {
+        return source_->getCurrentPosition();
+    }
+    if (cursor_ == 0) {
+        return { 1, 0 };
+    }
+    return positionOfOffset(cursor_ - 1);
+}
+
+PosInStream Lexer::positionOfOffset(std::size_t offset) const {
+    // offsets past the end of input denote EOF reads
+    std::size_t scanTo = std::min(offset, input_.size());
+    if (scanTo >= knownOffset_) {
+        const char *it = input_.data() + knownOffset_;
+        const char *end = input_.data() + scanTo;
+        while (const void *nl = std::memchr(it, '\n', end - it)) {
+            it = static_cast<const char *>(nl) + 1;
+            ++knownLine_;
+            knownLineStart_ = it - input_.data();
+        }
+    } else {
+        for (std::size_t i = scanTo; i < knownOffset_; ++i) {
+            if (input_[i] == '\n') {
+                --knownLine_;
             }
         }
+        std::size_t lineStart = scanTo;
+        while (lineStart > 0 && input_[lineStart - 1] != '\n') {
+            --lineStart;
+        }
+        knownLineStart_ = lineStart;
+    }
+    knownOffset_ = scanTo;
+    return { knownLine_, static_cast<unsigned int>(offset - knownLineStart_ + 1) };
+}
+
+std::string_view Lexer::intern(std::string_view text) {
+    if (auto it = internedLexemes_.find(text); it != internedLexemes_.end()) {
+        return *it;
     }
-    return unitsMap;
+    std::string_view stored = internStorage_.emplace_back(text);
+    internedLexemes_.insert(stored);
+    return stored;
 }
 
-const std::unordered_map<std::string, Unit> Lexer::units_ = createUnitsMap();
+void Lexer::reportError(const std::string &msg) const {
+    auto [line, col] = currentPosition();
+    throw LexerError(msg, line, col);
+}
 
 char Lexer::discardWhitespacesAndComments() {
     char c;
     while (true) {
-        c = source_.getChar();
+        c = nextChar();
         if (c == '/') {
             if (!discardComment()) {
                 break;
@@ -75,14 +93,14 @@ char Lexer::discardWhitespacesAndComments() {
 }
 
 bool Lexer::discardComment() {
-    char c = source_.getChar();
+    char c = nextChar();
     if (c != '/') {
-        source_.ungetChar(c);
+        ungetChar(c);
         return false;
     }
     // it is a comment
     while (!consumeNewline(c)) {
-        c = source_.getChar();
+        c = nextChar();
     }
     return true;
 }
@@ -90,10 +108,10 @@ bool Lexer::discardComment() {
 void Lexer::discardInstrBreak() {
     char c;
     do {
-        c = source_.getChar();
+        c = nextChar();
     } while (isblank(c));
     if (!consumeNewline(c)) {
-        ErrorHandler::handleFromLexer("Instruction break ('\\') followed by non-space character!");
+        reportError("Instruction break ('\\') followed by non-space character!");
     }
 }
 
@@ -104,11 +122,11 @@ bool Lexer::consumeNewline(char c) {
     }
     if (c == '\r') {
         gotR = true;
-        c = source_.getChar();
+        c = nextChar();
     }
     if (c != '\n') {
         if (gotR) {
-            ErrorHandler::handleFromLexer("'\\r' not followed by '\\n'!");
+            reportError("'\\r' not followed by '\\n'!");
         }
         return false;
     }
@@ -117,7 +135,7 @@ bool Lexer::consumeNewline(char c) {
 
 Token Lexer::getToken() {
     char c = discardWhitespacesAndComments();
-    PosInStream charPos = source_.getCurrentPosition();
+    PosInStream charPos = currentPosition();
     
     if (isalpha(c) || c == '_') {
         return constructIdOrUnitOrKeyword(c, charPos);
@@ -133,7 +151,7 @@ Token Lexer::getToken() {
             return constructEndOfInstr(c, charPos);
         case '/':
         case '*':
-            return { TokenType::OP_MULT, std::string{c}, charPos };
+            return { TokenType::OP_MULT, c == '*' ? "*" : "/", charPos };
         case '+':
         case '-':
             return constructAdditiveOpOrFuncResult(c, charPos);
@@ -151,23 +169,23 @@ Token Lexer::getToken() {
         case '"':
             return constructString(c, charPos);
         case '(':
-            return { TokenType::PAREN_OPEN, "", charPos };
+            return { TokenType::PAREN_OPEN, {}, charPos };
         case ')':
-            return { TokenType::PAREN_CLOSE, "", charPos };
+            return { TokenType::PAREN_CLOSE, {}, charPos };
         case '{':
-            return { TokenType::BRACKET_OPEN, "", charPos };
+            return { TokenType::BRACKET_OPEN, {}, charPos };
         case '}':
-            return { TokenType::BRACKET_CLOSE, "", charPos };
+            return { TokenType::BRACKET_CLOSE, {}, charPos };
         case '[':
-            return { TokenType::SQUARE_OPEN, "", charPos };
+            return { TokenType::SQUARE_OPEN, {}, charPos };
         case ']':
-            return { TokenType::SQUARE_CLOSE, "", charPos };
+            return { TokenType::SQUARE_CLOSE, {}, charPos };
         case ',':
-            return { TokenType::COMMA, "", charPos };
+            return { TokenType::COMMA, {}, charPos };
         case EOF:
-            return { TokenType::END_OF_STREAM, "", charPos };
+            return { TokenType::END_OF_STREAM, {}, charPos };
         default: {
-            auto [line, col] = source_.getCurrentPosition();
+            auto [line, col] = currentPosition();
             throw UnknownLexemeError(c, line, col);
         }
     }
@@ -176,59 +194,59 @@ Token Lexer::getToken() {
 Token Lexer::constructEndOfInstr(char c, const PosInStream &cPos) {
     bool newlineConstructed = consumeNewline(c);
     assert(newlineConstructed);
-    return { TokenType::END_OF_INSTRUCTION, "", cPos };
+    return { TokenType::END_OF_INSTRUCTION, {}, cPos };
 }
 
 Token Lexer::constructAdditiveOpOrFuncResult(char c, const PosInStream &cPos) {
-    char nextCh = source_.getChar();
+    char nextCh = nextChar();
     if (nextCh == c) {
-        return { TokenType::OP_SUFFIX, std::string{c, nextCh}, cPos };
+        return { TokenType::OP_SUFFIX, c == '+' ? "++" : "--", cPos };
     } else if (c == '-' && nextCh == '>') {
-        return { TokenType::FUNC_RESULT, "", cPos };
+        return { TokenType::FUNC_RESULT, {}, cPos };
     }
-    source_.ungetChar(nextCh);
-    return { TokenType::OP_ADD, std::string{c}, cPos };
+    ungetChar(nextCh);
+    return { TokenType::OP_ADD, c == '+' ? "+" : "-", cPos };
 }
 
 Token Lexer::constructAssignOrEq([[maybe_unused]] char c, const PosInStream &cPos) {
     assert(c == '=');
-    char nextCh = source_.getChar();
+    char nextCh = nextChar();
     if (nextCh == '=') {
         return { TokenType::OP_EQ, "==", cPos };
     }
-    source_.ungetChar(nextCh);
-    return { TokenType::ASSIGN, "", cPos };
+    ungetChar(nextCh);
+    return { TokenType::ASSIGN, {}, cPos };
 }
 
 Token Lexer::constructRelationalOp(char c, const PosInStream &cPos) {
-    char nextCh = source_.getChar();
+    char nextCh = nextChar();
     if (nextCh == '=') {
-        return { TokenType::OP_REL, std::string{c, nextCh}, cPos };
+        return { TokenType::OP_REL, c == '<' ? "<=" : ">=", cPos };
     }
-    source_.ungetChar(nextCh);
-    return { TokenType::OP_REL, std::string{c}, cPos };
+    ungetChar(nextCh);
+    return { TokenType::OP_REL, c == '<' ? "<" : ">", cPos };
 }
 
 Token Lexer::constructNotEq(char c, const PosInStream &cPos) {
-    c = source_.getChar();
+    c = nextChar();
     if (c != '=') {
-        ErrorHandler::handleFromLexer("'!' not followed by '='!");
+        reportError("'!' not followed by '='!");
     }
     return { TokenType::OP_EQ, "!=", cPos };
 }
 
 Token Lexer::constructAnd(char c, const PosInStream &cPos) {
-    c = source_.getChar();
+    c = nextChar();
     if (c != '&') {
-        ErrorHandler::handleFromLexer("'&' not followed by '&'!");
+        reportError("'&' not followed by '&'!");
     }
     return { TokenType::OP_AND, "&&", cPos };
 }
 
 Token Lexer::constructOr(char c, const PosInStream &cPos) {
-    c = source_.getChar();
+    c = nextChar();
     if (c != '|') {
-        ErrorHandler::handleFromLexer("'|' not followed by '|'!");
+        reportError("'|' not followed by '|'!");
     }
     return { TokenType::OP_OR, "||", cPos };
 }
@@ -236,42 +254,63 @@ Token Lexer::constructOr(char c, const PosInStream &cPos) {
 Token Lexer::constructString(char c, const PosInStream &cPos) {
     assert(c == '"');
     bool escaping = false;
-    std::ostringstream buffer;
     unsigned int length = 0;
-    PosInStream charPos;
-    String stringToken;
+    String stringToken { static_cast<std::uint32_t>(stringParts_.size()), 0 };
+
+    // Text between format references. In span mode it stays a view into the
+    // input until an escape sequence is met; then it is assembled in scratch_.
+    std::size_t segmentStart = cursor_;
+    std::size_t segmentLength = 0;
+    bool segmentBuffered = !isSpanMode();
+    scratch_.clear();
+
+    auto flushSegment = [&]() {
+        if (segmentLength > 0) {
+            std::string_view text = segmentBuffered
+                ? intern(scratch_)
+                : input_.substr(segmentStart, segmentLength);
+            stringParts_.push_back({ TokenType::TEXT_WITHIN_STRING, text });
+        }
+    };
+    auto startSegment = [&]() {
+        segmentStart = cursor_;
+        segmentLength = 0;
+        segmentBuffered = !isSpanMode();
+        scratch_.clear();
+    };
 
     while (true) {
-        c = source_.getChar();
-        charPos = source_.getCurrentPosition();
+        c = nextChar();
 
         if (consumeNewline(c)) {
-            ErrorHandler::handleFromLexer("closing '\"' not found in string before encountering newline!");
+            reportError("closing '\"' not found in string before encountering newline!");
         }
 
         switch (c) {
             case '\\':
+                if (!segmentBuffered) {
+                    scratch_.assign(input_.substr(segmentStart, segmentLength));
+                    segmentBuffered = true;
+                }
                 escaping = true;
                 c = 0;
                 break;
             case '{':
                 if (!escaping) {
-                    std::string text = buffer.str();
-                    buffer.str("");
-                    if (!text.empty()) {
-                        stringToken.innerTokens.push_back({
-                                TokenType::TEXT_WITHIN_STRING, text
-                            });
-                    }
-                        stringToken.innerTokens.push_back({
-                            TokenType::BRACKET_OPEN, "", charPos
+                    flushSegment();
+                    stringParts_.push_back({
+                            TokenType::BRACKET_OPEN, {}, currentPosition()
                         });
                     Token format;
                     do {
                         format = getToken();
-                        stringToken.innerTokens.push_back(format);
+                        if (format.type == TokenType::END_OF_STREAM) {
+                            reportError("closing '}' not found in string format!");
+                        }
+                        stringParts_.push_back(format);
                     }
                     while (format.type != TokenType::BRACKET_CLOSE);
+                    startSegment();
                     c = 0;
                 }
                 escaping = false;
@@ -290,12 +329,10 @@ Token Lexer::constructString(char c, const PosInStream &cPos) {
                 break;
             case '"':
                 if (!escaping) {
-                    std::string text = buffer.str();
-                    if (!text.empty()) {
-                        stringToken.innerTokens.push_back({
-                                TokenType::TEXT_WITHIN_STRING, text
-                            });
-                    }
+                    flushSegment();
+                    stringToken.partsCount = static_cast<std::uint32_t>(
+                            stringParts_.size() - stringToken.firstPart
+                        );
                     return { TokenType::STRING, stringToken, cPos };
                 }
                 [[fallthrough]];
@@ -303,35 +340,47 @@ Token Lexer::constructString(char c, const PosInStream &cPos) {
                 escaping = false;
         }
         if (c) {
-            buffer << c;
+            if (segmentBuffered) {
+                scratch_ += c;
+            }
+            ++segmentLength;
             assertStringLength(++length);
         }
     }
 }
 
 Token Lexer::constructIdOrUnitOrKeyword(char c, const PosInStream &cPos) {
-    std::stringstream buffer;
-    buffer << c;
-    unsigned int length = 1;
-
-    c = source_.getChar();
-    while (isalpha(c) || c == '_' || isdigit(c)) {
-        buffer << c;
-        assertIdLength(++length);
-        c = source_.getChar();
+    std::string_view value;
+    if (isSpanMode()) {
+        std::size_t start = cursor_ - 1;
+        c = nextChar();
+        while (isalpha(c) || c == '_' || isdigit(c)) {
+            assertIdLength(cursor_ - start);
+            c = nextChar();
+        }
+        ungetChar(c);
+        value = input_.substr(start, cursor_ - start);
+    } else {
+        scratch_.assign(1, c);
+        c = nextChar();
+        while (isalpha(c) || c == '_' || isdigit(c)) {
+            scratch_ += c;
+            assertIdLength(scratch_.size());
+            c = nextChar();
+        }
+        ungetChar(c);
+        value = scratch_;
     }
-    source_.ungetChar(c);
-    std::string value = buffer.str();
 
     // check if it is a keyword
-    if (auto it = keywords_.find(value); it != keywords_.end()) {
-        return { it->second, value, cPos };
+    if (auto keyword = classifyKeyword(value)) {
+        return { keyword->type, keyword->spelling, cPos };
     }
     // check if it is a unit
-    if (auto it = units_.find(value); it != units_.end()) {
-        return { TokenType::UNIT, it->second, cPos };
+    if (auto unit = classifyUnit(value)) {
+        return { TokenType::UNIT, *unit, cPos };
     }
-    return { TokenType::ID, value, cPos };
+    return { TokenType::ID, isSpanMode() ? value : intern(value), cPos };
 }
 
 Token Lexer::constructNumber(char c, const PosInStream &cPos) {
@@ -342,12 +391,12 @@ Token Lexer::constructNumber(char c, const PosInStream &cPos) {
 
     while (true) {
         char prevCh = c;
-        c = source_.getChar();
+        c = nextChar();
         assertIntNumberLength(++length);
 
         if (isdigit(c)) {
             if (value == 0) { // first digit is 0 and is not followed by dot
-                ErrorHandler::handleFromLexer("First digit is 0 and is not followed by dot in number!");
+                reportError("First digit is 0 and is not followed by dot in number!");
             }
             ++digitsInBlocks.back();
             if (
@@ -357,7 +406,7 @@ Token Lexer::constructNumber(char c, const PosInStream &cPos) {
                     || digitsInBlocks[0] > 3
                 )
             ) {
-                ErrorHandler::handleFromLexer("Digit block in number longer than 3 digits!");
+                reportError("Digit block in number longer than 3 digits!");
             }
             value = value * 10 + c - '0';
             continue;
@@ -366,19 +415,19 @@ Token Lexer::constructNumber(char c, const PosInStream &cPos) {
         switch (c) {
             case ' ': // this could be the space ending the number
                 if (!isdigit(prevCh)) {
-                    ErrorHandler::handleFromLexer("Digit block separator not following a digit in number!");
+                    reportError("Digit block separator not following a digit in number!");
                 }
                 digitsInBlocks.emplace_back(0);
                 break;
 
             case '.': {
                 if (!isdigit(prevCh)) {
-                    ErrorHandler::handleFromLexer("Dot not following a digit in number!");
+                    reportError("Dot not following a digit in number!");
                 }
 
                 auto [intValue, intLength] = parseIntFromSource();
                 if (intLength == 0) {
-                    ErrorHandler::handleFromLexer("Fraction part is empty in number!");
+                    reportError("Fraction part is empty in number!");
                 }
                 int divisor = 1;
                 for (; intLength > 0; --intLength) {
@@ -390,9 +439,9 @@ Token Lexer::constructNumber(char c, const PosInStream &cPos) {
             }
 
             default:
-                source_.ungetChar(c); // number can be followed by a unit
+                ungetChar(c); // number can be followed by a unit
                 if (prevCh == ' ') {
-                    source_.ungetChar(prevCh);
+                    ungetChar(prevCh);
                 }
                 return { TokenType::NUMBER, value, cPos };
         }
@@ -404,9 +453,9 @@ Lexer::IntWithLength Lexer::parseIntFromSource() {
     int length = 0;
 
     while (true) {
-        char c = source_.getChar();
+        char c = nextChar();
         if (!isdigit(c)) {
-            source_.ungetChar(c);
+            ungetChar(c);
             return { value, length };
         }
         assertPostDotNumberLength(++length);
@@ -418,7 +467,7 @@ void Lexer::assertIdLength(unsigned int length) const {
     if (length > MAX_ID_LENGTH) {
         std::ostringstream msg;
         msg << "Id too long! Max: " << MAX_ID_LENGTH << "chars";
-        ErrorHandler::handleFromLexer(msg.str());
+        reportError(msg.str());
     }
 }
 
@@ -426,7 +475,7 @@ void Lexer::assertIntNumberLength(unsigned int length) const {
     if (length > MAX_INT_NUMBER_LENGTH) {
         std::ostringstream msg;
         msg << "Number too long! Max: " << MAX_INT_NUMBER_LENGTH << "chars";
-        ErrorHandler::handleFromLexer(msg.str());
+        reportError(msg.str());
     }
 }
 
@@ -434,7 +483,7 @@ void Lexer::assertPostDotNumberLength(unsigned int length) const {
     if (length > MAX_POST_DOT_NUMBER_LENGTH) {
         std::ostringstream msg;
         msg << "Fraction number too long! Max: " << MAX_POST_DOT_NUMBER_LENGTH << "chars";
-        ErrorHandler::handleFromLexer(msg.str());
+        reportError(msg.str());
     }
 }
 
@@ -442,6 +491,6 @@ void Lexer::assertStringLength(unsigned int length) const {
     if (length > MAX_STRING_LITERAL_LENGTH) {
         std::ostringstream msg;
         msg << "String literal too long! Max: " << MAX_STRING_LITERAL_LENGTH << "chars";
-        ErrorHandler::handleFromLexer(msg.str());
+        reportError(msg.str());
     }
 }
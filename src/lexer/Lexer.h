@@ -3,6 +3,13 @@
 
 #include "TokenSource.h"
 #include "source/Source.h"
+#include <cstddef>
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
 
 class Lexer : public TokenSource {
 public:
@@ -12,11 +19,47 @@ public:
     const unsigned int MAX_STRING_LITERAL_LENGTH = 250;
 
 public:
-    explicit Lexer(Source &source) : source_(source) {}
+    // Sources backed by a contiguous buffer (see BufferSource) are scanned
+    // directly in span mode; other sources are read char by char.
+    explicit Lexer(Source &source);
+    // span mode over an in-memory input; the input must outlive the Lexer
+    explicit Lexer(std::string_view input);
+    Lexer(const Lexer &) = delete;
+    Lexer& operator=(const Lexer &) = delete;
 
     Token getToken() override;
 
+    const std::vector<Token>& getStringParts() const override {
+        return stringParts_;
+    }
+
+    bool isSpanMode() const noexcept {
+        return source_ == nullptr;
+    }
+
 private:
+    char nextChar() {
+        if (!source_) {
+            return cursor_ < input_.size() ? input_[cursor_++] : (++cursor_, EOF);
+        }
+        return source_->getChar();
+    }
+
+    void ungetChar(char c) {
+        if (!source_) {
+            --cursor_;
+            return;
+        }
+        source_->ungetChar(c);
+    }
+
+    // position of the last char returned by nextChar()
+    PosInStream currentPosition() const;
+    PosInStream positionOfOffset(std::size_t offset) const;
+    [[noreturn]] void reportError(const std::string &msg) const;
+    // returns a view of text that lives as long as the Lexer
+    std::string_view intern(std::string_view text);
+
     char discardWhitespacesAndComments();
     bool discardComment();
     void discardInstrBreak();
@@ -44,11 +87,26 @@ private:
     void assertStringLength(unsigned int length) const;
 
 private:
-    Source &source_;
-    mutable char currChar_;
+    // streaming mode; nullptr in span mode
+    Source *source_ = nullptr;
+
+    // span mode
+    std::string_view input_;
+    std::size_t cursor_ = 0;
+    // last computed position; positions are computed lazily, only for
+    // emitted tokens and errors, by scanning from the closest known offset
+    mutable std::size_t knownOffset_ = 0;
+    mutable unsigned int knownLine_ = 1;
+    mutable std::size_t knownLineStart_ = 0;
 
-    static const std::unordered_map<std::string, TokenType> keywords_;
-    static const std::unordered_map<std::string, Unit> units_;
+    // inner tokens of STRING tokens
+    std::vector<Token> stringParts_;
+    // lexemes that are not views into input_: ids read in streaming mode
+    // and string literals containing escape sequences
+    std::unordered_set<std::string_view> internedLexemes_;
+    std::deque<std::string> internStorage_;
+    // reused buffer for lexemes that have to be assembled char by char
+    std::string scratch_;
 };
 
 #endif // TKOMSIUNITS_LEXER_H_INCLUDED
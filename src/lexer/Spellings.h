@@ -0,0 +1,152 @@
+#ifndef TKOMSIUNITS_SPELLINGS_H_INCLUDED
+#define TKOMSIUNITS_SPELLINGS_H_INCLUDED
+
+#include "Token.h"
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+// Compile-time classification of identifier-like lexemes into keywords and
+// units. Neither needs heap allocation nor static initialization at startup.
+
+struct KeywordSpelling {
+    std::string_view spelling;
+    TokenType type;
+};
+
+inline constexpr std::array<KeywordSpelling, 14> keywordSpellings {{
+    { "array"    , TokenType::KEYWORD_ARRAY    },
+    { "bool"     , TokenType::KEYWORD_BOOL     },
+    { "break"    , TokenType::KEYWORD_BREAK    },
+    { "continue" , TokenType::KEYWORD_CONTINUE },
+    { "elif"     , TokenType::KEYWORD_ELIF     },
+    { "else"     , TokenType::KEYWORD_ELSE     },
+    { "false"    , TokenType::KEYWORD_FALSE    },
+    { "func"     , TokenType::KEYWORD_FUNC     },
+    { "if"       , TokenType::KEYWORD_IF       },
+    { "in"       , TokenType::KEYWORD_IN       },
+    { "return"   , TokenType::KEYWORD_RETURN   },
+    { "str"      , TokenType::KEYWORD_STR      },
+    { "true"     , TokenType::KEYWORD_TRUE     },
+    { "while"    , TokenType::KEYWORD_WHILE    }
+}};
+
+inline constexpr std::size_t KEYWORD_HASH_TABLE_SIZE = 32;
+
+// perfect for keywordSpellings (checked below), so a lookup is one hash
+// and one string comparison
+constexpr std::size_t keywordHash(std::string_view lexeme) {
+    return (static_cast<unsigned char>(lexeme.front()) * 5
+            + static_cast<unsigned char>(lexeme.back()) * 19
+            + lexeme.size()) % KEYWORD_HASH_TABLE_SIZE;
+}
+
+// empty spelling marks a free slot
+constexpr std::array<KeywordSpelling, KEYWORD_HASH_TABLE_SIZE> createKeywordHashTable() {
+    std::array<KeywordSpelling, KEYWORD_HASH_TABLE_SIZE> table{};
+    for (const KeywordSpelling &keyword : keywordSpellings) {
+        table[keywordHash(keyword.spelling)] = keyword;
+    }
+    return table;
+}
+
+inline constexpr auto keywordHashTable = createKeywordHashTable();
+
+constexpr bool isKeywordHashPerfect() {
+    for (const KeywordSpelling &keyword : keywordSpellings) {
+        if (keywordHashTable[keywordHash(keyword.spelling)].spelling != keyword.spelling) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(isKeywordHashPerfect(), "keywordHash has collisions; adjust its multipliers");
+
+// returns keyword entry with spelling in static storage
+constexpr std::optional<KeywordSpelling> classifyKeyword(std::string_view lexeme) {
+    if (lexeme.empty()) {
+        return std::nullopt;
+    }
+    const KeywordSpelling &entry = keywordHashTable[keywordHash(lexeme)];
+    if (entry.spelling == lexeme) {
+        return entry;
+    }
+    return std::nullopt;
+}
+
+constexpr std::optional<UnitPrefix> classifyUnitPrefix(std::string_view lexeme) {
+    switch (lexeme.size()) {
+        case 0:
+            return UnitPrefix::NONE;
+        case 1:
+            switch (lexeme[0]) {
+                case 'T': return UnitPrefix::TERA;
+                case 'G': return UnitPrefix::GIGA;
+                case 'M': return UnitPrefix::MEGA;
+                case 'k': return UnitPrefix::KILO;
+                case 'h': return UnitPrefix::HECTO;
+                case 'd': return UnitPrefix::DECI;
+                case 'c': return UnitPrefix::CENTI;
+                case 'm': return UnitPrefix::MILLI;
+                default: return std::nullopt;
+            }
+        case 2:
+            if (lexeme == "da") {
+                return UnitPrefix::DECA;
+            }
+            return std::nullopt;
+        default:
+            return std::nullopt;
+    }
+}
+
+// Unit spelling is [prefix] base_unit [power]. No base unit is a suffix of
+// another one, so the spelling is split unambiguously from the back.
+constexpr std::optional<Unit> classifyUnit(std::string_view lexeme) {
+    // longest spelling is e.g. "daPa3"
+    if (lexeme.empty() || lexeme.size() > 5) {
+        return std::nullopt;
+    }
+    Unit unit{};
+    switch (lexeme.back()) {
+        case '2': unit.power = 2; lexeme.remove_suffix(1); break;
+        case '3': unit.power = 3; lexeme.remove_suffix(1); break;
+        default: unit.power = 1;
+    }
+    if (lexeme.empty()) {
+        return std::nullopt;
+    }
+    switch (lexeme.back()) {
+        case 's': unit.unit = UnitType::SECOND; break;
+        case 'g': unit.unit = UnitType::GRAM; break;
+        case 'm': unit.unit = UnitType::METER; break;
+        case 'N': unit.unit = UnitType::NEWTON; break;
+        case 'J': unit.unit = UnitType::JOULE; break;
+        case 'a':
+            if (lexeme.size() >= 2 && lexeme[lexeme.size() - 2] == 'P') {
+                unit.unit = UnitType::PASCAL;
+                lexeme.remove_suffix(1);
+                break;
+            }
+            return std::nullopt;
+        default:
+            return std::nullopt;
+    }
+    lexeme.remove_suffix(1);
+    std::optional<UnitPrefix> prefix = classifyUnitPrefix(lexeme);
+    if (!prefix) {
+        return std::nullopt;
+    }
+    unit.prefix = *prefix;
+    return unit;
+}
+
+static_assert(classifyKeyword("while")->type == TokenType::KEYWORD_WHILE);
+static_assert(!classifyKeyword("whilee") && !classifyKeyword("e"));
+static_assert(classifyUnit("daPa3")->unit == UnitType::PASCAL);
+static_assert(classifyUnit("mm2")->prefix == UnitPrefix::MILLI);
+static_assert(!classifyUnit("Pa4") && !classifyUnit("a") && !classifyUnit("2"));
+
+#endif // TKOMSIUNITS_SPELLINGS_H_INCLUDED
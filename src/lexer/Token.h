@@ -1,15 +1,17 @@
 #ifndef TKOMSIUNITS_TOKEN_H_INCLUDED
 #define TKOMSIUNITS_TOKEN_H_INCLUDED
 
-#include <string>
-#include <unordered_map>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
 #include <variant>
-#include <vector>
 
 enum class TokenType {
     ID,
     NUMBER,
     UNIT,
+    KEYWORD_ARRAY,
     KEYWORD_BOOL,
     KEYWORD_BREAK,
     KEYWORD_CONTINUE,
@@ -45,7 +47,7 @@ enum class TokenType {
     END_OF_STREAM
 };
 
-enum class UnitType {
+enum class UnitType : std::uint8_t {
     SECOND,
     GRAM,
     METER,
@@ -54,33 +56,65 @@ enum class UnitType {
     JOULE
 };
 
-const std::unordered_map<std::string, double> unitPrefixes {
-    { "T", 1'000'000'000'000.0 },
-    { "G", 1'000'000'000.0 },
-    { "M", 1'000'000.0 },
-    { "k", 1'000.0 },
-    { "h", 100.0 },
-    { "da", 10.0 },
-    { "", 1.0 },
-    { "d", 0.1 },
-    { "c", 0.01 },
-    { "m", 0.001 }
+inline constexpr std::size_t unitTypesCount = static_cast<std::size_t>(UnitType::JOULE) + 1;
+
+enum class UnitPrefix : std::uint8_t {
+    TERA,
+    GIGA,
+    MEGA,
+    KILO,
+    HECTO,
+    DECA,
+    NONE,
+    DECI,
+    CENTI,
+    MILLI
 };
 
+struct UnitPrefixInfo {
+    std::string_view symbol;
+    double scale;
+};
+
+inline constexpr std::array<UnitPrefixInfo, 10> unitPrefixes {{
+    { "T" , 1'000'000'000'000.0 },
+    { "G" , 1'000'000'000.0 },
+    { "M" , 1'000'000.0 },
+    { "k" , 1'000.0 },
+    { "h" , 100.0 },
+    { "da", 10.0 },
+    { ""  , 1.0 },
+    { "d" , 0.1 },
+    { "c" , 0.01 },
+    { "m" , 0.001 }
+}};
+
+constexpr std::string_view prefixSymbol(UnitPrefix prefix) {
+    return unitPrefixes[static_cast<std::size_t>(prefix)].symbol;
+}
+
+constexpr double prefixScale(UnitPrefix prefix) {
+    return unitPrefixes[static_cast<std::size_t>(prefix)].scale;
+}
+
 struct Unit {
-    std::string prefix = std::string("");
+    UnitPrefix prefix = UnitPrefix::NONE;
     UnitType unit;
     int power = 1;
 };
 
-struct Token;
-
+// Inner tokens of a STRING token are kept out-of-line, in the side table
+// of the TokenSource that produced it (see TokenSource::getStringParts()).
 struct String {
-    std::vector<Token> innerTokens;
+    std::uint32_t firstPart = 0;
+    std::uint32_t partsCount = 0;
 };
 
 struct PosInStream;
 
+// Tokens are trivially copyable: identifiers, keywords, operators and text
+// are views into the source buffer, the lexer's intern pool or static
+// storage, and stay valid as long as the TokenSource that produced them.
 struct Token {
     struct Position {
         Position (const PosInStream &pos);
@@ -91,7 +125,7 @@ struct Token {
     };
     
     TokenType type;
-    std::variant<std::string, int, double, Unit, String> value;
+    std::variant<std::monostate, std::string_view, int, double, Unit, String> value;
     Position pos = {0,0};
 };
 
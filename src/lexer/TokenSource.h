@@ -2,11 +2,19 @@
 #define TKOMSIUNITS_TOKEN_SOURCE_H_INCLUDED
 
 #include "Token.h"
+#include <vector>
 
 class TokenSource {
 public: 
     virtual Token getToken() = 0;
 
+    // side table holding inner tokens of all STRING tokens produced so far;
+    // a STRING token refers to its parts by String::firstPart/partsCount
+    virtual const std::vector<Token>& getStringParts() const {
+        static const std::vector<Token> noParts;
+        return noParts;
+    }
+
 public:
     virtual ~TokenSource() = default;
 };
@@ -1,13 +1,58 @@
 #include "source/Source.h"
 #include "source/StringSource.h"
 #include "Lexer.h"
+#include "error/LexerError.h"
 #include "utils/printUtils.h"
 #include <memory>
+#include <sstream>
 #include <unordered_map>
+#include <vector>
 #include <gtest/gtest.h>
 
+namespace {
+
+// Source without a contiguous buffer; makes the Lexer run in streaming mode
+class StreamingStringSource : public Source {
+public:
+    explicit StreamingStringSource(const std::string &str) : chars_(str) {}
+
+private:
+    char provideChar() override {
+        return pos_ < chars_.size() ? chars_[pos_++] : EOF;
+    }
+
+    std::string chars_;
+    std::size_t pos_ = 0;
+};
+
+std::vector<Token> lexAll(Lexer &lexer) {
+    std::vector<Token> tokens;
+    do {
+        tokens.push_back(lexer.getToken());
+    } while (tokens.back().type != TokenType::END_OF_STREAM);
+    return tokens;
+}
+
+std::string tokenValueToString(const Lexer &lexer, const Token &token) {
+    if (token.type == TokenType::STRING) {
+        std::ostringstream os;
+        const std::vector<Token> &parts = lexer.getStringParts();
+        String str = std::get<String>(token.value);
+        for (std::size_t i = str.firstPart; i < str.firstPart + str.partsCount; ++i) {
+            os << parts[i] << ' ';
+        }
+        return os.str();
+    }
+    std::ostringstream os;
+    os << token;
+    return os.str();
+}
+
+} // anonymous namespace
+
 TEST(LexerTests, Keywords) {
     std::unordered_map<std::string, TokenType> keywords = {
+        { "array"    , TokenType::KEYWORD_ARRAY    },
         { "bool"     , TokenType::KEYWORD_BOOL     },
         { "break"    , TokenType::KEYWORD_BREAK    },
         { "continue" , TokenType::KEYWORD_CONTINUE },
@@ -61,14 +106,14 @@ TEST(LexerTests, IdsThatStartLikeKeywords) {
 
 TEST(LexerTests, Units) {
     std::array units = {
-        std::pair{ "mm3", Unit{"m", UnitType::METER , 3} },
-        std::pair{ "mm2", Unit{"m", UnitType::METER , 2} },
-        std::pair{ "mm" , Unit{"m", UnitType::METER , 1} },
-        std::pair{ "m"  , Unit{"" , UnitType::METER , 1} },
-        std::pair{ "kg" , Unit{"k", UnitType::GRAM  , 1} },
-        std::pair{ "MN" , Unit{"M", UnitType::NEWTON, 1} },
-        std::pair{ "J"  , Unit{"" , UnitType::JOULE , 1} },
-        std::pair{ "kPa", Unit{"k", UnitType::PASCAL, 1} }
+        std::pair{ "mm3", Unit{UnitPrefix::MILLI, UnitType::METER , 3} },
+        std::pair{ "mm2", Unit{UnitPrefix::MILLI, UnitType::METER , 2} },
+        std::pair{ "mm" , Unit{UnitPrefix::MILLI, UnitType::METER , 1} },
+        std::pair{ "m"  , Unit{UnitPrefix::NONE , UnitType::METER , 1} },
+        std::pair{ "kg" , Unit{UnitPrefix::KILO, UnitType::GRAM  , 1} },
+        std::pair{ "MN" , Unit{UnitPrefix::MEGA, UnitType::NEWTON, 1} },
+        std::pair{ "J"  , Unit{UnitPrefix::NONE , UnitType::JOULE , 1} },
+        std::pair{ "kPa", Unit{UnitPrefix::KILO, UnitType::PASCAL, 1} }
     };
 
     for (const auto &[str, expectedUnit] : units) {
@@ -158,3 +203,141 @@ TEST(LexerTests, Numbers) {
         EXPECT_EQ(TokenType::END_OF_STREAM, token.type) << "not met for: " << input;
     }
 }
+
+TEST(LexerTests, BufferSourcesAreLexedInSpanMode) {
+    StringSource strSrc("a = 1");
+    Lexer spanLexer(strSrc);
+    EXPECT_TRUE(spanLexer.isSpanMode());
+
+    StreamingStringSource streamSrc("a = 1");
+    Lexer streamLexer(streamSrc);
+    EXPECT_FALSE(streamLexer.isSpanMode());
+}
+
+TEST(LexerTests, SpanAndStreamingModesProduceSameTokens) {
+    std::string input =
+        "func f (steps [1]) -> [m/s2] {\n"
+        "    // comment\n"
+        "    x = 1 000.25[kg] * 2[mm3] / 3 \\\n"
+        "        + 4 >= 5 && 6 != 7 || 8 == 9 - 1\n"
+        "    print(\"x = {x} \\\"{ y }\\t\")\n"
+        "    return x--\n"
+        "}\n";
+    StringSource strSrc(input);
+    Lexer spanLexer(strSrc);
+    StreamingStringSource streamSrc(input);
+    Lexer streamLexer(streamSrc);
+
+    std::vector<Token> spanTokens = lexAll(spanLexer);
+    std::vector<Token> streamTokens = lexAll(streamLexer);
+    ASSERT_EQ(streamTokens.size(), spanTokens.size());
+    for (std::size_t i = 0; i < spanTokens.size(); ++i) {
+        EXPECT_EQ(streamTokens[i].type, spanTokens[i].type) << "token " << i;
+        EXPECT_EQ(tokenValueToString(streamLexer, streamTokens[i]), tokenValueToString(spanLexer, spanTokens[i])) << "token " << i;
+    }
+}
+
+TEST(LexerTests, SpanModeTokenPositions) {
+    std::string input = "ab = 12[m]\n\n  if \"x{ab}\"\n";
+    Lexer lexer(std::string_view{input});
+    std::vector<std::tuple<TokenType, unsigned int, unsigned int>> expected = {
+        { TokenType::ID                 , 1, 1  },
+        { TokenType::ASSIGN             , 1, 4  },
+        { TokenType::NUMBER             , 1, 6  },
+        { TokenType::SQUARE_OPEN        , 1, 8  },
+        { TokenType::UNIT               , 1, 9  },
+        { TokenType::SQUARE_CLOSE       , 1, 10 },
+        { TokenType::END_OF_INSTRUCTION , 1, 11 },
+        { TokenType::END_OF_INSTRUCTION , 2, 1  },
+        { TokenType::KEYWORD_IF         , 3, 3  },
+        { TokenType::STRING             , 3, 6  },
+        { TokenType::END_OF_INSTRUCTION , 3, 13 },
+        { TokenType::END_OF_STREAM      , 4, 1  }
+    };
+    for (const auto &[type, line, column] : expected) {
+        Token token = lexer.getToken();
+        EXPECT_EQ(type, token.type);
+        EXPECT_EQ(line, token.pos.line) << "not met for: " << type;
+        EXPECT_EQ(column, token.pos.column) << "not met for: " << type;
+    }
+}
+
+TEST(LexerTests, LexerErrorsReportPosition) {
+    std::string input = "a = 1\nb = 2 & 3\n";
+    Lexer lexer(std::string_view{input});
+    try {
+        lexAll(lexer);
+        FAIL() << "expected LexerError";
+    } catch (const LexerError &err) {
+        EXPECT_EQ(2u, err.getLine());
+        EXPECT_EQ(8u, err.getColumn());
+    }
+}
+
+TEST(LexerTests, StringPartsAreKeptInSideTable) {
+    std::string input = "\"ab {x} c\\td\" \"{x}\"";
+    Lexer lexer(std::string_view{input});
+    Token first = lexer.getToken();
+    Token second = lexer.getToken();
+    ASSERT_EQ(TokenType::STRING, first.type);
+    ASSERT_EQ(TokenType::STRING, second.type);
+
+    const std::vector<Token> &parts = lexer.getStringParts();
+    String firstStr = std::get<String>(first.value);
+    String secondStr = std::get<String>(second.value);
+    ASSERT_EQ(5u, firstStr.partsCount);
+    ASSERT_EQ(3u, secondStr.partsCount);
+    EXPECT_EQ(firstStr.firstPart + firstStr.partsCount, secondStr.firstPart);
+
+    std::string_view verbatimText = std::get<std::string_view>(parts[firstStr.firstPart].value);
+    EXPECT_EQ("ab ", verbatimText);
+    // text without escape sequences is a view into the input
+    EXPECT_EQ(input.data() + 1, verbatimText.data());
+    EXPECT_EQ(TokenType::BRACKET_OPEN, parts[firstStr.firstPart + 1].type);
+    EXPECT_EQ("x", std::get<std::string_view>(parts[firstStr.firstPart + 2].value));
+    EXPECT_EQ(TokenType::BRACKET_CLOSE, parts[firstStr.firstPart + 3].type);
+    EXPECT_EQ(" c\td", std::get<std::string_view>(parts[firstStr.firstPart + 4].value));
+}
+
+TEST(LexerTests, StreamingModeInternsIds) {
+    StreamingStringSource src("abc = abc + abc_2");
+    Lexer lexer(src);
+    std::vector<Token> tokens = lexAll(lexer);
+    ASSERT_EQ(6u, tokens.size());
+    std::string_view firstId = std::get<std::string_view>(tokens[0].value);
+    std::string_view secondId = std::get<std::string_view>(tokens[2].value);
+    EXPECT_EQ("abc", firstId);
+    EXPECT_EQ(firstId.data(), secondId.data());
+    EXPECT_EQ("abc_2", std::get<std::string_view>(tokens[4].value));
+}
+
+TEST(LexerTests, AllUnitSpellings) {
+    std::array baseUnits = {
+        std::pair{ "s" , UnitType::SECOND },
+        std::pair{ "g" , UnitType::GRAM   },
+        std::pair{ "m" , UnitType::METER  },
+        std::pair{ "N" , UnitType::NEWTON },
+        std::pair{ "Pa", UnitType::PASCAL },
+        std::pair{ "J" , UnitType::JOULE  }
+    };
+    std::array powers = {
+        std::pair{ "" , 1 },
+        std::pair{ "2", 2 },
+        std::pair{ "3", 3 }
+    };
+
+    for (std::size_t prefIdx = 0; prefIdx < unitPrefixes.size(); ++prefIdx) {
+        for (const auto &[base, unitType] : baseUnits) {
+            for (const auto &[powerStr, power] : powers) {
+                std::string spelling = std::string(unitPrefixes[prefIdx].symbol) + base + powerStr;
+                Lexer lexer{std::string_view{spelling}};
+                Token token = lexer.getToken();
+                ASSERT_EQ(TokenType::UNIT, token.type) << "not met for: " << spelling;
+                Unit unit = std::get<Unit>(token.value);
+                EXPECT_EQ(static_cast<UnitPrefix>(prefIdx), unit.prefix) << "not met for: " << spelling;
+                EXPECT_EQ(unitType, unit.unit) << "not met for: " << spelling;
+                EXPECT_EQ(power, unit.power) << "not met for: " << spelling;
+            }
+        }
+    }
+}
@@ -1,30 +1,77 @@
-#include "codeObjects/Interpreter.h"
-#include "parser/Parser.h"
-#include "lexer/Lexer.h"
-#include "source/Source.h"
-#include "source/FileSource.h"
+#include "unitslang/UnitsLang.h"
+#include "cache/ProgramCache.h"
+#include "source/MappedFileSource.h"
+#include "sink/FdSink.h"
 #include "utils/printUtils.h"
+#include <charconv>
+#include <cstddef>
 #include <iostream>
 #include <memory>
+#include <optional>
+#include <string_view>
+#include <unistd.h>
 
 int main(int argc, char** argv) {
-    if (argc != 2) {
-        std::cerr << "Usage: " << argv[0] << " <path-to-input-file-to-analyze-lexically>"
+    // --vm executes the program compiled to bytecode instead of walking the code objects tree
+    // --flat walks the code objects laid out in flat arrays (FlatTree) instead
+    // --memoize memoizes calls of functions whose result depends only on their arguments
+    // --max-call-depth=<n> limits nesting of function calls; the VM keeps call frames on the heap,
+    // so it can run deeper recursion than the tree walker and the flat tree, which report exhaustion
+    // of the native stack instead
+    // --cache-dir=<dir> keeps parsed programs in the directory, so that unchanged sources are not parsed again
+    static constexpr std::string_view maxCallDepthOption = "--max-call-depth=";
+    static constexpr std::string_view cacheDirOption = "--cache-dir=";
+    bool useVm = false;
+    bool useFlatTree = false;
+    bool memoize = false;
+    std::size_t maxCallDepth = Interpreter::DEFAULT_MAX_CALL_DEPTH;
+    std::optional<ProgramCache> cache;
+    bool isUsageValid = argc >= 2;
+    for (int i = 1; i < argc - 1; ++i) {
+        std::string_view option(argv[i]);
+        if (option == "--vm") {
+            useVm = true;
+        } else if (option == "--flat") {
+            useFlatTree = true;
+        } else if (option == "--memoize") {
+            memoize = true;
+        } else if (option.substr(0, maxCallDepthOption.size()) == maxCallDepthOption) {
+            std::string_view value = option.substr(maxCallDepthOption.size());
+            auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), maxCallDepth);
+            isUsageValid = isUsageValid && error == std::errc() && end == value.data() + value.size();
+        } else if (option.substr(0, cacheDirOption.size()) == cacheDirOption && option.size() > cacheDirOption.size()) {
+            cache.emplace(std::string(option.substr(cacheDirOption.size())));
+        } else {
+            isUsageValid = false;
+        }
+    }
+    if (!isUsageValid || (useVm && useFlatTree)) {
+        std::cerr << "Usage: " << argv[0] << " [--vm | --flat] [--memoize] [--max-call-depth=<n>] [--cache-dir=<dir>] <path-to-input-file-to-analyze-lexically>"
             << std::endl;
         return 1;
     }
 
-    std::unique_ptr<Source> src = std::make_unique<FileSource>(argv[1]);
-    Lexer lexer(*src);
-    Parser parser(lexer);
-
-    std::unique_ptr<Program> program = nullptr;
+    unitslang::Engine engine = useVm ? unitslang::Engine::VM
+        : useFlatTree ? unitslang::Engine::FLAT_TREE
+        : unitslang::Engine::TREE_WALKER;
+    std::unique_ptr<MappedFileSource> src = nullptr;
+    std::optional<unitslang::CompiledProgram> program;
     try {
-        program = parser.parse();
+        src = std::make_unique<MappedFileSource>(argv[argc - 1]);
+        if (cache) {
+            program = unitslang::compile(cache->load(src->getBuffer()), engine);
+        } else {
+            program = unitslang::compile(src->getBuffer(), {}, engine);
+        }
     } catch (const std::exception &ex) {
         std::cerr << ex.what() << std::endl;
         return 1;
     }
-    Interpreter interp(std::cout, *program.get());
-    return interp.executeProgram();
-}
\ No newline at end of file
+    // print() output is written with write(2); a terminal gets every line immediately,
+    // a file or a pipe gets it in large chunks
+    FdSink stdoutSink(STDOUT_FILENO, ::isatty(STDOUT_FILENO) ? 0 : Sink::DEFAULT_BUFFER_SIZE);
+    unitslang::Runner runner;
+    runner.setMemoization(memoize);
+    runner.setMaxCallDepth(maxCallDepth);
+    return runner.run(*program, {}, stdoutSink);
+}
@@ -2,6 +2,7 @@
 
 #include "codeObjects/VarReference.h"
 #include "codeObjects/Value.h"
+#include "codeObjects/Literal.h"
 #include "codeObjects/Return.h"
 #include "codeObjects/Break.h"
 #include "codeObjects/Continue.h"
@@ -40,7 +41,6 @@ Token Parser::requireToken(TokenType expected) {
 
 template <std::size_t N>
 void Parser::reportUnexpectedToken(const std::array<TokenType, N> &expected) {
-    std::cout << "unexpected token\n";
     std::ostringstream os;
     os << "Unexpected token: {" << currToken_ << "}, expecting: [";
     for (const auto &tokenType : expected) {
@@ -50,7 +50,10 @@ void Parser::reportUnexpectedToken(const std::array<TokenType, N> &expected) {
     ErrorHandler::handleFromParser(os.str());
 }
 
-std::unique_ptr<Program> Parser::parse() {
+std::unique_ptr<Program> Parser::parse(std::vector<Variable> inputs) {
+    // code objects are allocated in the arena of the program, which is released after them
+    auto arena = std::make_unique<NodeArena>();
+    NodeArena::Scope arenaScope(*arena);
     std::unique_ptr<Instruction> instr;
     std::unique_ptr<FuncDef> funcDef;
     std::vector<std::unique_ptr<Instruction>> instructions;
@@ -68,10 +71,30 @@ std::unique_ptr<Program> Parser::parse() {
 
     return std::make_unique<Program>(
             std::move(funcDefs),
-            std::move(instructions)
+            std::move(instructions),
+            std::move(arena),
+            std::move(inputs)
         );
 }
 
+Variable Parser::parseVariableDeclaration() {
+    advance();
+    if (currToken_.type != TokenType::ID) {
+        ErrorHandler::handleFromParser("Variable declaration does not start with a name");
+    }
+    std::string name(std::get<std::string_view>(currToken_.value));
+    advance();
+
+    std::optional<Type> type = parseType();
+    if (!type) {
+        ErrorHandler::handleFromParser("Variable name '" + name + "' not followed by type");
+    }
+    if (currToken_.type != TokenType::END_OF_STREAM) {
+        ErrorHandler::handleFromParser("Variable declaration of '" + name + "' followed by other tokens");
+    }
+    return Variable(name, std::move(*type));
+}
+
 std::unique_ptr<Instruction> Parser::parseInstruction() {
     std::unique_ptr<Instruction> instr = nullptr; 
     
@@ -161,7 +184,7 @@ std::unique_ptr<FuncCall> Parser::tryParseFuncCall(Token id) {
     }
 
     requireToken(TokenType::PAREN_CLOSE);
-    return std::make_unique<FuncCall>(std::get<std::string>(id.value), std::move(arguments));
+    return std::make_unique<FuncCall>(std::string(std::get<std::string_view>(id.value)), std::move(arguments));
 }
 
 std::unique_ptr<VarDefOrAssignment> Parser::tryParseVarDefOrAssignment(Token id) {
@@ -180,7 +203,7 @@ std::unique_ptr<VarDefOrAssignment> Parser::tryParseVarDefOrAssignment(Token id)
         ErrorHandler::handleFromParser("Expected expression after '=' in variable definition");
     }
 
-    return std::make_unique<VarDefOrAssignment>(std::get<std::string>(id.value), std::move(expr), std::move(type));
+    return std::make_unique<VarDefOrAssignment>(std::string(std::get<std::string_view>(id.value)), std::move(expr), std::move(type));
 }
 
 std::unique_ptr<If> Parser::tryParseIfInstr() {
@@ -277,10 +300,10 @@ std::unique_ptr<Expression> Parser::parseRelExpression() {
     switch (currToken_.type) {
         case TokenType::KEYWORD_TRUE:
             advance();
-            return std::make_unique<Value>(true);
+            return std::make_unique<Literal>(Value(true));
         case TokenType::KEYWORD_FALSE:
             advance();
-            return std::make_unique<Value>(false);
+            return std::make_unique<Literal>(Value(false));
         default:
             return parseXXXBinaryExpression(
                     &Parser::parseAddExpression, TokenType::OP_REL,
@@ -312,7 +335,7 @@ std::unique_ptr<Expression> Parser::parseExpressionElement() {
             advance();
             element = tryParseFuncCall(id);
             if (!element) {
-                element = std::make_unique<VarReference>(std::get<std::string>(id.value));
+                element = std::make_unique<VarReference>(std::string(std::get<std::string_view>(id.value)));
             }
             break;
         }
@@ -322,15 +345,25 @@ std::unique_ptr<Expression> Parser::parseExpressionElement() {
             requireToken(TokenType::PAREN_CLOSE);
             break;
         case TokenType::NUMBER: {
-            double numberValue;
-            if (std::holds_alternative<double>(currToken_.value)) {
-                numberValue = std::get<double>(currToken_.value);
-            } else {
-                numberValue = std::get<int>(currToken_.value);
-            }
+            double numberValue = parseNumber();
+            codeobj::Unit unit = parseUnit();
+            element = std::make_unique<Literal>(Value(numberValue, Type(std::move(unit))));
+            break;
+        }
+        case TokenType::SQUARE_OPEN: {
+            // array of numbers with the unit of its elements, e.g. "[1, -2.5, 4][m]"
             advance();
+            std::vector<double> elements;
+            if (currToken_.type != TokenType::SQUARE_CLOSE) {
+                elements.push_back(parseArrayElement());
+                while (currToken_.type == TokenType::COMMA) {
+                    advance();
+                    elements.push_back(parseArrayElement());
+                }
+            }
+            requireToken(TokenType::SQUARE_CLOSE);
             codeobj::Unit unit = parseUnit();
-            element = std::make_unique<Value>(numberValue, Type(std::move(unit)));
+            element = std::make_unique<Literal>(Value(std::move(elements), Type(Type::ARRAY, std::move(unit))));
             break;
         }
         default:
@@ -339,19 +372,40 @@ std::unique_ptr<Expression> Parser::parseExpressionElement() {
     return element;
 }
 
+double Parser::parseNumber() {
+    Token number = requireToken(TokenType::NUMBER);
+    if (std::holds_alternative<double>(number.value)) {
+        return std::get<double>(number.value);
+    }
+    return std::get<int>(number.value);
+}
+
+double Parser::parseArrayElement() {
+    if (currToken_.type == TokenType::OP_ADD) {
+        bool isNegative = std::get<std::string_view>(currToken_.value) == "-";
+        advance();
+        return isNegative ? -parseNumber() : parseNumber();
+    }
+    return parseNumber();
+}
+
 std::unique_ptr<codeobj::String> Parser::parseString() {
     assert(currToken_.type == TokenType::STRING);
     String strToken = std::get<String>(currToken_.value);
+    const std::vector<Token> &stringParts = tokenSource_.getStringParts();
+    assert(strToken.firstPart + strToken.partsCount <= stringParts.size());
+    auto partsBegin = stringParts.cbegin() + strToken.firstPart;
+    auto partsEnd = partsBegin + strToken.partsCount;
     std::vector<std::unique_ptr<Expression>> parts;
     std::optional<TokenType> expected = std::nullopt;
     
-    for (auto iter = strToken.innerTokens.begin(); iter != strToken.innerTokens.end(); ++iter) {
+    for (auto iter = partsBegin; iter != partsEnd; ++iter) {
         if (expected && iter->type != expected) {
             ErrorHandler::handleFromParser("Wrong formatted string format");
         }
         switch (iter->type) {
             case TokenType::TEXT_WITHIN_STRING:
-                parts.emplace_back(std::make_unique<Value>(std::get<std::string>(iter->value)));
+                parts.emplace_back(std::make_unique<Literal>(Value(std::string(std::get<std::string_view>(iter->value)))));
                 break;
             case TokenType::BRACKET_OPEN:
                 expected = TokenType::ID;
@@ -361,7 +415,7 @@ std::unique_ptr<codeobj::String> Parser::parseString() {
                     ErrorHandler::handleFromParser("Wrong formatted string format: Id not inside '{}'");
                 }
                 expected = TokenType::BRACKET_CLOSE;
-                parts.emplace_back(std::make_unique<VarReference>(std::get<std::string>(iter->value)));
+                parts.emplace_back(std::make_unique<VarReference>(std::string(std::get<std::string_view>(iter->value))));
                 break;
             case TokenType::BRACKET_CLOSE:
                 if (!expected) {
@@ -444,6 +498,15 @@ Type Parser::parseTypeTokens() {
         case TokenType::KEYWORD_BOOL:
             advance();
             return Type(Type::BOOL);
+        case TokenType::KEYWORD_ARRAY: {
+            // "[array 1]" or "[array <unit>]"
+            advance();
+            Type elementType = parseTypeTokens();
+            if (elementType.getTypeClass() != Type::NUMBER) {
+                ErrorHandler::handleFromParser("Elements of array can only be numbers");
+            }
+            return Type(Type::ARRAY, std::move(elementType.asUnit()));
+        }
          case TokenType::KEYWORD_STR:
             advance();
             return Type(Type::STRING);
@@ -495,7 +558,7 @@ std::unique_ptr<FuncDef> Parser::parseFuncDef() {
     requireToken(TokenType::END_OF_INSTRUCTION);
 
     return std::make_unique<FuncDef>(
-            std::get<std::string>(id.value),
+            std::string(std::get<std::string_view>(id.value)),
             std::move(parameters),
             std::move(returnType),
             std::move(body)
@@ -506,7 +569,7 @@ std::optional<Variable> Parser::parseFuncParameter() {
     if (currToken_.type != TokenType::ID) {
         return std::nullopt;
     }
-    std::string paramName = std::get<std::string>(currToken_.value);
+    std::string paramName(std::get<std::string_view>(currToken_.value));
     advance();
 
     std::optional<Type> type = parseType();
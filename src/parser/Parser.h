@@ -18,12 +18,16 @@
 #include "codeObjects/String.h"
 #include <memory>
 #include <optional>
+#include <vector>
 
 class Parser {
 public:
     Parser(TokenSource &tokenSource);
     
-    std::unique_ptr<Program> parse();
+    // inputs: global variables with values provided for every execution (Program::getInputs())
+    std::unique_ptr<Program> parse(std::vector<Variable> inputs = {});
+    // whole source is one declaration '<name> [<type>]', e.g. "mass [kg]"
+    Variable parseVariableDeclaration();
 
 protected:
     void advance();
@@ -39,6 +43,9 @@ protected:
     std::unique_ptr<Expression> parseMultExpression();
     std::unique_ptr<Expression> parseExpressionElement();
     std::unique_ptr<codeobj::String> parseString();
+    double parseNumber();
+    // number literal with an optional sign
+    double parseArrayElement();
 
     codeobj::Unit parseUnit();
     codeobj::Unit parseComplexUnitTokens();
@@ -6,6 +6,7 @@
 #include "codeObjects/Return.h"
 #include "codeObjects/Break.h"
 #include "codeObjects/Continue.h"
+#include "codeObjects/Literal.h"
 
 #include <memory>
 #include <unordered_map>
@@ -17,7 +18,7 @@
 const std::unordered_map<std::string, Token> tokens {
     { "1"        , {TokenType::NUMBER             , 1   } },
     { "a"        , {TokenType::ID                 , "a" } },
-    { "u"        , {TokenType::UNIT               , Unit{"", UnitType::METER, 1}} },
+    { "u"        , {TokenType::UNIT               , Unit{UnitPrefix::NONE, UnitType::METER, 1}} },
     { "*"        , {TokenType::OP_MULT            , "*" } },
     { "/"        , {TokenType::OP_MULT            , "/" } },
     { "+"        , {TokenType::OP_ADD             , "+" } },
@@ -37,6 +38,7 @@ const std::unordered_map<std::string, Token> tokens {
     { "]"        , {TokenType::SQUARE_CLOSE       , ""  } },
     { "\n"       , {TokenType::END_OF_INSTRUCTION , ""  } },
     // keywords
+    { "array"    , {TokenType::KEYWORD_ARRAY      , ""  } },
     { "bool"     , {TokenType::KEYWORD_BOOL       , ""  } },
     { "break"    , {TokenType::KEYWORD_BREAK      , ""  } },
     { "continue" , {TokenType::KEYWORD_CONTINUE   , ""  } },
@@ -67,7 +69,7 @@ public:
         if (pos < tokenSeq_.size()) {
             return tokenSeq_[pos++];
         }
-        return { TokenType::END_OF_STREAM, "" };
+        return { TokenType::END_OF_STREAM, {} };
     }
 
 private:
@@ -620,3 +622,67 @@ TEST(ParserTests, ScalarTypeIsOnly1InSquares) {
         }
     }
 }
+
+TEST(ParserTests, RedefinedFunctionFollowedByOthers) {
+    // functions not added to the program yet are released before its arena
+    std::string input = "func a () {\n}\nfunc a () {\n}\nfunc b () {\n}\nfunc c () {\n}\n";
+    StringSource src(input);
+    Lexer lexer(src);
+    Parser parser(lexer);
+    EXPECT_THROW(parser.parse(), std::runtime_error);
+}
+
+TEST(ParserTests, VariableDeclaration) {
+    std::array inputs = {
+        std::tuple{ "mass [kg]"   , "mass[(kg)/()]", true  },
+        std::tuple{ "flag [bool]" , "flag[bool]"   , true  },
+        std::tuple{ "mass"        , ""             , false },
+        std::tuple{ "[kg]"        , ""             , false },
+        std::tuple{ "mass [kg] a" , ""             , false }
+    };
+
+    for (const auto &[str, expectedStr, isCorrect] : inputs) {
+        std::unique_ptr<Source> src = std::make_unique<StringSource>(str);
+        Lexer lexer(*src);
+        Parser parser(lexer);
+        if (!isCorrect) {
+            EXPECT_THROW(parser.parseVariableDeclaration(), std::runtime_error) << "not met for: " << str;
+        } else {
+            EXPECT_EQ(expectedStr, parser.parseVariableDeclaration().toString()) << "not met for: " << str;
+        }
+    }
+}
+
+TEST(ParserTests, ArrayLiteralAndType) {
+    std::array inputs = {
+        std::tuple{ "a = [1, -2.5, +3][m]\n", "[1, -2.5, 3][(m)/()]" },
+        std::tuple{ "a = [4]\n"             , "[4]"                   },
+        std::tuple{ "a = [][s]\n"           , "[][(s)/()]"            }
+    };
+    for (const auto &[str, expectedStr] : inputs) {
+        StringSource src(str);
+        Lexer lexer(src);
+        Parser parser(lexer);
+        std::unique_ptr<Program> program = parser.parse();
+        auto &instr = dynamic_cast<VarDefOrAssignment &>(*program->getInstructions().getInstructions().front());
+        auto &literal = dynamic_cast<Literal &>(instr.getExpr());
+        EXPECT_EQ(Type::ARRAY, literal.getValue().type.getTypeClass()) << "not met for: " << str;
+        EXPECT_EQ(expectedStr, literal.getValue().toString()) << "not met for: " << str;
+    }
+
+    for (auto [str, isCorrect] : { std::pair{ "[array m/s]", true }, std::pair{ "[array 1]", true },
+                                   std::pair{ "[array bool]", false }, std::pair{ "[array]", false } }) {
+        StringSource src(str);
+        Lexer lexer(src);
+        TestParser parser(lexer);
+        parser.advance();
+        if (!isCorrect) {
+            EXPECT_THROW(parser.parseType(), std::runtime_error) << "not met for: " << str;
+            continue;
+        }
+        std::optional<Type> type = parser.parseType();
+        ASSERT_TRUE(type.has_value());
+        EXPECT_EQ(Type::ARRAY, type->getTypeClass()) << "not met for: " << str;
+        EXPECT_EQ(str == std::string("[array 1]") ? "[array 1]" : "[array (m)/(s)]", type->toString());
+    }
+}
@@ -0,0 +1,21 @@
+#include "FdSink.h"
+#include <cerrno>
+#include <stdexcept>
+#include <unistd.h>
+
+FdSink::~FdSink() {
+    flushOnDestruction();
+}
+
+void FdSink::writeOut(std::string_view data) {
+    while (!data.empty()) {
+        ssize_t bytesWritten = ::write(fd_, data.data(), data.size());
+        if (bytesWritten < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("Cannot write output");
+        }
+        data.remove_prefix(static_cast<std::size_t>(bytesWritten));
+    }
+}
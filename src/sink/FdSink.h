@@ -0,0 +1,22 @@
+#ifndef TKOMSIUNITS_FDSINK_H_INCLUDED
+#define TKOMSIUNITS_FDSINK_H_INCLUDED
+
+#include "Sink.h"
+
+// Sink writing directly to a file descriptor with write(2), bypassing iostreams;
+// meant for stdout redirected to a file or a pipe. Does not own the descriptor.
+class FdSink : public Sink {
+public:
+    explicit FdSink(int fd, std::size_t bufferSize = DEFAULT_BUFFER_SIZE)
+        : Sink(bufferSize)
+        , fd_(fd) {}
+    ~FdSink() override;
+
+private:
+    void writeOut(std::string_view data) override;
+
+private:
+    int fd_;
+};
+
+#endif // TKOMSIUNITS_FDSINK_H_INCLUDED
@@ -0,0 +1,39 @@
+#include "Sink.h"
+
+Sink::~Sink() {}
+
+void Sink::write(std::string_view text) {
+    buffer_.append(text);
+    if (buffer_.size() >= bufferSize_) {
+        flush();
+    }
+}
+
+void Sink::writeLine(std::string_view text) {
+    buffer_.append(text);
+    buffer_.push_back('\n');
+    if (buffer_.size() >= bufferSize_) {
+        flush();
+    }
+}
+
+void Sink::flush() {
+    if (buffer_.empty()) {
+        return;
+    }
+    // output is not repeated by the next flush if writing it fails
+    try {
+        writeOut(buffer_);
+    } catch (...) {
+        buffer_.clear();
+        throw;
+    }
+    buffer_.clear();
+}
+
+void Sink::flushOnDestruction() noexcept {
+    try {
+        flush();
+    } catch (...) {
+    }
+}
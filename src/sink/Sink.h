@@ -0,0 +1,41 @@
+#ifndef TKOMSIUNITS_SINK_H_INCLUDED
+#define TKOMSIUNITS_SINK_H_INCLUDED
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Destination of program output. Output is collected in a buffer and written out
+// when the buffer reaches its size, on flush() and when the sink is destroyed;
+// buffer size 0 writes out every write() immediately.
+class Sink {
+public:
+    static constexpr std::size_t DEFAULT_BUFFER_SIZE = 64 * 1024;
+
+    explicit Sink(std::size_t bufferSize = DEFAULT_BUFFER_SIZE)
+        : bufferSize_(bufferSize) {}
+    Sink(const Sink &) = delete;
+    Sink& operator=(const Sink &) = delete;
+    virtual ~Sink();
+
+    void write(std::string_view text);
+    void writeLine(std::string_view text);
+    void flush();
+
+    std::size_t getBufferSize() const noexcept {
+        return bufferSize_;
+    }
+
+protected:
+    // for destructors of derived classes - errors cannot be reported there
+    void flushOnDestruction() noexcept;
+
+private:
+    virtual void writeOut(std::string_view data) = 0;
+
+private:
+    std::string buffer_;
+    std::size_t bufferSize_;
+};
+
+#endif // TKOMSIUNITS_SINK_H_INCLUDED
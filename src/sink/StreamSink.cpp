@@ -0,0 +1,10 @@
+#include "StreamSink.h"
+
+StreamSink::~StreamSink() {
+    flushOnDestruction();
+}
+
+void StreamSink::writeOut(std::string_view data) {
+    os_.write(data.data(), static_cast<std::streamsize>(data.size()));
+    os_.flush();
+}
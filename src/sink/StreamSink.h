@@ -0,0 +1,22 @@
+#ifndef TKOMSIUNITS_STREAMSINK_H_INCLUDED
+#define TKOMSIUNITS_STREAMSINK_H_INCLUDED
+
+#include "Sink.h"
+#include <ostream>
+
+// Sink writing to std::ostream; the stream is flushed together with the sink.
+class StreamSink : public Sink {
+public:
+    explicit StreamSink(std::ostream &os, std::size_t bufferSize = DEFAULT_BUFFER_SIZE)
+        : Sink(bufferSize)
+        , os_(os) {}
+    ~StreamSink() override;
+
+private:
+    void writeOut(std::string_view data) override;
+
+private:
+    std::ostream &os_;
+};
+
+#endif // TKOMSIUNITS_STREAMSINK_H_INCLUDED
@@ -0,0 +1,64 @@
+#include "Sink.h"
+#include "StreamSink.h"
+#include "FdSink.h"
+#include <sstream>
+#include <string>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+TEST(SinkTests, OutputIsBufferedUntilFlush) {
+    std::ostringstream os;
+    StreamSink sink(os);
+    sink.writeLine("first");
+    sink.write("second");
+    EXPECT_EQ("", os.str());
+    sink.flush();
+    EXPECT_EQ("first\nsecond", os.str());
+    sink.flush();
+    EXPECT_EQ("first\nsecond", os.str());
+}
+
+TEST(SinkTests, BufferIsWrittenOutWhenFull) {
+    std::ostringstream os;
+    StreamSink sink(os, 8);
+    sink.writeLine("abc");
+    EXPECT_EQ("", os.str());
+    sink.writeLine("defg");
+    EXPECT_EQ("abc\ndefg\n", os.str());
+}
+
+TEST(SinkTests, ZeroBufferSizeWritesOutImmediately) {
+    std::ostringstream os;
+    StreamSink sink(os, 0);
+    sink.writeLine("line");
+    EXPECT_EQ("line\n", os.str());
+}
+
+TEST(SinkTests, OutputIsFlushedOnDestruction) {
+    std::ostringstream os;
+    {
+        StreamSink sink(os);
+        sink.writeLine("line");
+    }
+    EXPECT_EQ("line\n", os.str());
+}
+
+TEST(SinkTests, FdSinkWritesToDescriptor) {
+    int fds[2];
+    ASSERT_EQ(0, ::pipe(fds));
+    {
+        FdSink sink(fds[1]);
+        sink.writeLine("to");
+        sink.writeLine("pipe");
+    }
+    ::close(fds[1]);
+
+    std::string output;
+    char buffer[64];
+    ssize_t bytesRead;
+    while ((bytesRead = ::read(fds[0], buffer, sizeof(buffer))) > 0) {
+        output.append(buffer, static_cast<std::size_t>(bytesRead));
+    }
+    ::close(fds[0]);
+    EXPECT_EQ("to\npipe\n", output);
+}
@@ -0,0 +1,9 @@
+#include "BufferSource.h"
+#include <cstdio>
+
+char BufferSource::provideChar() {
+    if (pos_ >= buffer_.size()) {
+        return EOF;
+    }
+    return buffer_[pos_++];
+}
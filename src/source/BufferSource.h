@@ -0,0 +1,34 @@
+#ifndef TKOMSIUNITS_BUFFERSOURCE_H_INCLUDED
+#define TKOMSIUNITS_BUFFERSOURCE_H_INCLUDED
+
+#include "Source.h"
+#include <cstddef>
+#include <string_view>
+
+// Source whose whole input is available as one contiguous span of chars.
+// Derived classes own the storage and hand a view of it to setBuffer().
+class BufferSource : public Source {
+public:
+    BufferSource() = default;
+    BufferSource(const BufferSource &) = delete;
+    BufferSource& operator=(const BufferSource &) = delete;
+
+    std::string_view getBuffer() const noexcept {
+        return buffer_;
+    }
+
+protected:
+    void setBuffer(std::string_view buffer) noexcept {
+        buffer_ = buffer;
+        pos_ = 0;
+    }
+
+private:
+    char provideChar() override;
+
+private:
+    std::string_view buffer_;
+    std::size_t pos_ = 0;
+};
+
+#endif // TKOMSIUNITS_BUFFERSOURCE_H_INCLUDED
@@ -0,0 +1,70 @@
+#include "MappedFileSource.h"
+#include <cerrno>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFileSource::MappedFileSource(const std::string &filename)
+    : filename_(filename) {
+    int fd = ::open(filename_.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::string errorMsg = "Cannot open file " + filename_;
+        throw std::runtime_error(errorMsg);
+    }
+    try {
+        if (!tryMap(fd)) {
+            readAll(fd);
+        }
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    // the mapping stays valid after the descriptor is closed
+    ::close(fd);
+}
+
+MappedFileSource::~MappedFileSource() {
+    if (mapping_) {
+        ::munmap(mapping_, mappingSize_);
+    }
+}
+
+bool MappedFileSource::tryMap(int fd) {
+    struct stat fileStat;
+    if (::fstat(fd, &fileStat) != 0 || !S_ISREG(fileStat.st_mode) || fileStat.st_size <= 0) {
+        return false;
+    }
+    std::size_t size = static_cast<std::size_t>(fileStat.st_size);
+    void *mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+    ::madvise(mapping, size, MADV_SEQUENTIAL);
+    mapping_ = mapping;
+    mappingSize_ = size;
+    setBuffer({ static_cast<const char *>(mapping_), mappingSize_ });
+    return true;
+}
+
+void MappedFileSource::readAll(int fd) {
+    std::size_t size = 0;
+    while (true) {
+        readBuffer_.resize(size + READ_CHUNK_SIZE);
+        ssize_t bytesRead = ::read(fd, readBuffer_.data() + size, READ_CHUNK_SIZE);
+        if (bytesRead < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::string errorMsg = "Cannot read file " + filename_;
+            throw std::runtime_error(errorMsg);
+        }
+        if (bytesRead == 0) {
+            break;
+        }
+        size += static_cast<std::size_t>(bytesRead);
+    }
+    readBuffer_.resize(size);
+    setBuffer(readBuffer_);
+}
@@ -0,0 +1,33 @@
+#ifndef TKOMSIUNITS_MAPPEDFILESOURCE_H_INCLUDED
+#define TKOMSIUNITS_MAPPEDFILESOURCE_H_INCLUDED
+
+#include "BufferSource.h"
+#include <cstddef>
+#include <string>
+
+// Maps the whole file into memory. Inputs that cannot be mapped (pipes,
+// character devices, empty files) are read into an owned buffer instead.
+class MappedFileSource : public BufferSource {
+public:
+    static constexpr std::size_t READ_CHUNK_SIZE = 64 * 1024;
+
+public:
+    MappedFileSource(const std::string &filename);
+    ~MappedFileSource();
+
+    bool isMapped() const noexcept {
+        return mapping_ != nullptr;
+    }
+
+private:
+    bool tryMap(int fd);
+    void readAll(int fd);
+
+private:
+    std::string filename_;
+    void *mapping_ = nullptr;
+    std::size_t mappingSize_ = 0;
+    std::string readBuffer_;
+};
+
+#endif // TKOMSIUNITS_MAPPEDFILESOURCE_H_INCLUDED
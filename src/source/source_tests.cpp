@@ -1,6 +1,11 @@
 #include "Source.h"
 #include "StringSource.h"
+#include "MappedFileSource.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
 #include <gtest/gtest.h>
+#include <unistd.h>
 
 bool operator==(const PosInStream &lhs, const PosInStream &rhs) {
     return lhs.lineNumber == rhs.lineNumber && lhs.posInLine == rhs.posInLine;
@@ -55,3 +60,50 @@ TEST(SourceTests, GetCurrentPositionReturnsCorrectPos) {
         ASSERT_EQ(src->getCurrentPosition(), (PosInStream{4, i}));
     }
 }
+
+TEST(SourceTests, MappedFileSourceExposesWholeFile) {
+    std::string testString = "abc\nd\nefg\nhij";
+    std::string filename = testing::TempDir() + "mapped_source_test.txt";
+    {
+        std::ofstream file(filename, std::ios::out | std::ios::binary);
+        file << testString;
+    }
+    MappedFileSource fileSrc(filename);
+    Source *src = &fileSrc;
+
+    EXPECT_TRUE(fileSrc.isMapped());
+    EXPECT_EQ(testString, fileSrc.getBuffer());
+    for (char expected : testString) {
+        ASSERT_EQ(expected, src->getChar());
+    }
+    EXPECT_EQ(EOF, src->getChar());
+    EXPECT_EQ(src->getCurrentPosition(), (PosInStream{4, 4}));
+    std::remove(filename.c_str());
+}
+
+TEST(SourceTests, MappedFileSourceReadsPipes) {
+    std::string testString = "abc\nd\nefg\nhij";
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+    ASSERT_EQ(static_cast<ssize_t>(testString.size()), write(fds[1], testString.data(), testString.size()));
+    close(fds[1]);
+
+    MappedFileSource fileSrc("/dev/fd/" + std::to_string(fds[0]));
+    close(fds[0]);
+
+    EXPECT_FALSE(fileSrc.isMapped());
+    EXPECT_EQ(testString, fileSrc.getBuffer());
+    Source *src = &fileSrc;
+    for (char expected : testString) {
+        ASSERT_EQ(expected, src->getChar());
+    }
+    EXPECT_EQ(EOF, src->getChar());
+}
+
+TEST(SourceTests, MappedFileSourceThrowsForMissingFile) {
+    EXPECT_THROW({
+            MappedFileSource fileSrc("/nonexistent/path/to/script");
+        },
+        std::runtime_error
+    );
+}
@@ -0,0 +1,108 @@
+#include "unitslang/ParameterSweep.h"
+#include "source/MappedFileSource.h"
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+bool parseNumber(std::string_view value, std::size_t &number) {
+    auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), number);
+    return error == std::errc() && end == value.data() + value.size();
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    // runs the script once for every row of the table, with the columns as its input
+    // variables (header declares them, e.g. "mass [kg],time [s]"), and writes the table
+    // with values of the output variables and exit status of every run as CSV to stdout;
+    // errors of the runs are written to stderr after the number of their row
+    // --outputs=<declarations> global variables written for every row, separated by commas,
+    // e.g. "--outputs=speed [m/s],isFast [bool]"; numbers are converted to the declared units
+    // --threads=<n> number of threads running the rows, by default one per hardware thread
+    // other options are the same as of main
+    static constexpr std::string_view outputsOption = "--outputs=";
+    static constexpr std::string_view threadsOption = "--threads=";
+    static constexpr std::string_view maxCallDepthOption = "--max-call-depth=";
+    std::size_t threadsCount = std::max(std::thread::hardware_concurrency(), 1u);
+    bool useVm = false;
+    bool useFlatTree = false;
+    bool memoize = false;
+    std::size_t maxCallDepth = Interpreter::DEFAULT_MAX_CALL_DEPTH;
+    std::string_view outputsDeclarations;
+    bool isUsageValid = argc >= 3;
+    for (int i = 1; i < argc - 2; ++i) {
+        std::string_view option(argv[i]);
+        if (option == "--vm") {
+            useVm = true;
+        } else if (option == "--flat") {
+            useFlatTree = true;
+        } else if (option == "--memoize") {
+            memoize = true;
+        } else if (option.substr(0, outputsOption.size()) == outputsOption) {
+            outputsDeclarations = option.substr(outputsOption.size());
+        } else if (option.substr(0, threadsOption.size()) == threadsOption) {
+            isUsageValid = isUsageValid && parseNumber(option.substr(threadsOption.size()), threadsCount) && threadsCount > 0;
+        } else if (option.substr(0, maxCallDepthOption.size()) == maxCallDepthOption) {
+            isUsageValid = isUsageValid && parseNumber(option.substr(maxCallDepthOption.size()), maxCallDepth);
+        } else {
+            isUsageValid = false;
+        }
+    }
+    if (!isUsageValid || (useVm && useFlatTree)) {
+        std::cerr << "Usage: " << argv[0]
+            << " [--outputs=<declarations>] [--threads=<n>] [--vm | --flat] [--memoize] [--max-call-depth=<n>] <script-file> <table-file>"
+            << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> outputsHeader;
+    std::vector<Variable> outputs;
+    unitslang::Table table;
+    std::vector<unitslang::RowResult> results;
+    try {
+        if (!outputsDeclarations.empty()) {
+            outputsHeader = unitslang::readCsvRecords(outputsDeclarations).front();
+        }
+        for (auto &&declaration : outputsHeader) {
+            outputs.push_back(unitslang::parseDeclaration(declaration));
+        }
+        MappedFileSource tableFile(argv[argc - 1]);
+        table = unitslang::readTable(tableFile.getBuffer());
+        // the script is analysed once, the rows only bind other values of the inputs
+        MappedFileSource scriptFile(argv[argc - 2]);
+        unitslang::CompiledProgram program = unitslang::compile(
+                scriptFile.getBuffer(),
+                table.columns,
+                useVm ? unitslang::Engine::VM : useFlatTree ? unitslang::Engine::FLAT_TREE : unitslang::Engine::TREE_WALKER
+            );
+        unitslang::ParameterSweep sweep(threadsCount);
+        sweep.setMemoization(memoize);
+        sweep.setMaxCallDepth(maxCallDepth);
+        results = sweep.run(program, table, outputs);
+    } catch (const std::exception &ex) {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    unitslang::ParameterSweep::writeCsv(std::cout, table, outputsHeader, results);
+    std::cout.flush();
+    // fails if any run failed
+    int exitStatus = 0;
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        if (!results[i].errors.empty()) {
+            std::cerr << "row " << i + 1 << ": " << results[i].errors;
+        }
+        if (results[i].exitStatus != 0) {
+            exitStatus = 1;
+        }
+    }
+    return exitStatus;
+}
@@ -0,0 +1,59 @@
+#include "BatchRunner.h"
+
+#include "sink/StreamSink.h"
+#include "source/MappedFileSource.h"
+#include <exception>
+#include <memory>
+#include <sstream>
+
+namespace unitslang {
+
+BatchRunner::BatchRunner(std::size_t threadsCount)
+    : threads_(threadsCount) {}
+
+std::vector<ScriptResult> BatchRunner::runSources(const std::vector<std::string> &sources) const {
+    return runAll(sources.size(), [this, &sources](std::size_t index, Runner &runner) {
+            return runSource(runner, sources[index]);
+        });
+}
+
+std::vector<ScriptResult> BatchRunner::runFiles(const std::vector<std::string> &paths) const {
+    return runAll(paths.size(), [this, &paths](std::size_t index, Runner &runner) {
+            std::unique_ptr<MappedFileSource> file;
+            try {
+                file = std::make_unique<MappedFileSource>(paths[index]);
+            } catch (const std::exception &ex) {
+                return ScriptResult{ 1, "", std::string(ex.what()) + '\n' };
+            }
+            return runSource(runner, file->getBuffer());
+        });
+}
+
+std::vector<ScriptResult> BatchRunner::runAll(std::size_t count, const ScriptRun &runScript) const {
+    std::vector<ScriptResult> results(count);
+    threads_.forEach(count, [&results, &runScript](std::size_t index, Runner &runner) {
+            results[index] = runScript(index, runner);
+        });
+    return results;
+}
+
+ScriptResult BatchRunner::runSource(Runner &runner, std::string_view source) const {
+    ScriptResult result;
+    std::ostringstream output;
+    std::ostringstream errors;
+    try {
+        CompiledProgram program = compile(source, {}, engine_);
+        StreamSink outputSink(output);
+        runner.setErrorStream(errors);
+        result.exitStatus = runner.run(program, {}, outputSink);
+    } catch (const std::exception &ex) {
+        // errors in the source, reported as by main
+        errors << ex.what() << std::endl;
+        result.exitStatus = 1;
+    }
+    result.output = output.str();
+    result.errors = errors.str();
+    return result;
+}
+
+} // namespace unitslang
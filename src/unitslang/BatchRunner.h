@@ -0,0 +1,60 @@
+#ifndef TKOMSIUNITS_UNITSLANG_BATCH_RUNNER_H_INCLUDED
+#define TKOMSIUNITS_UNITSLANG_BATCH_RUNNER_H_INCLUDED
+
+#include "UnitsLang.h"
+#include "RunnerThreads.h"
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace unitslang {
+
+// captured run of one script
+struct ScriptResult {
+    int exitStatus = 0;
+    std::string output;
+    // errors in the source and errors during the run
+    std::string errors;
+};
+
+// Compiles and runs independent scripts on a number of threads (RunnerThreads);
+// output of every script is captured separately.
+class BatchRunner {
+public:
+    // the calling thread is one of the threads
+    explicit BatchRunner(std::size_t threadsCount);
+
+    void setEngine(Engine engine) {
+        engine_ = engine;
+    }
+
+    void setMemoization(bool isEnabled) {
+        threads_.setMemoization(isEnabled);
+    }
+
+    void setMaxCallDepth(std::size_t depth) {
+        threads_.setMaxCallDepth(depth);
+    }
+
+    // results are in order of the scripts
+    std::vector<ScriptResult> runSources(const std::vector<std::string> &sources) const;
+    // files are read by the threads running them; files that cannot be read are
+    // reported as errors of their scripts
+    std::vector<ScriptResult> runFiles(const std::vector<std::string> &paths) const;
+
+private:
+    using ScriptRun = std::function<ScriptResult(std::size_t index, Runner &runner)>;
+
+    std::vector<ScriptResult> runAll(std::size_t count, const ScriptRun &runScript) const;
+    ScriptResult runSource(Runner &runner, std::string_view source) const;
+
+private:
+    RunnerThreads threads_;
+    Engine engine_ = Engine::TREE_WALKER;
+};
+
+} // namespace unitslang
+
+#endif // TKOMSIUNITS_UNITSLANG_BATCH_RUNNER_H_INCLUDED
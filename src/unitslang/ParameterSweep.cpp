@@ -0,0 +1,145 @@
+#include "ParameterSweep.h"
+
+#include "error/ErrorHandler.h"
+#include <array>
+#include <charconv>
+#include <sstream>
+
+namespace unitslang {
+
+namespace {
+
+class DiscardingSink : public Sink {
+private:
+    void writeOut([[maybe_unused]] std::string_view data) override {}
+};
+
+std::uint32_t findGlobal(const Program &program, const std::string &name) {
+    const std::vector<std::string> &names = program.getGlobalNames();
+    for (std::size_t slot = 0; slot < names.size(); ++slot) {
+        if (names[slot] == name) {
+            return static_cast<std::uint32_t>(slot);
+        }
+    }
+    ErrorHandler::handleVariableNotDefined("Output variable '" + name + "' is not a global variable of the program");
+}
+
+// value in the units of the declared type
+Value toDeclaredType(const Value &value, const Variable &output) {
+    const Type &type = output.getType();
+    if (value.type != type) {
+        ErrorHandler::handleTypeMismatch("Value of output variable '" + output.getName() + "' does not match its type");
+    }
+    switch (type.getTypeClass()) {
+        case Type::NUMBER:
+            return Value(value.asDouble() * value.type.asUnit().getScale() / type.asUnit().getScale(), Type(type));
+        case Type::ARRAY: {
+            std::vector<double> elements = value.asArray();
+            const double scale = value.type.asUnit().getScale() / type.asUnit().getScale();
+            for (double &element : elements) {
+                element *= scale;
+            }
+            return Value(std::move(elements), Type(type));
+        }
+        default:
+            return value;
+    }
+}
+
+std::string toField(const Value &value) {
+    if (std::holds_alternative<double>(value.value)) {
+        // shortest representation read back as the same number
+        std::array<char, 32> buffer;
+        auto [end, _] = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value.asDouble());
+        return std::string(buffer.data(), end);
+    }
+    if (std::holds_alternative<std::vector<double>>(value.value)) {
+        std::string field;
+        for (double element : value.asArray()) {
+            if (!field.empty()) {
+                field += ';';
+            }
+            field += toField(Value(element, Type(codeobj::Unit())));
+        }
+        return field;
+    }
+    if (std::holds_alternative<bool>(value.value)) {
+        return value.asBool() ? "true" : "false";
+    }
+    return value.asString();
+}
+
+} // anonymous namespace
+
+ParameterSweep::ParameterSweep(std::size_t threadsCount)
+    : threads_(threadsCount) {}
+
+std::vector<RowResult> ParameterSweep::run(const CompiledProgram &program, const Table &table, const std::vector<Variable> &outputs) const {
+    const std::vector<Variable> &inputs = program.getInputs();
+    if (inputs.size() != table.columns.size()) {
+        ErrorHandler::handleFromTable("Table has " + std::to_string(table.columns.size()) + " columns, the program has "
+            + std::to_string(inputs.size()) + " inputs");
+    }
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+        if (inputs[i].getName() != table.columns[i].getName() || inputs[i].getType() != table.columns[i].getType()) {
+            ErrorHandler::handleFromTable("Column '" + table.columns[i].getName() + "' does not match input variable '"
+                + inputs[i].getName() + "' of the program");
+        }
+    }
+    std::vector<std::uint32_t> outputSlots;
+    for (auto &&output : outputs) {
+        outputSlots.push_back(findGlobal(program.getProgram(), output.getName()));
+    }
+
+    std::vector<RowResult> results(table.rows.size());
+    threads_.forEach(table.rows.size(), [&](std::size_t index, Runner &runner) {
+            const std::vector<Value> &row = table.rows[index];
+            Bindings bindings;
+            for (std::size_t i = 0; i < row.size(); ++i) {
+                bindings.emplace(inputs[i].getName(), row[i]);
+            }
+            RowResult &result = results[index];
+            std::ostringstream errors;
+            DiscardingSink output;
+            runner.setErrorStream(errors);
+            result.exitStatus = runner.run(program, bindings, output);
+            result.outputs.resize(outputs.size());
+            for (std::size_t i = 0; i < outputs.size(); ++i) {
+                if (const Value *value = runner.getGlobal(outputSlots[i]); value) {
+                    try {
+                        result.outputs[i] = toDeclaredType(*value, outputs[i]);
+                    } catch (const std::runtime_error &ex) {
+                        errors << ex.what() << std::endl;
+                        result.exitStatus = 1;
+                    }
+                }
+            }
+            result.errors = errors.str();
+        });
+    return results;
+}
+
+void ParameterSweep::writeCsv(
+        std::ostream &os,
+        const Table &table,
+        const std::vector<std::string> &outputsHeader,
+        const std::vector<RowResult> &results
+    ) {
+    std::vector<std::string> fields = table.header;
+    fields.insert(fields.end(), outputsHeader.begin(), outputsHeader.end());
+    fields.push_back("status");
+    writeCsvRecord(os, fields);
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        fields.clear();
+        for (auto &&value : table.rows[i]) {
+            fields.push_back(toField(value));
+        }
+        for (auto &&value : results[i].outputs) {
+            fields.push_back(value ? toField(*value) : std::string());
+        }
+        fields.push_back(std::to_string(results[i].exitStatus));
+        writeCsvRecord(os, fields);
+    }
+}
+
+} // namespace unitslang
@@ -0,0 +1,58 @@
+#ifndef TKOMSIUNITS_UNITSLANG_PARAMETER_SWEEP_H_INCLUDED
+#define TKOMSIUNITS_UNITSLANG_PARAMETER_SWEEP_H_INCLUDED
+
+#include "UnitsLang.h"
+#include "RunnerThreads.h"
+#include "Table.h"
+#include <cstddef>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace unitslang {
+
+// run of the program for one row of the table
+struct RowResult {
+    int exitStatus = 0;
+    // values of the outputs, numbers in the declared units; empty if not defined by the run
+    std::vector<std::optional<Value>> outputs;
+    std::string errors;
+};
+
+// Runs a program compiled once for every row of a table of values of its inputs, the rows
+// on a number of threads (RunnerThreads), and collects values of chosen global variables
+// (outputs) left by every run. Output of print() is discarded.
+class ParameterSweep {
+public:
+    explicit ParameterSweep(std::size_t threadsCount);
+
+    void setMemoization(bool isEnabled) {
+        threads_.setMemoization(isEnabled);
+    }
+
+    void setMaxCallDepth(std::size_t depth) {
+        threads_.setMaxCallDepth(depth);
+    }
+
+    // columns of the table are the inputs of the program; outputs are global variables of
+    // the program, their values must match the declared types except for unit prefixes
+    // (a mismatch is an error of the row). Results are in order of the rows.
+    std::vector<RowResult> run(const CompiledProgram &program, const Table &table, const std::vector<Variable> &outputs) const;
+
+    // columns of the table, outputs and exit status of every run, with the header of the table
+    // followed by the output declarations; numbers without units, as in the table
+    static void writeCsv(
+            std::ostream &os,
+            const Table &table,
+            const std::vector<std::string> &outputsHeader,
+            const std::vector<RowResult> &results
+        );
+
+private:
+    RunnerThreads threads_;
+};
+
+} // namespace unitslang
+
+#endif // TKOMSIUNITS_UNITSLANG_PARAMETER_SWEEP_H_INCLUDED
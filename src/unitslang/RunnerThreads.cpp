@@ -0,0 +1,49 @@
+#include "RunnerThreads.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace unitslang {
+
+RunnerThreads::RunnerThreads(std::size_t threadsCount)
+    : threadsCount_(std::max<std::size_t>(threadsCount, 1)) {}
+
+void RunnerThreads::forEach(std::size_t count, const Task &task) const {
+    // tasks are taken one by one, so that long tasks do not hold up the others
+    std::atomic<std::size_t> next{ 0 };
+    std::mutex errorMutex;
+    std::exception_ptr error;
+    auto work = [&]() {
+            Runner runner;
+            runner.setMemoization(isMemoizing_);
+            runner.setMaxCallDepth(maxCallDepth_);
+            try {
+                for (std::size_t index = next++; index < count; index = next++) {
+                    task(index, runner);
+                }
+            } catch (...) {
+                std::lock_guard lock(errorMutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                next = count;
+            }
+        };
+    std::vector<std::thread> threads;
+    for (std::size_t i = 1; i < std::min(threadsCount_, count); ++i) {
+        threads.emplace_back(work);
+    }
+    work();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+} // namespace unitslang
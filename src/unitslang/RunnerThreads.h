@@ -0,0 +1,40 @@
+#ifndef TKOMSIUNITS_UNITSLANG_RUNNER_THREADS_H_INCLUDED
+#define TKOMSIUNITS_UNITSLANG_RUNNER_THREADS_H_INCLUDED
+
+#include "UnitsLang.h"
+#include <cstddef>
+#include <functional>
+
+namespace unitslang {
+
+// Runs independent tasks on a number of threads, every thread with its own Runner,
+// so that no mutable state is shared between the threads; the calling thread is one
+// of the threads.
+class RunnerThreads {
+public:
+    using Task = std::function<void(std::size_t index, Runner &runner)>;
+
+    explicit RunnerThreads(std::size_t threadsCount);
+
+    void setMemoization(bool isEnabled) {
+        isMemoizing_ = isEnabled;
+    }
+
+    void setMaxCallDepth(std::size_t depth) {
+        maxCallDepth_ = depth;
+    }
+
+    // runs the task for every index in [0, count), in any order, and returns when all of
+    // them finished; the first exception thrown by a task stops taking next tasks and is
+    // rethrown
+    void forEach(std::size_t count, const Task &task) const;
+
+private:
+    std::size_t threadsCount_;
+    bool isMemoizing_ = false;
+    std::size_t maxCallDepth_ = Interpreter::DEFAULT_MAX_CALL_DEPTH;
+};
+
+} // namespace unitslang
+
+#endif // TKOMSIUNITS_UNITSLANG_RUNNER_THREADS_H_INCLUDED
@@ -0,0 +1,170 @@
+#include "Table.h"
+
+#include "lexer/Lexer.h"
+#include "parser/Parser.h"
+#include "error/ErrorHandler.h"
+#include <charconv>
+
+namespace unitslang {
+
+namespace {
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+[[noreturn]] void reportInvalidField(std::size_t row, const Variable &column, const std::string &msg) {
+    ErrorHandler::handleFromTable("Row " + std::to_string(row) + ", column '" + column.getName() + "': " + msg);
+}
+
+double parseNumber(std::string_view text, std::size_t row, const Variable &column) {
+    text = trim(text);
+    double number = 0.0;
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), number);
+    if (text.empty() || error != std::errc() || end != text.data() + text.size()) {
+        reportInvalidField(row, column, "'" + std::string(text) + "' is not a number");
+    }
+    return number;
+}
+
+Value parseValue(const std::string &field, std::size_t row, const Variable &column) {
+    const Type &type = column.getType();
+    switch (type.getTypeClass()) {
+        case Type::NUMBER:
+            return Value(parseNumber(field, row, column), Type(type));
+        case Type::ARRAY: {
+            std::vector<double> elements;
+            std::string_view text(field);
+            if (!trim(text).empty()) {
+                for (std::size_t separator; (separator = text.find(';')) != std::string_view::npos; ) {
+                    elements.push_back(parseNumber(text.substr(0, separator), row, column));
+                    text.remove_prefix(separator + 1);
+                }
+                elements.push_back(parseNumber(text, row, column));
+            }
+            return Value(std::move(elements), Type(type));
+        }
+        case Type::BOOL: {
+            std::string_view text = trim(field);
+            if (text != "true" && text != "false") {
+                reportInvalidField(row, column, "'" + field + "' is not a bool value");
+            }
+            return Value(text == "true");
+        }
+        default:
+            return Value(field);
+    }
+}
+
+} // anonymous namespace
+
+Table readTable(std::string_view csv) {
+    std::vector<std::vector<std::string>> records = readCsvRecords(csv);
+    if (records.empty()) {
+        ErrorHandler::handleFromTable("Table has no header");
+    }
+    Table table;
+    table.header = std::move(records.front());
+    for (auto &&declaration : table.header) {
+        table.columns.push_back(parseDeclaration(declaration));
+        if (table.columns.back().getType().getTypeClass() == Type::VOID) {
+            ErrorHandler::handleFromTable("Variable '" + table.columns.back().getName() + "' cannot be of type void");
+        }
+    }
+    table.rows.reserve(records.size() - 1);
+    for (std::size_t i = 1; i < records.size(); ++i) {
+        if (records[i].size() != table.columns.size()) {
+            ErrorHandler::handleFromTable("Row " + std::to_string(i) + " has " + std::to_string(records[i].size())
+                + " fields instead of " + std::to_string(table.columns.size()));
+        }
+        std::vector<Value> &row = table.rows.emplace_back();
+        row.reserve(table.columns.size());
+        for (std::size_t column = 0; column < table.columns.size(); ++column) {
+            row.push_back(parseValue(records[i][column], i, table.columns[column]));
+        }
+    }
+    return table;
+}
+
+Variable parseDeclaration(std::string_view declaration) {
+    Lexer lexer(declaration);
+    Parser parser(lexer);
+    return parser.parseVariableDeclaration();
+}
+
+std::vector<std::vector<std::string>> readCsvRecords(std::string_view csv) {
+    std::vector<std::vector<std::string>> records;
+    std::vector<std::string> record;
+    std::string field;
+    bool isFieldQuoted = false;
+    std::size_t i = 0;
+    auto endRecord = [&]() {
+            // a line without any characters is not a record
+            if (!record.empty() || !field.empty() || isFieldQuoted) {
+                record.push_back(std::move(field));
+                records.push_back(std::move(record));
+            }
+            record.clear();
+            field.clear();
+            isFieldQuoted = false;
+        };
+    while (i < csv.size()) {
+        char c = csv[i++];
+        if (c == '"' && field.empty() && !isFieldQuoted) {
+            isFieldQuoted = true;
+            for (;;) {
+                if (i == csv.size()) {
+                    ErrorHandler::handleFromTable("Quoted field of row " + std::to_string(records.size()) + " is not closed");
+                }
+                c = csv[i++];
+                if (c == '"') {
+                    if (i == csv.size() || csv[i] != '"') {
+                        break;
+                    }
+                    ++i;
+                }
+                field.push_back(c);
+            }
+        } else if (c == ',') {
+            record.push_back(std::move(field));
+            field.clear();
+            isFieldQuoted = false;
+        } else if (c == '\n') {
+            endRecord();
+        } else if (c != '\r' || (i < csv.size() && csv[i] != '\n')) {
+            field.push_back(c);
+        }
+    }
+    endRecord();
+    return records;
+}
+
+void writeCsvRecord(std::ostream &os, const std::vector<std::string> &fields) {
+    for (std::size_t i = 0; i < fields.size(); ++i) {
+        if (i > 0) {
+            os << ',';
+        }
+        const std::string &field = fields[i];
+        if (field.find_first_of(",\"\r\n") == std::string::npos) {
+            os << field;
+            continue;
+        }
+        os << '"';
+        for (char c : field) {
+            if (c == '"') {
+                os << '"';
+            }
+            os << c;
+        }
+        os << '"';
+    }
+    os << '\n';
+}
+
+} // namespace unitslang
@@ -0,0 +1,37 @@
+#ifndef TKOMSIUNITS_UNITSLANG_TABLE_H_INCLUDED
+#define TKOMSIUNITS_UNITSLANG_TABLE_H_INCLUDED
+
+#include "codeObjects/Value.h"
+#include "codeObjects/Variable.h"
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace unitslang {
+
+// Values of input variables of a program, a row for every run. Read from CSV whose
+// header declares the variables as in the language, e.g. "mass [kg],time [s],label [str]";
+// numbers are written without units, in the declared ones, elements of arrays are
+// separated by ';' (e.g. "1;2.5;4" in a "samples [array m]" column), bool values as true/false.
+struct Table {
+    // declarations as written in the header
+    std::vector<std::string> header;
+    std::vector<Variable> columns;
+    std::vector<std::vector<Value>> rows;
+};
+
+// errors are reported with the row and column they were found in
+Table readTable(std::string_view csv);
+
+// '<name> [<type>]', e.g. "speed [m/s]"
+Variable parseDeclaration(std::string_view declaration);
+
+// fields of a CSV record (RFC 4180); records are separated by new lines, empty lines are skipped
+std::vector<std::vector<std::string>> readCsvRecords(std::string_view csv);
+// fields are quoted when needed
+void writeCsvRecord(std::ostream &os, const std::vector<std::string> &fields);
+
+} // namespace unitslang
+
+#endif // TKOMSIUNITS_UNITSLANG_TABLE_H_INCLUDED
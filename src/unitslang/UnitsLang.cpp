@@ -0,0 +1,97 @@
+#include "UnitsLang.h"
+
+#include "lexer/Lexer.h"
+#include "parser/Parser.h"
+#include "vm/Compiler.h"
+#include "vm/VirtualMachine.h"
+#include "flat/FlatTreeBuilder.h"
+#include "flat/FlatEvaluator.h"
+#include "error/ErrorHandler.h"
+#include <algorithm>
+
+namespace unitslang {
+
+namespace {
+
+std::vector<Value> bindInputs(const std::vector<Variable> &inputs, const Bindings &bindings) {
+    std::vector<Value> values;
+    values.reserve(inputs.size());
+    for (auto &&input : inputs) {
+        auto binding = bindings.find(input.getName());
+        if (binding == bindings.end()) {
+            ErrorHandler::handleVariableNotDefined("No value bound to input variable '" + input.getName() + "'");
+        }
+        if (binding->second.type != input.getType()) {
+            ErrorHandler::handleTypeMismatch("Value bound to input variable '" + input.getName() + "' does not match its type");
+        }
+        values.push_back(binding->second);
+    }
+    if (bindings.size() != inputs.size()) {
+        for (auto &&[name, _] : bindings) {
+            (void)_;
+            auto isInput = [&name = name](const Variable &input) { return input.getName() == name; };
+            if (std::find_if(inputs.begin(), inputs.end(), isInput) == inputs.end()) {
+                ErrorHandler::handleVariableNotDefined("Value bound to not-defined input variable '" + name + "'");
+            }
+        }
+    }
+    return values;
+}
+
+} // anonymous namespace
+
+CompiledProgram::CompiledProgram(std::unique_ptr<Program> &&program, Engine engine)
+    : program_(std::move(program))
+    , engine_(engine) {
+    if (engine_ == Engine::VM) {
+        bytecode_ = Compiler::compile(*program_);
+    } else if (engine_ == Engine::FLAT_TREE) {
+        flatTree_ = FlatTreeBuilder::build(*program_);
+    }
+}
+
+CompiledProgram compile(std::string_view source, std::vector<Variable> inputs, Engine engine) {
+    Lexer lexer(source);
+    Parser parser(lexer);
+    return compile(parser.parse(std::move(inputs)), engine);
+}
+
+CompiledProgram compile(std::unique_ptr<Program> &&program, Engine engine) {
+    return CompiledProgram(std::move(program), engine);
+}
+
+int Runner::run(const CompiledProgram &program, const Bindings &bindings, Sink &output) {
+    std::vector<Value> inputValues = bindInputs(program.getInputs(), bindings);
+    if (interpreter_) {
+        interpreter_->reset(output, program.getProgram());
+    } else {
+        interpreter_.emplace(output, program.getProgram());
+    }
+    interpreter_->setErrorStream(*errorStream_);
+    interpreter_->setMemoization(isMemoizing_);
+    interpreter_->setMaxCallDepth(maxCallDepth_);
+    interpreter_->setInputValues(std::move(inputValues));
+    switch (program.getEngine()) {
+        case Engine::VM:
+            return VirtualMachine(*interpreter_, *program.bytecode_).execute();
+        case Engine::FLAT_TREE:
+            return FlatEvaluator(*interpreter_, *program.flatTree_).execute();
+        default:
+            return interpreter_->executeProgram();
+    }
+}
+
+const Value* Runner::getGlobal(std::uint32_t slot) const {
+    if (!interpreter_ || slot >= interpreter_->getProgram().getGlobalNames().size()) {
+        return nullptr;
+    }
+    const std::optional<Value> &value = interpreter_->getGlobalSlot(slot);
+    return value ? &*value : nullptr;
+}
+
+int run(const CompiledProgram &program, const Bindings &bindings, Sink &output) {
+    Runner runner;
+    return runner.run(program, bindings, output);
+}
+
+} // namespace unitslang
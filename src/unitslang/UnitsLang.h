@@ -0,0 +1,111 @@
+#ifndef TKOMSIUNITS_UNITSLANG_UNITSLANG_H_INCLUDED
+#define TKOMSIUNITS_UNITSLANG_UNITSLANG_H_INCLUDED
+
+#include "codeObjects/Interpreter.h"
+#include "codeObjects/Program.h"
+#include "codeObjects/Value.h"
+#include "codeObjects/Variable.h"
+#include "flat/FlatTree.h"
+#include "sink/Sink.h"
+#include "vm/Bytecode.h"
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Interface of the interpreter for embedding it in other programs: a source is compiled
+// once and the compiled program is run any number of times with different values of
+// its input variables.
+namespace unitslang {
+
+enum class Engine {
+    TREE_WALKER,    // Interpreter::executeProgram()
+    VM,             // VirtualMachine
+    FLAT_TREE       // FlatEvaluator
+};
+
+// values of input variables of a program by their names
+using Bindings = std::unordered_map<std::string, Value>;
+
+// Program parsed and analysed once, prepared for execution by the engine;
+// not modified by running it
+class CompiledProgram {
+public:
+    const Program& getProgram() const {
+        return *program_;
+    }
+
+    const std::vector<Variable>& getInputs() const {
+        return program_->getInputs();
+    }
+
+    Engine getEngine() const {
+        return engine_;
+    }
+
+private:
+    CompiledProgram(std::unique_ptr<Program> &&program, Engine engine);
+
+private:
+    std::unique_ptr<Program> program_;
+    Engine engine_;
+    std::optional<BytecodeProgram> bytecode_;
+    std::optional<FlatTree> flatTree_;
+
+    friend CompiledProgram compile(std::unique_ptr<Program> &&program, Engine engine);
+    friend class Runner;
+};
+
+// inputs: global variables defined before the first instruction, with values bound for every run;
+// errors in the source are reported the same way as by the Parser
+CompiledProgram compile(std::string_view source, std::vector<Variable> inputs = {}, Engine engine = Engine::TREE_WALKER);
+// program parsed by the caller, e.g. loaded from ProgramCache
+CompiledProgram compile(std::unique_ptr<Program> &&program, Engine engine = Engine::TREE_WALKER);
+
+// Runs compiled programs with one Interpreter, reset before every run instead of
+// constructed again, so that its memory is reused. A CompiledProgram is not modified
+// by running it, so Runners of different threads may run the same one concurrently;
+// a Runner itself is used by one thread at a time.
+class Runner {
+public:
+    // bindings provide values of all inputs of the program, with types matching the
+    // declared ones except for unit prefixes; other bindings are reported as errors before
+    // the program is run. Errors during the run are reported to the error stream and result
+    // in exit status 1, as by Interpreter::executeProgram(). Output of the program is flushed.
+    int run(const CompiledProgram &program, const Bindings &bindings, Sink &output);
+
+    // value of the global variable (slot of Program::getGlobalNames()) left by the last run,
+    // also a failed one; nullptr if the variable was not defined
+    const Value* getGlobal(std::uint32_t slot) const;
+
+    // std::cerr by default
+    void setErrorStream(std::ostream &errorStream) {
+        errorStream_ = &errorStream;
+    }
+
+    void setMemoization(bool isEnabled) {
+        isMemoizing_ = isEnabled;
+    }
+
+    void setMaxCallDepth(std::size_t depth) {
+        maxCallDepth_ = depth;
+    }
+
+private:
+    std::optional<Interpreter> interpreter_;
+    std::ostream *errorStream_ = &std::cerr;
+    bool isMemoizing_ = false;
+    std::size_t maxCallDepth_ = Interpreter::DEFAULT_MAX_CALL_DEPTH;
+};
+
+// runs the program once, with a new Runner
+int run(const CompiledProgram &program, const Bindings &bindings, Sink &output);
+
+} // namespace unitslang
+
+#endif // TKOMSIUNITS_UNITSLANG_UNITSLANG_H_INCLUDED
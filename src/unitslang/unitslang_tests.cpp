@@ -0,0 +1,399 @@
+#include "UnitsLang.h"
+#include "BatchRunner.h"
+#include "ParameterSweep.h"
+#include "Table.h"
+#include "sink/StreamSink.h"
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+
+namespace {
+
+struct RunResult {
+    int exitStatus;
+    std::string stdout;
+    std::string stderr;
+};
+
+const std::string speedScript =
+    "func limit (speed [m/s]) -> [m/s] {\n"
+    "    if speed > maxSpeed {\n"
+    "        return maxSpeed\n"
+    "    }\n"
+    "    return speed\n"
+    "}\n"
+    "speed = limit(distance / time)\n"
+    "distance = distance + 1[m]\n"
+    "print(\"{label}: {speed} {distance}\")\n"
+    "return time * 1[s] / 1[s2]\n";
+
+Type unitType(Unit unit) {
+    return Type(codeobj::Unit(unit));
+}
+
+Value number(double value, Unit unit) {
+    return Value(value, unitType(unit));
+}
+
+std::vector<Variable> speedInputs() {
+    return {
+        Variable("distance", unitType(Unit{ UnitPrefix::NONE, UnitType::METER, 1 })),
+        Variable("time", unitType(Unit{ UnitPrefix::NONE, UnitType::SECOND, 1 })),
+        Variable("maxSpeed", [] {
+                codeobj::Unit unit(Unit{ UnitPrefix::NONE, UnitType::METER, 1 });
+                unit.divWithUnit(codeobj::Unit(Unit{ UnitPrefix::NONE, UnitType::SECOND, 1 }));
+                return Type(std::move(unit));
+            }()),
+        Variable("label", Type(Type::STRING))
+    };
+}
+
+unitslang::Bindings speedBindings(double distance, UnitPrefix distancePrefix, double time, UnitPrefix timePrefix = UnitPrefix::NONE) {
+    codeobj::Unit speedUnit(Unit{ UnitPrefix::NONE, UnitType::METER, 1 });
+    speedUnit.divWithUnit(codeobj::Unit(Unit{ UnitPrefix::NONE, UnitType::SECOND, 1 }));
+    return {
+        { "distance", number(distance, Unit{ distancePrefix, UnitType::METER, 1 }) },
+        { "time", number(time, Unit{ timePrefix, UnitType::SECOND, 1 }) },
+        { "maxSpeed", Value(50.0, Type(std::move(speedUnit))) },
+        { "label", Value(std::string("speed")) }
+    };
+}
+
+RunResult run(unitslang::Runner &runner, const unitslang::CompiledProgram &program, const unitslang::Bindings &bindings) {
+    std::ostringstream testStdout;
+    std::ostringstream testStderr;
+    std::streambuf *originalStderr = std::cerr.rdbuf(testStderr.rdbuf());
+    StreamSink sink(testStdout);
+    int exitStatus = runner.run(program, bindings, sink);
+    std::cerr.rdbuf(originalStderr);
+    return RunResult{ exitStatus, testStdout.str(), testStderr.str() };
+}
+
+RunResult run(const unitslang::CompiledProgram &program, const unitslang::Bindings &bindings) {
+    unitslang::Runner runner;
+    return run(runner, program, bindings);
+}
+
+} // anonymous namespace
+
+TEST(UnitsLangTests, CompiledProgramRunsWithDifferentInputs) {
+    for (auto engine : { unitslang::Engine::TREE_WALKER, unitslang::Engine::VM, unitslang::Engine::FLAT_TREE }) {
+        unitslang::CompiledProgram program = unitslang::compile(speedScript, speedInputs(), engine);
+        unitslang::Runner runner;
+        RunResult first = run(runner, program, speedBindings(100, UnitPrefix::NONE, 10));
+        EXPECT_EQ(10, first.exitStatus);
+        EXPECT_EQ("speed: 10[(m)/(s)] 101[(m)/()]\n", first.stdout);
+        // values of inputs may have other unit prefixes than declared
+        RunResult second = run(runner, program, speedBindings(1, UnitPrefix::KILO, 100));
+        EXPECT_EQ(100, second.exitStatus);
+        EXPECT_EQ("speed: 0.01[(km)/(s)] 2[(km)/()]\n", second.stdout);
+        RunResult limited = run(runner, program, speedBindings(1000, UnitPrefix::NONE, 2));
+        EXPECT_EQ(2, limited.exitStatus);
+        EXPECT_EQ("speed: 50[(m)/(s)] 1001[(m)/()]\n", limited.stdout);
+        // units with different prefixes cannot be multiplied
+        RunResult failed = run(runner, program, speedBindings(1, UnitPrefix::NONE, 1, UnitPrefix::MILLI));
+        EXPECT_EQ(1, failed.exitStatus);
+        EXPECT_EQ("speed: 1[(m)/(ms)] 2[(m)/()]\n", failed.stdout);
+        EXPECT_NE("", failed.stderr);
+        EXPECT_EQ(first.stdout, run(runner, program, speedBindings(100, UnitPrefix::NONE, 10)).stdout);
+    }
+}
+
+TEST(UnitsLangTests, RunnerResetsInterpreterBetweenPrograms) {
+    unitslang::CompiledProgram speed = unitslang::compile(speedScript, speedInputs());
+    unitslang::CompiledProgram fibonacci = unitslang::compile(
+            "func fibonacci (n [1]) -> [1] {\n"
+            "    if n < 2 {\n"
+            "        return n\n"
+            "    }\n"
+            "    return fibonacci(n - 1) + fibonacci(n - 2)\n"
+            "}\n"
+            "f = fibonacci(n)\n"
+            "print(\"{f}\")\n",
+            { Variable("n", Type(codeobj::Unit())) }
+        );
+    unitslang::Runner runner;
+    runner.setMemoization(true);
+    for (double n : { 20.0, 10.0 }) {
+        unitslang::Bindings bindings{ { "n", Value(n, Type(codeobj::Unit())) } };
+        RunResult result = run(runner, fibonacci, bindings);
+        EXPECT_EQ(run(fibonacci, bindings).stdout, result.stdout);
+        EXPECT_EQ(run(speed, speedBindings(100, UnitPrefix::NONE, 10)).stdout,
+                  run(runner, speed, speedBindings(100, UnitPrefix::NONE, 10)).stdout);
+    }
+    EXPECT_EQ("55\n", run(runner, fibonacci, { { "n", Value(10.0, Type(codeobj::Unit())) } }).stdout);
+}
+
+TEST(UnitsLangTests, InvalidBindingsAreReportedBeforeRun) {
+    unitslang::CompiledProgram program = unitslang::compile(speedScript, speedInputs());
+    std::ostringstream out;
+    StreamSink sink(out);
+
+    unitslang::Bindings missing = speedBindings(1, UnitPrefix::NONE, 1);
+    missing.erase("time");
+    EXPECT_THROW(unitslang::run(program, missing, sink), std::runtime_error);
+
+    unitslang::Bindings wrongType = speedBindings(1, UnitPrefix::NONE, 1);
+    wrongType.insert_or_assign("time", number(1, Unit{ UnitPrefix::NONE, UnitType::METER, 1 }));
+    EXPECT_THROW(unitslang::run(program, wrongType, sink), std::runtime_error);
+
+    unitslang::Bindings unknown = speedBindings(1, UnitPrefix::NONE, 1);
+    unknown.insert({ "mass", number(1, Unit{ UnitPrefix::KILO, UnitType::GRAM, 1 }) });
+    EXPECT_THROW(unitslang::run(program, unknown, sink), std::runtime_error);
+    EXPECT_EQ("", out.str());
+}
+
+TEST(UnitsLangTests, InputsAreCheckedWhenCompiled) {
+    std::vector<Variable> inputs{ Variable("distance", unitType(Unit{ UnitPrefix::NONE, UnitType::METER, 1 })) };
+    EXPECT_THROW(unitslang::compile("distance = 1[s]\n", inputs), std::runtime_error);
+    EXPECT_THROW(unitslang::compile("a = distance + 1[s]\n", inputs), std::runtime_error);
+    EXPECT_NO_THROW(unitslang::compile("distance = 1[km]\n", inputs));
+    inputs.push_back(inputs.front());
+    EXPECT_THROW(unitslang::compile("a = 1\n", inputs), std::runtime_error);
+    EXPECT_THROW(unitslang::compile("a = 1\n", { Variable("v", Type(Type::VOID)) }), std::runtime_error);
+}
+
+TEST(UnitsLangTests, NativeStackExhaustionIsReported) {
+    // recursive call within deeply nested expressions and blocks uses most native stack per call
+    std::string nestedCall = "depth(n - 1) + 1";
+    for (int i = 0; i < 30; ++i) {
+        nestedCall = "(" + nestedCall + ")";
+    }
+    std::string nestedBody =
+        "    if n == 0 {\n"
+        "        return 0\n"
+        "    }\n"
+        "    return " + nestedCall + "\n";
+    for (int i = 0; i < 20; ++i) {
+        nestedBody = "    if true {\n" + nestedBody + "    }\n";
+    }
+    const std::string deepRecursion =
+        "func depth (n [1]) -> [1] {\n" + nestedBody +
+        "    return 0\n"
+        "}\n"
+        "print(\"{total}\")\n";
+    const std::string simpleRecursion =
+        "func depth (n [1]) -> [1] {\n"
+        "    if n == 0 {\n"
+        "        return 0\n"
+        "    }\n"
+        "    return depth(n - 1) + 1\n"
+        "}\n"
+        "print(\"{total}\")\n";
+    for (auto engine : { unitslang::Engine::TREE_WALKER, unitslang::Engine::VM, unitslang::Engine::FLAT_TREE }) {
+        // the default limit does not stop recursion the native stack allows
+        RunResult result = run(unitslang::compile("total = depth(2000)\n" + simpleRecursion, {}, engine), {});
+        EXPECT_EQ(0, result.exitStatus);
+        EXPECT_EQ("2000\n", result.stdout);
+
+        const unitslang::CompiledProgram program = unitslang::compile(
+                "total = depth(100000)\n" + deepRecursion, {}, engine);
+        unitslang::Runner runner;
+        runner.setMaxCallDepth(1000000);
+        result = run(runner, program, {});
+        if (engine == unitslang::Engine::VM) {
+            EXPECT_EQ(0, result.exitStatus);
+            EXPECT_EQ("100000\n", result.stdout);
+            continue;
+        }
+        // reported as an error instead of overflowing the native stack
+        EXPECT_EQ(1, result.exitStatus);
+        EXPECT_NE(std::string::npos, result.stderr.find("Native stack exhausted in call of function 'depth'"));
+        // and the runner is usable afterwards
+        result = run(runner, unitslang::compile("total = depth(10)\n" + deepRecursion, {}, engine), {});
+        EXPECT_EQ(0, result.exitStatus);
+        EXPECT_EQ("10\n", result.stdout);
+    }
+}
+
+TEST(UnitsLangTests, CompiledProgramIsRunConcurrently) {
+    for (auto engine : { unitslang::Engine::TREE_WALKER, unitslang::Engine::VM, unitslang::Engine::FLAT_TREE }) {
+        const unitslang::CompiledProgram program = unitslang::compile(speedScript, speedInputs(), engine);
+        const std::string expected = run(program, speedBindings(100, UnitPrefix::NONE, 10)).stdout;
+        const std::string expectedFailed = run(program, speedBindings(1, UnitPrefix::NONE, 1, UnitPrefix::MILLI)).stdout;
+        constexpr int threadsCount = 4;
+        std::vector<std::string> outputs(threadsCount);
+        std::vector<std::thread> threads;
+        for (int i = 0; i < threadsCount; ++i) {
+            threads.emplace_back([&program, &outputs, i] {
+                    unitslang::Runner runner;
+                    std::ostringstream errors;
+                    runner.setErrorStream(errors);
+                    for (int run = 0; run < 50; ++run) {
+                        std::ostringstream out;
+                        StreamSink sink(out);
+                        // runs failing with an error interleave with successful ones
+                        bool fails = (run + i) % 5 == 0;
+                        runner.run(program, fails ? speedBindings(1, UnitPrefix::NONE, 1, UnitPrefix::MILLI)
+                                                  : speedBindings(100, UnitPrefix::NONE, 10), sink);
+                        sink.flush();
+                        outputs[i] += out.str();
+                    }
+                });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        for (int i = 0; i < threadsCount; ++i) {
+            std::string expectedOutput;
+            for (int run = 0; run < 50; ++run) {
+                expectedOutput += (run + i) % 5 == 0 ? expectedFailed : expected;
+            }
+            EXPECT_EQ(expectedOutput, outputs[i]);
+        }
+    }
+}
+
+TEST(UnitsLangTests, BatchRunnerCapturesOutputOfEveryScript) {
+    std::vector<std::string> sources;
+    for (int i = 0; i < 20; ++i) {
+        sources.push_back("a = " + std::to_string(i) + "[m]\nprint(\"{a}\")\nreturn " + std::to_string(i) + "\n");
+    }
+    sources.push_back("print(\"start\")\na = 1[m] + 1[s]\n");
+    sources.push_back("a = 1[m] +\n");
+    sources.push_back("a = (1[m]\n");
+    unitslang::BatchRunner batchRunner(4);
+    batchRunner.setEngine(unitslang::Engine::VM);
+    // nothing is written to the stdout of the process, also for syntax errors
+    std::ostringstream processStdout;
+    std::streambuf *originalStdout = std::cout.rdbuf(processStdout.rdbuf());
+    std::vector<unitslang::ScriptResult> results = batchRunner.runSources(sources);
+    std::cout.rdbuf(originalStdout);
+    EXPECT_EQ("", processStdout.str());
+    ASSERT_EQ(sources.size(), results.size());
+    for (int i = 0; i < 20; ++i) {
+        EXPECT_EQ(i, results[i].exitStatus);
+        EXPECT_EQ(std::to_string(i) + "[(m)/()]\n", results[i].output);
+        EXPECT_EQ("", results[i].errors);
+    }
+    // error of the program is reported at compilation, so nothing is printed
+    for (std::size_t i = 20; i < results.size(); ++i) {
+        EXPECT_EQ(1, results[i].exitStatus);
+        EXPECT_EQ("", results[i].output);
+        EXPECT_NE("", results[i].errors);
+    }
+    EXPECT_EQ("", unitslang::BatchRunner(2).runFiles({ "/nonexistent/script" }).front().output);
+    EXPECT_EQ(1, unitslang::BatchRunner(2).runFiles({ "/nonexistent/script" }).front().exitStatus);
+}
+
+TEST(UnitsLangTests, TableIsReadFromCsv) {
+    unitslang::Table table = unitslang::readTable(
+            "distance [km], ok [bool],label [str]\r\n"
+            "1.5,true,\"a, \"\"b\"\"\"\r\n"
+            "\n"
+            " -2e3 ,false,\"two\nlines\"\n"
+        );
+    ASSERT_EQ(3u, table.columns.size());
+    EXPECT_EQ(" ok [bool]", table.header[1]);
+    EXPECT_EQ("ok", table.columns[1].getName());
+    ASSERT_EQ(2u, table.rows.size());
+    EXPECT_EQ(number(1.5, Unit{ UnitPrefix::KILO, UnitType::METER, 1 }), table.rows[0][0]);
+    EXPECT_EQ(Value(true), table.rows[0][1]);
+    EXPECT_EQ(Value(std::string("a, \"b\"")), table.rows[0][2]);
+    EXPECT_EQ(number(-2000, Unit{ UnitPrefix::KILO, UnitType::METER, 1 }), table.rows[1][0]);
+    EXPECT_EQ(Value(std::string("two\nlines")), table.rows[1][2]);
+
+    std::ostringstream os;
+    unitslang::writeCsvRecord(os, { "a, \"b\"", "two\nlines", "c" });
+    EXPECT_EQ("\"a, \"\"b\"\"\",\"two\nlines\",c\n", os.str());
+    EXPECT_EQ(std::vector<std::string>({ "a, \"b\"", "two\nlines", "c" }), unitslang::readCsvRecords(os.str()).front());
+
+    EXPECT_THROW(unitslang::readTable(""), std::runtime_error);
+    EXPECT_THROW(unitslang::readTable("mass\n1\n"), std::runtime_error);
+    EXPECT_THROW(unitslang::readTable("mass [kg]\n1,2\n"), std::runtime_error);
+    EXPECT_THROW(unitslang::readTable("mass [kg]\n1kg\n"), std::runtime_error);
+    EXPECT_THROW(unitslang::readTable("ok [bool]\nyes\n"), std::runtime_error);
+    EXPECT_THROW(unitslang::readTable("label [str]\n\"open\n"), std::runtime_error);
+}
+
+TEST(UnitsLangTests, ArrayColumnsAreSweptAsArrays) {
+    const unitslang::Table table = unitslang::readTable(
+            "samples [array km],count [1]\n"
+            "1;2.5; -3,3\n"
+            ",0\n"
+        );
+    EXPECT_EQ(Value(std::vector<double>{ 1, 2.5, -3 }, Type(Type::ARRAY, codeobj::Unit(Unit{ UnitPrefix::KILO, UnitType::METER, 1 }))),
+            table.rows[0][0]);
+    EXPECT_TRUE(table.rows[1][0].asArray().empty());
+    EXPECT_THROW(unitslang::readTable("samples [array m]\n1;x\n"), std::runtime_error);
+
+    unitslang::CompiledProgram program = unitslang::compile("doubled = samples * 2\n", table.columns);
+    std::vector<Variable> outputs{ unitslang::parseDeclaration("doubled [array m]") };
+    unitslang::ParameterSweep sweep(2);
+    std::vector<unitslang::RowResult> results = sweep.run(program, table, outputs);
+    ASSERT_EQ(2u, results.size());
+
+    std::ostringstream csv;
+    unitslang::ParameterSweep::writeCsv(csv, table, { "doubled [array m]" }, results);
+    EXPECT_EQ(
+        "samples [array km],count [1],doubled [array m],status\n"
+        "1;2.5;-3,3,2000;5000;-6000,0\n"
+        ",0,,0\n", csv.str());
+}
+
+TEST(UnitsLangTests, ParameterSweepRunsProgramForEveryRow) {
+    std::ostringstream csv;
+    csv << "distance [m],time [s]\n";
+    for (int i = 0; i < 50; ++i) {
+        csv << (i + 1) * 100 << ',' << (i % 10 == 0 ? 0 : 10) << '\n';
+    }
+    const unitslang::Table table = unitslang::readTable(csv.str());
+    std::vector<Variable> outputs{
+        unitslang::parseDeclaration("speed [km/s]"),
+        unitslang::parseDeclaration("isFast [bool]"),
+        unitslang::parseDeclaration("later [m]")
+    };
+    for (auto engine : { unitslang::Engine::TREE_WALKER, unitslang::Engine::VM, unitslang::Engine::FLAT_TREE }) {
+        unitslang::CompiledProgram program = unitslang::compile(
+                "speed = distance / time\n"
+                "isFast = speed > 100[m/s]\n"
+                "if time == 0[s] {\n"
+                "    a = missing\n"
+                "}\n"
+                "later = 1[km]\n",
+                table.columns,
+                engine
+            );
+        unitslang::ParameterSweep sweep(4);
+        std::vector<unitslang::RowResult> results = sweep.run(program, table, outputs);
+        ASSERT_EQ(table.rows.size(), results.size());
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const unitslang::RowResult &result = results[i];
+            ASSERT_EQ(3u, result.outputs.size());
+            EXPECT_TRUE(result.outputs[1].has_value());
+            if (i % 10 == 0) {
+                // run fails before the last variable is defined
+                EXPECT_EQ(1, result.exitStatus);
+                EXPECT_NE("", result.errors);
+                EXPECT_FALSE(result.outputs[2].has_value());
+                continue;
+            }
+            EXPECT_EQ(0, result.exitStatus);
+            EXPECT_EQ("", result.errors);
+            ASSERT_TRUE(result.outputs[0].has_value());
+            EXPECT_DOUBLE_EQ((i + 1) * 0.01, result.outputs[0]->asDouble());
+            EXPECT_EQ(Value(i >= 10), *result.outputs[1]);
+            ASSERT_TRUE(result.outputs[2].has_value());
+            EXPECT_EQ(number(1000, Unit{ UnitPrefix::NONE, UnitType::METER, 1 }), *result.outputs[2]);
+        }
+    }
+
+    unitslang::CompiledProgram program = unitslang::compile("speed = distance / time\n", table.columns);
+    unitslang::ParameterSweep sweep(2);
+    EXPECT_THROW(sweep.run(program, table, { unitslang::parseDeclaration("energy [J]") }), std::runtime_error);
+    std::vector<unitslang::RowResult> mismatched = sweep.run(program, table, { unitslang::parseDeclaration("speed [m]") });
+    EXPECT_EQ(1, mismatched[1].exitStatus);
+    EXPECT_NE("", mismatched[1].errors);
+    EXPECT_THROW(sweep.run(unitslang::compile("a = 1\n"), table, {}), std::runtime_error);
+
+    std::ostringstream os;
+    std::vector<unitslang::RowResult> results = sweep.run(program, table, { unitslang::parseDeclaration("speed [m/s]") });
+    unitslang::ParameterSweep::writeCsv(os, table, { "speed [m/s]" }, results);
+    const std::string expectedStart = "distance [m],time [s],speed [m/s],status\n100,0,inf,0\n200,10,20,0\n";
+    EXPECT_EQ(expectedStart, os.str().substr(0, expectedStart.size()));
+}
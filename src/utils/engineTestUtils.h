@@ -0,0 +1,62 @@
+#ifndef TKOMSIUNITS_ENGINE_TEST_UTILS_H_INCLUDED
+#define TKOMSIUNITS_ENGINE_TEST_UTILS_H_INCLUDED
+
+#include "codeObjects/Program.h"
+#include "codeObjects/Interpreter.h"
+#include "source/StringSource.h"
+#include "lexer/Lexer.h"
+#include "parser/Parser.h"
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <gtest/gtest.h>
+
+// Helpers of the tests of execution engines, which compare them with the tree walker;
+// an engine is a callable executing the program with the interpreter: int(Interpreter &, const Program &)
+namespace engineTests {
+
+struct RunResult {
+    int exitStatus;
+    std::string stdout;
+    std::string stderr;
+};
+
+inline std::unique_ptr<Program> parse(const std::string &input) {
+    StringSource src(input);
+    Lexer lexer(src);
+    Parser parser(lexer);
+    return parser.parse();
+}
+
+template <typename Engine>
+RunResult run(const std::string &input, Engine &&engine, bool memoize = false) {
+    std::unique_ptr<Program> program = parse(input);
+    std::ostringstream testStdout;
+    std::ostringstream testStderr;
+    std::streambuf *originalStderr = std::cerr.rdbuf(testStderr.rdbuf());
+    Interpreter interp(testStdout, *program.get());
+    interp.setMemoization(memoize);
+    int exitStatus = engine(interp, *program.get());
+    std::cerr.rdbuf(originalStderr);
+    return RunResult{ exitStatus, testStdout.str(), testStderr.str() };
+}
+
+inline RunResult runTreeWalker(const std::string &input, bool memoize = false) {
+    return run(input, [](Interpreter &interp, const Program &) {
+        return interp.executeProgram();
+    }, memoize);
+}
+
+template <typename Engine>
+void expectParity(const std::string &input, Engine &&engine, bool memoize = false) {
+    RunResult expected = runTreeWalker(input, memoize);
+    RunResult result = run(input, std::forward<Engine>(engine), memoize);
+    EXPECT_EQ(expected.exitStatus, result.exitStatus) << "not met for: " << input;
+    EXPECT_EQ(expected.stdout, result.stdout) << "not met for: " << input;
+    EXPECT_EQ(expected.stderr, result.stderr) << "not met for: " << input;
+}
+
+} // namespace engineTests
+
+#endif // TKOMSIUNITS_ENGINE_TEST_UTILS_H_INCLUDED
@@ -6,10 +6,11 @@
 #include <iostream>
 
 inline std::ostream& operator<<(std::ostream &os, TokenType tokenType) {
-    static std::array typeNames = {
+    static constexpr std::array typeNames = {
         "ID",
         "NUMBER",
         "UNIT",
+        "KEYWORD_ARRAY",
         "KEYWORD_BOOL",
         "KEYWORD_BREAK",
         "KEYWORD_CONTINUE",
@@ -48,7 +49,7 @@ inline std::ostream& operator<<(std::ostream &os, TokenType tokenType) {
 }
 
 inline std::ostream& operator<<(std::ostream &os, UnitType unitType) {
-    static std::array typeNames = {
+    static constexpr std::array typeNames = {
         "s",
         "g",
         "m",
@@ -61,7 +62,7 @@ inline std::ostream& operator<<(std::ostream &os, UnitType unitType) {
 }
 
 inline std::ostream& operator<<(std::ostream &os, Unit unit) {
-    return os << unit.prefix << unit.unit << (unit.power > 1 ? std::to_string(unit.power) : "");
+    return os << prefixSymbol(unit.prefix) << unit.unit << (unit.power > 1 ? std::to_string(unit.power) : "");
 }
 
 inline std::ostream& operator<<(std::ostream &os, Token token) {
@@ -74,8 +75,10 @@ inline std::ostream& operator<<(std::ostream &os, Token token) {
         }
     } else if (token.type == TokenType::UNIT ) {
         os << std::get<Unit>(token.value);
-    } else {
-        os << std::get<std::string>(token.value);
+    } else if (token.type == TokenType::STRING) {
+        os << "<str>";
+    } else if (std::holds_alternative<std::string_view>(token.value)) {
+        os << std::get<std::string_view>(token.value);
     }
     return os << '\'';
 }
@@ -0,0 +1,104 @@
+#ifndef TKOMSIUNITS_VM_BYTECODE_H_INCLUDED
+#define TKOMSIUNITS_VM_BYTECODE_H_INCLUDED
+
+#include "codeObjects/BinaryExpression.h"
+#include "codeObjects/FuncDef.h"
+#include "codeObjects/Value.h"
+#include "codeObjects/VarSlot.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Program;
+class VarDefOrAssignment;
+
+// Expressions whose static type is known (BinaryExpression::isCalculatedRaw) are calculated
+// on the raw stack, as numbers or bools without their Value, like by calculateNumber() and
+// calculateBool() of the tree walker. Conditions are always calculated as raw bools.
+enum class OpCode : std::uint8_t {
+    PUSH_CONST,         // push constants[operand]
+    LOAD_VAR,           // push value of variables[operand]
+    STORE_VAR,          // pop value, define or assign variable of assignments[operand]
+    BINARY,             // pop right operand, apply binaryExpressions[operand] to left operand in place
+    CONCAT,             // pop count values, push string made of their concatenation
+    PUSH_RAW,           // push rawConstants[operand] to the raw stack
+    LOAD_NUMBER,        // push number of variables[operand] to the raw stack
+    LOAD_BOOL,          // push bool of variables[operand] to the raw stack
+    STORE_NUMBER,       // pop raw number, assign it in place to the variable of assignments[operand]
+    ADD_NUMBERS,        // take right raw number (count: RawOperand), apply the operator
+    SUBTRACT_NUMBERS,   // to the left one in place
+    MULT_NUMBERS,
+    DIV_NUMBERS,
+    COMPARE_NUMBERS,    // take right raw number (count: RawOperand), replace the left one
+                        // with bool result of comparison flags (BinaryExpression::Operator)
+    COMPARE_BOOLS,      // pop right raw bool, replace the left one with result of == or != (flags)
+    BOX_NUMBER,         // pop raw number, push its Value of types[operand]
+    BOX_BOOL,           // pop raw bool, push its Value
+    UNBOX_NUMBER,       // pop value, push its number to the raw stack
+    UNBOX_BOOL,         // pop value, push its bool to the raw stack
+    JUMP,               // continue at operand
+    JUMP_IF_FALSE,      // pop raw bool condition, continue at operand if it is false
+    JUMP_IF_TRUE,       // pop raw bool condition, continue at operand if it is true
+    JUMP_IF_DECIDED,    // continue at operand, keeping the left operand of && or || on the stack,
+                        // if it is bool equal to flags (result decided without the right operand)
+    JUMP_IF_DECIDED_BOOL, // the same for raw bool operands; the undecided left operand is popped
+    CALL,               // call functions[operand] with count arguments (flags: CALL_AS_STATEMENT)
+    TAIL_CALL,          // replace the current call with a call of functions[operand] with count arguments
+    RETURN_VALUE,       // pop value returned by the following EXIT
+    EXIT,               // leave the function or the program (flags: InstrResult)
+    PRINT               // print string variables[operand] to stdout
+};
+
+inline constexpr std::uint8_t CALL_AS_STATEMENT = 1;
+
+// where operators on raw numbers take their right operand from, so that constants
+// and variables are not pushed by separate instructions
+enum class RawOperand : std::uint16_t {
+    STACK,              // popped from the raw stack
+    CONSTANT,           // rawConstants[operand]
+    VARIABLE            // number of variables[operand]
+};
+
+// number or bool calculated on the raw stack
+union RawValue {
+    double number;
+    bool boolean;
+};
+
+struct BytecodeInstr {
+    OpCode op;
+    std::uint8_t flags = 0;
+    std::uint16_t count = 0;
+    std::uint32_t operand = 0;
+};
+
+struct VarOperand {
+    VarSlot slot;
+    std::uint32_t name; // index in names
+};
+
+struct Chunk {
+    std::vector<BytecodeInstr> code;
+};
+
+struct CompiledFunction {
+    const FuncDef *funcDef;
+    Chunk chunk;
+};
+
+// Program compiled to bytecode. Refers to code objects of the source Program,
+// which has to outlive it.
+struct BytecodeProgram {
+    const Program *program = nullptr;
+    Chunk main;
+    std::vector<CompiledFunction> functions;
+    std::vector<Value> constants;
+    std::vector<RawValue> rawConstants;
+    std::vector<Type> types;
+    std::vector<std::string> names;
+    std::vector<VarOperand> variables;
+    std::vector<const VarDefOrAssignment *> assignments;
+    std::vector<const BinaryExpression *> binaryExpressions;
+};
+
+#endif // TKOMSIUNITS_VM_BYTECODE_H_INCLUDED
@@ -0,0 +1,370 @@
+#include "Compiler.h"
+
+#include "codeObjects/Program.h"
+#include "codeObjects/FuncCall.h"
+#include "codeObjects/Literal.h"
+#include "codeObjects/VarReference.h"
+#include "codeObjects/String.h"
+#include "codeObjects/VarDefOrAssignment.h"
+#include "codeObjects/If.h"
+#include "codeObjects/While.h"
+#include "codeObjects/Return.h"
+#include "codeObjects/Break.h"
+#include "codeObjects/Continue.h"
+#include "codeObjects/InternalPrintInstr.h"
+#include "error/ErrorHandler.h"
+#include <limits>
+#include <optional>
+#include <utility>
+
+BytecodeProgram Compiler::compile(const Program &program) {
+    Compiler compiler(program);
+    compiler.chunk_ = &compiler.bytecode_.main;
+    compiler.compileBlock(program.getInstructions());
+    compiler.emit(OpCode::EXIT, 0, 0, static_cast<std::uint8_t>(InstrResult::NORMAL));
+    // functions vector grows while compiling functions called from other functions
+    for (std::size_t i = 0; i < compiler.bytecode_.functions.size(); ++i) {
+        compiler.compileFunction(i);
+    }
+    return std::move(compiler.bytecode_);
+}
+
+Compiler::Compiler(const Program &program)
+    : program_(program) {
+    bytecode_.program = &program;
+}
+
+void Compiler::compileFunction(std::size_t index) {
+    Chunk chunk;
+    chunk_ = &chunk;
+    compileBlock(bytecode_.functions[index].funcDef->getBody());
+    emit(OpCode::EXIT, 0, 0, static_cast<std::uint8_t>(InstrResult::NORMAL));
+    bytecode_.functions[index].chunk = std::move(chunk);
+    chunk_ = nullptr;
+}
+
+void Compiler::compileBlock(const InstructionBlock &block) {
+    // variables of the block are kept in frame slots assigned by Resolver
+    for (auto &&instr : block.getInstructions()) {
+        compileInstruction(*instr);
+    }
+}
+
+void Compiler::compileInstruction(Instruction &instr) {
+    asStatement_ = true;
+    form_ = Form::VALUE;
+    instr.accept(*this);
+}
+
+void Compiler::compileExpression(Expression &expr, Form form) {
+    asStatement_ = false;
+    form_ = form;
+    expr.accept(*this);
+}
+
+void Compiler::compileRawOperation(BinaryExpression &expr) {
+    using Operator = BinaryExpression::Operator;
+    Operator op = expr.getOperatorKind();
+    auto compileNumbersOperation = [this, &expr](OpCode numbersOp, std::uint8_t flags = 0) {
+            compileExpression(expr.getLeftOperand(), Form::NUMBER);
+            emitRawNumbersOperation(numbersOp, expr.getRightOperand(), flags);
+        };
+    switch (op) {
+        case Operator::ADD:
+            compileNumbersOperation(OpCode::ADD_NUMBERS);
+            break;
+        case Operator::SUBTRACT:
+            compileNumbersOperation(OpCode::SUBTRACT_NUMBERS);
+            break;
+        case Operator::MULT:
+            compileNumbersOperation(OpCode::MULT_NUMBERS);
+            break;
+        case Operator::DIV:
+            compileNumbersOperation(OpCode::DIV_NUMBERS);
+            break;
+        case Operator::EQUAL_TO:
+        case Operator::NOT_EQUAL_TO:
+            if (expr.getOperandsType() == Type::BOOL) {
+                compileExpression(expr.getLeftOperand(), Form::BOOL);
+                compileExpression(expr.getRightOperand(), Form::BOOL);
+                emit(OpCode::COMPARE_BOOLS, 0, 0, static_cast<std::uint8_t>(op));
+                break;
+            }
+            [[fallthrough]];
+        case Operator::GREATER_THAN:
+        case Operator::GREATER_THAN_OR_EQUAL:
+        case Operator::LESS_THAN:
+        case Operator::LESS_THAN_OR_EQUAL:
+            compileNumbersOperation(OpCode::COMPARE_NUMBERS, static_cast<std::uint8_t>(op));
+            break;
+        case Operator::AND:
+        case Operator::OR: {
+            compileExpression(expr.getLeftOperand(), Form::BOOL);
+            std::size_t jumpIfDecided = emit(OpCode::JUMP_IF_DECIDED_BOOL, 0, 0, op == Operator::OR ? 1 : 0);
+            compileExpression(expr.getRightOperand(), Form::BOOL);
+            patchJump(jumpIfDecided);
+            break;
+        }
+    }
+}
+
+void Compiler::emitRawNumbersOperation(OpCode op, Expression &right, std::uint8_t flags) {
+    if (auto *literal = dynamic_cast<const Literal *>(&right);
+        literal && literal->getValue().type.getTypeClass() == Type::NUMBER
+    ) {
+        RawValue raw;
+        raw.number = literal->getValue().asDouble();
+        emit(op, rawConstantIndex(raw), static_cast<std::uint16_t>(RawOperand::CONSTANT), flags);
+        return;
+    }
+    if (auto *varRef = dynamic_cast<const VarReference *>(&right)) {
+        emit(
+            op,
+            variableIndex(varRef->getSlot(), varRef->getName()),
+            static_cast<std::uint16_t>(RawOperand::VARIABLE),
+            flags
+        );
+        return;
+    }
+    compileExpression(right, Form::NUMBER);
+    emit(op, 0, static_cast<std::uint16_t>(RawOperand::STACK), flags);
+}
+
+void Compiler::unbox(Form form) {
+    if (form == Form::NUMBER) {
+        emit(OpCode::UNBOX_NUMBER);
+    } else if (form == Form::BOOL) {
+        emit(OpCode::UNBOX_BOOL);
+    }
+}
+
+void Compiler::visit(Literal &literal) {
+    const Value &value = literal.getValue();
+    RawValue raw;
+    if (form_ == Form::NUMBER && value.type.getTypeClass() == Type::NUMBER) {
+        raw.number = value.asDouble();
+        emit(OpCode::PUSH_RAW, rawConstantIndex(raw));
+        return;
+    }
+    if (form_ == Form::BOOL && value.type.getTypeClass() == Type::BOOL) {
+        raw.boolean = value.asBool();
+        emit(OpCode::PUSH_RAW, rawConstantIndex(raw));
+        return;
+    }
+    // of other type only if reported by TypeChecker; the conversion fails as in the tree walker
+    Form form = form_;
+    bytecode_.constants.push_back(value);
+    emit(OpCode::PUSH_CONST, static_cast<std::uint32_t>(bytecode_.constants.size() - 1));
+    unbox(form);
+}
+
+void Compiler::visit(BinaryExpression &expr) {
+    Form form = form_;
+    const Type *exactType = expr.getExactType();
+    if ((form == Form::NUMBER && expr.isCalculatedRaw(Type::NUMBER))
+        || (form == Form::BOOL && expr.isCalculatedRaw(Type::BOOL))
+    ) {
+        compileRawOperation(expr);
+        return;
+    }
+    if (form == Form::VALUE && exactType && expr.isCalculatedRaw(exactType->getTypeClass())) {
+        // the result is boxed with its statically known type
+        compileRawOperation(expr);
+        if (exactType->getTypeClass() == Type::BOOL) {
+            emit(OpCode::BOX_BOOL);
+        } else {
+            emit(OpCode::BOX_NUMBER, typeIndex(*exactType));
+        }
+        return;
+    }
+    compileExpression(expr.getLeftOperand());
+    std::optional<bool> shortCircuitValue = expr.getShortCircuitValue();
+    std::size_t jumpIfDecided = 0;
+    if (shortCircuitValue) {
+        jumpIfDecided = emit(OpCode::JUMP_IF_DECIDED, 0, 0, *shortCircuitValue ? 1 : 0);
+    }
+    compileExpression(expr.getRightOperand());
+    bytecode_.binaryExpressions.push_back(&expr);
+    emit(OpCode::BINARY, static_cast<std::uint32_t>(bytecode_.binaryExpressions.size() - 1));
+    if (shortCircuitValue) {
+        patchJump(jumpIfDecided);
+    }
+    unbox(form);
+}
+
+void Compiler::visit(VarReference &varRef) {
+    std::uint32_t variable = variableIndex(varRef.getSlot(), varRef.getName());
+    switch (form_) {
+        case Form::VALUE:
+            emit(OpCode::LOAD_VAR, variable);
+            break;
+        case Form::NUMBER:
+            emit(OpCode::LOAD_NUMBER, variable);
+            break;
+        case Form::BOOL:
+            emit(OpCode::LOAD_BOOL, variable);
+            break;
+    }
+}
+
+void Compiler::visit(codeobj::String &str) {
+    Form form = form_;
+    for (auto &&part : str.getParts()) {
+        compileExpression(*part);
+    }
+    emit(OpCode::CONCAT, 0, checkedCount(str.getParts().size()));
+    unbox(form);
+}
+
+void Compiler::visit(FuncCall &funcCall) {
+    bool asStatement = std::exchange(asStatement_, false);
+    Form form = form_;
+    const FuncDef *funcDef = funcCall.getFuncDef();
+    for (auto &&arg : funcCall.getArgs()) {
+        compileExpression(*arg);
+    }
+    emit(
+        OpCode::CALL,
+        functionIndex(*funcDef),
+        checkedCount(funcCall.getArgs().size()),
+        asStatement ? CALL_AS_STATEMENT : 0
+    );
+    unbox(form);
+}
+
+void Compiler::visit(VarDefOrAssignment &instr) {
+    bytecode_.assignments.push_back(&instr);
+    auto assignment = static_cast<std::uint32_t>(bytecode_.assignments.size() - 1);
+    if (instr.assignsNumberInPlace()) {
+        compileExpression(instr.getExpr(), Form::NUMBER);
+        emit(OpCode::STORE_NUMBER, assignment);
+        return;
+    }
+    compileExpression(instr.getExpr());
+    emit(OpCode::STORE_VAR, assignment);
+}
+
+void Compiler::visit(If &instr) {
+    if (!instr.getCond()) {
+        // Else
+        compileBlock(instr.getPositiveBlock());
+        return;
+    }
+    compileExpression(*instr.getCond(), Form::BOOL);
+    std::size_t jumpIfFalse = emit(OpCode::JUMP_IF_FALSE);
+    compileBlock(instr.getPositiveBlock());
+    if (If *elseIf = instr.getElseIf()) {
+        std::size_t jumpToEnd = emit(OpCode::JUMP);
+        patchJump(jumpIfFalse);
+        compileInstruction(*elseIf);
+        patchJump(jumpToEnd);
+    } else {
+        patchJump(jumpIfFalse);
+    }
+}
+
+void Compiler::visit(While &instr) {
+    // the condition is placed after the body, so that an iteration takes a single jump
+    std::size_t jumpToCond = emit(OpCode::JUMP);
+    std::uint32_t bodyStart = currentOffset();
+    loops_.push_back(Loop{});
+    compileBlock(instr.getBody());
+    patchJump(jumpToCond);
+    for (std::size_t continueJump : loops_.back().continueJumps) {
+        patchJump(continueJump);
+    }
+    compileExpression(instr.getCond(), Form::BOOL);
+    emit(OpCode::JUMP_IF_TRUE, bodyStart);
+    for (std::size_t breakJump : loops_.back().breakJumps) {
+        patchJump(breakJump);
+    }
+    loops_.pop_back();
+}
+
+void Compiler::visit(Return &instr) {
+    if (const FuncCall *tailCall = instr.getTailCall()) {
+        for (auto &&arg : tailCall->getArgs()) {
+            compileExpression(*arg);
+        }
+        emit(OpCode::TAIL_CALL, functionIndex(*tailCall->getFuncDef()), checkedCount(tailCall->getArgs().size()));
+        return;
+    }
+    if (Expression *expr = instr.getExpr()) {
+        compileExpression(*expr);
+        emit(OpCode::RETURN_VALUE);
+    }
+    emit(OpCode::EXIT, 0, 0, static_cast<std::uint8_t>(InstrResult::RETURN));
+}
+
+void Compiler::visit([[maybe_unused]] Break &instr) {
+    if (loops_.empty()) {
+        // reported by FuncDef/Program when leaving
+        emit(OpCode::EXIT, 0, 0, static_cast<std::uint8_t>(InstrResult::BREAK));
+        return;
+    }
+    loops_.back().breakJumps.push_back(emit(OpCode::JUMP));
+}
+
+void Compiler::visit([[maybe_unused]] Continue &instr) {
+    if (loops_.empty()) {
+        emit(OpCode::EXIT, 0, 0, static_cast<std::uint8_t>(InstrResult::CONTINUE));
+        return;
+    }
+    loops_.back().continueJumps.push_back(emit(OpCode::JUMP));
+}
+
+void Compiler::visit(InternalPrintInstr &instr) {
+    emit(OpCode::PRINT, variableIndex(instr.getSlot(), instr.getStringVariableName()));
+}
+
+std::size_t Compiler::emit(OpCode op, std::uint32_t operand, std::uint16_t count, std::uint8_t flags) {
+    chunk_->code.push_back(BytecodeInstr{ op, flags, count, operand });
+    return chunk_->code.size() - 1;
+}
+
+void Compiler::patchJump(std::size_t jumpIndex) {
+    chunk_->code[jumpIndex].operand = currentOffset();
+}
+
+std::uint32_t Compiler::currentOffset() const {
+    return static_cast<std::uint32_t>(chunk_->code.size());
+}
+
+std::uint32_t Compiler::nameIndex(const std::string &name) {
+    auto [iter, inserted] = nameIndices_.insert({ name, static_cast<std::uint32_t>(bytecode_.names.size()) });
+    if (inserted) {
+        bytecode_.names.push_back(name);
+    }
+    return iter->second;
+}
+
+std::uint32_t Compiler::variableIndex(const VarSlot &slot, const std::string &name) {
+    bytecode_.variables.push_back(VarOperand{ slot, nameIndex(name) });
+    return static_cast<std::uint32_t>(bytecode_.variables.size() - 1);
+}
+
+std::uint32_t Compiler::functionIndex(const FuncDef &funcDef) {
+    auto [iter, inserted] = functionIndices_.insert({ &funcDef, static_cast<std::uint32_t>(bytecode_.functions.size()) });
+    if (inserted) {
+        // compiled after the current chunk
+        bytecode_.functions.push_back(CompiledFunction{ &funcDef, {} });
+    }
+    return iter->second;
+}
+
+std::uint32_t Compiler::rawConstantIndex(RawValue value) {
+    bytecode_.rawConstants.push_back(value);
+    return static_cast<std::uint32_t>(bytecode_.rawConstants.size() - 1);
+}
+
+std::uint32_t Compiler::typeIndex(const Type &type) {
+    bytecode_.types.push_back(type);
+    return static_cast<std::uint32_t>(bytecode_.types.size() - 1);
+}
+
+std::uint16_t Compiler::checkedCount(std::size_t count) {
+    if (count > std::numeric_limits<std::uint16_t>::max()) {
+        ErrorHandler::handleFromInterpreter("Too many operands for single bytecode instruction");
+    }
+    return static_cast<std::uint16_t>(count);
+}
@@ -0,0 +1,88 @@
+#ifndef TKOMSIUNITS_VM_COMPILER_H_INCLUDED
+#define TKOMSIUNITS_VM_COMPILER_H_INCLUDED
+
+#include "Bytecode.h"
+#include "codeObjects/CodeObjectVisitor.h"
+#include "codeObjects/Expression.h"
+#include "codeObjects/Instruction.h"
+#include "codeObjects/InstructionBlock.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Program;
+
+// Compiles Program top-level instructions and all functions called from it to bytecode.
+// Runtime errors (jumps outside While, references to not-defined variables) are compiled to instructions
+// raising them, so that they are reported at the same point of execution as in the tree walker.
+class Compiler : private CodeObjectVisitor {
+public:
+    static BytecodeProgram compile(const Program &program);
+
+private:
+    // jumps patched when the end of the body (continue) and of the loop (break) are known
+    struct Loop {
+        std::vector<std::size_t> continueJumps;
+        std::vector<std::size_t> breakJumps;
+    };
+
+    // where the compiled expression leaves its result
+    enum class Form {
+        VALUE,      // Value on the stack
+        NUMBER,     // raw number on the raw stack
+        BOOL        // raw bool on the raw stack
+    };
+
+private:
+    explicit Compiler(const Program &program);
+
+    void compileFunction(std::size_t index);
+    void compileBlock(const InstructionBlock &block);
+    void compileInstruction(Instruction &instr);
+    void compileExpression(Expression &expr, Form form = Form::VALUE);
+    // operands and the operator of expression calculated raw
+    void compileRawOperation(BinaryExpression &expr);
+    // operator on raw numbers with its right operand
+    void emitRawNumbersOperation(OpCode op, Expression &right, std::uint8_t flags = 0);
+    // converts the Value of an expression not calculated raw to the form
+    void unbox(Form form);
+
+    void visit(Literal &literal) override;
+    void visit(BinaryExpression &expr) override;
+    void visit(VarReference &varRef) override;
+    void visit(codeobj::String &str) override;
+    void visit(FuncCall &funcCall) override;
+    void visit(VarDefOrAssignment &instr) override;
+    void visit(If &instr) override;
+    void visit(While &instr) override;
+    void visit(Return &instr) override;
+    void visit(Break &instr) override;
+    void visit(Continue &instr) override;
+    void visit(InternalPrintInstr &instr) override;
+
+    std::size_t emit(OpCode op, std::uint32_t operand = 0, std::uint16_t count = 0, std::uint8_t flags = 0);
+    void patchJump(std::size_t jumpIndex);
+    std::uint32_t currentOffset() const;
+
+    std::uint32_t nameIndex(const std::string &name);
+    std::uint32_t variableIndex(const VarSlot &slot, const std::string &name);
+    std::uint32_t functionIndex(const FuncDef &funcDef);
+    std::uint32_t rawConstantIndex(RawValue value);
+    std::uint32_t typeIndex(const Type &type);
+    static std::uint16_t checkedCount(std::size_t count);
+
+private:
+    const Program &program_;
+    BytecodeProgram bytecode_;
+    Chunk *chunk_ = nullptr;
+    std::vector<Loop> loops_;
+    // FuncCall is compiled as instruction (result discarded) or expression
+    bool asStatement_ = false;
+    Form form_ = Form::VALUE;
+    std::unordered_map<std::string, std::uint32_t> nameIndices_;
+    std::unordered_map<const FuncDef *, std::uint32_t> functionIndices_;
+};
+
+#endif // TKOMSIUNITS_VM_COMPILER_H_INCLUDED
@@ -0,0 +1,219 @@
+#include "VirtualMachine.h"
+
+#include "codeObjects/Program.h"
+#include "codeObjects/VarDefOrAssignment.h"
+#include "error/ErrorHandler.h"
+#include <iterator>
+#include <string>
+
+int VirtualMachine::execute() {
+    return interpreter_.executeProgram([this]() { return run(); });
+}
+
+int VirtualMachine::run() {
+    stack_.clear();
+    rawStack_.clear();
+    frames_.clear();
+    const CompiledFunction *function = nullptr; // nullptr for top-level instructions
+    const BytecodeInstr *code = bytecode_.main.code.data();
+    const BytecodeInstr *ip = code;
+
+    for (;;) {
+        const BytecodeInstr &instr = *ip++;
+        switch (instr.op) {
+            case OpCode::PUSH_CONST:
+                stack_.push_back(bytecode_.constants[instr.operand]);
+                break;
+            case OpCode::LOAD_VAR: {
+                const VarOperand &var = bytecode_.variables[instr.operand];
+                stack_.push_back(interpreter_.getVariable(var.slot, bytecode_.names[var.name]));
+                break;
+            }
+            case OpCode::STORE_VAR:
+                bytecode_.assignments[instr.operand]->store(interpreter_, pop());
+                break;
+            case OpCode::BINARY: {
+                // the right operand is applied where it is, not moved off the stack
+                const Value &right = stack_.back();
+                bytecode_.binaryExpressions[instr.operand]->apply(stack_.end()[-2], right);
+                stack_.pop_back();
+                break;
+            }
+            case OpCode::CONCAT: {
+                std::string str;
+                auto first = stack_.end() - instr.count;
+                for (auto iter = first; iter != stack_.end(); ++iter) {
+                    str += iter->toString();
+                }
+                stack_.erase(first, stack_.end());
+                stack_.emplace_back(std::move(str));
+                break;
+            }
+            case OpCode::PUSH_RAW:
+                rawStack_.push_back(bytecode_.rawConstants[instr.operand]);
+                break;
+            case OpCode::LOAD_NUMBER: {
+                const VarOperand &var = bytecode_.variables[instr.operand];
+                rawStack_.emplace_back().number = interpreter_.getVariable(var.slot, bytecode_.names[var.name]).asDouble();
+                break;
+            }
+            case OpCode::LOAD_BOOL: {
+                const VarOperand &var = bytecode_.variables[instr.operand];
+                rawStack_.emplace_back().boolean = interpreter_.getVariable(var.slot, bytecode_.names[var.name]).asBool();
+                break;
+            }
+            case OpCode::STORE_NUMBER:
+                bytecode_.assignments[instr.operand]->storeNumber(interpreter_, popRaw().number);
+                break;
+            case OpCode::ADD_NUMBERS: {
+                double right = rightNumber(instr);
+                rawStack_.back().number += right;
+                break;
+            }
+            case OpCode::SUBTRACT_NUMBERS: {
+                double right = rightNumber(instr);
+                rawStack_.back().number -= right;
+                break;
+            }
+            case OpCode::MULT_NUMBERS: {
+                double right = rightNumber(instr);
+                rawStack_.back().number *= right;
+                break;
+            }
+            case OpCode::DIV_NUMBERS: {
+                double right = rightNumber(instr);
+                rawStack_.back().number /= right;
+                break;
+            }
+            case OpCode::COMPARE_NUMBERS: {
+                double right = rightNumber(instr);
+                RawValue &left = rawStack_.back();
+                left.boolean = BinaryExpression::compare(static_cast<BinaryExpression::Operator>(instr.flags), left.number, right);
+                break;
+            }
+            case OpCode::COMPARE_BOOLS: {
+                bool right = popRaw().boolean;
+                RawValue &left = rawStack_.back();
+                left.boolean = BinaryExpression::compare(static_cast<BinaryExpression::Operator>(instr.flags), left.boolean, right);
+                break;
+            }
+            case OpCode::BOX_NUMBER:
+                stack_.emplace_back(popRaw().number, Type(bytecode_.types[instr.operand]));
+                break;
+            case OpCode::BOX_BOOL:
+                stack_.emplace_back(popRaw().boolean);
+                break;
+            case OpCode::UNBOX_NUMBER:
+                rawStack_.emplace_back().number = stack_.back().asDouble();
+                stack_.pop_back();
+                break;
+            case OpCode::UNBOX_BOOL:
+                rawStack_.emplace_back().boolean = stack_.back().asBool();
+                stack_.pop_back();
+                break;
+            case OpCode::JUMP:
+                ip = code + instr.operand;
+                break;
+            case OpCode::JUMP_IF_FALSE:
+                // condition type is checked by TypeChecker
+                if (!popRaw().boolean) {
+                    ip = code + instr.operand;
+                }
+                break;
+            case OpCode::JUMP_IF_TRUE:
+                if (popRaw().boolean) {
+                    ip = code + instr.operand;
+                }
+                break;
+            case OpCode::JUMP_IF_DECIDED: {
+                const Value &left = stack_.back();
+                if (left.type.getTypeClass() == Type::BOOL && left.asBool() == (instr.flags != 0)) {
+                    ip = code + instr.operand;
+                }
+                break;
+            }
+            case OpCode::JUMP_IF_DECIDED_BOOL:
+                if (rawStack_.back().boolean == (instr.flags != 0)) {
+                    ip = code + instr.operand;
+                } else {
+                    rawStack_.pop_back();
+                }
+                break;
+            case OpCode::CALL: {
+                const CompiledFunction &callee = bytecode_.functions[instr.operand];
+                auto firstArg = stack_.end() - instr.count;
+                std::vector<Value> args(std::make_move_iterator(firstArg), std::make_move_iterator(stack_.end()));
+                stack_.erase(firstArg, stack_.end());
+                bool asStatement = (instr.flags & CALL_AS_STATEMENT) != 0;
+                std::optional<std::vector<Value>> memoizedArgs;
+                if (callee.funcDef->isPure() && interpreter_.isMemoizing()) {
+                    if (const std::optional<Value> *memoized = interpreter_.findMemoized(*callee.funcDef, args)) {
+                        if (!asStatement) {
+                            pushReturnValue(*memoized);
+                        }
+                        break;
+                    }
+                    memoizedArgs = args;
+                }
+                callee.funcDef->enter(interpreter_, std::move(args));
+                frames_.push_back(Frame{ function, code, ip, asStatement, callee.funcDef, std::move(memoizedArgs) });
+                function = &callee;
+                code = callee.chunk.code.data();
+                ip = code;
+                break;
+            }
+            case OpCode::TAIL_CALL: {
+                // made only from function bodies, no frame is pushed
+                const CompiledFunction &callee = bytecode_.functions[instr.operand];
+                auto firstArg = stack_.end() - instr.count;
+                std::vector<Value> args(std::make_move_iterator(firstArg), std::make_move_iterator(stack_.end()));
+                stack_.erase(firstArg, stack_.end());
+                callee.funcDef->reenter(interpreter_, std::move(args));
+                function = &callee;
+                code = callee.chunk.code.data();
+                ip = code;
+                break;
+            }
+            case OpCode::RETURN_VALUE:
+                interpreter_.setReturnValue(pop());
+                break;
+            case OpCode::EXIT: {
+                auto result = static_cast<InstrResult>(instr.flags);
+                if (!function) {
+                    return bytecode_.program->finish(interpreter_, result);
+                }
+                std::optional<Value> retVal = function->funcDef->leave(interpreter_, result);
+                Frame &caller = frames_.back();
+                if (caller.memoizedArgs) {
+                    interpreter_.memoize(*caller.callee, std::move(*caller.memoizedArgs), retVal);
+                }
+                function = caller.function;
+                code = caller.code;
+                ip = caller.ip;
+                if (!caller.asStatement) {
+                    pushReturnValue(std::move(retVal));
+                }
+                frames_.pop_back();
+                break;
+            }
+            case OpCode::PRINT: {
+                const VarOperand &var = bytecode_.variables[instr.operand];
+                interpreter_.printLineToStdout(interpreter_.getVariable(var.slot, bytecode_.names[var.name]).asString());
+                break;
+            }
+        }
+    }
+}
+
+void VirtualMachine::pushReturnValue(std::optional<Value> retVal) {
+    if (!retVal) {
+        ErrorHandler::handleTypeMismatch("Function call as expression cannot evaluate to type void");
+    }
+    stack_.push_back(std::move(*retVal));
+}
+
+Value VirtualMachine::pop() {
+    Value value = std::move(stack_.back());
+    stack_.pop_back();
+    return value;
+}
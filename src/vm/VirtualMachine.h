@@ -0,0 +1,71 @@
+#ifndef TKOMSIUNITS_VM_VIRTUAL_MACHINE_H_INCLUDED
+#define TKOMSIUNITS_VM_VIRTUAL_MACHINE_H_INCLUDED
+
+#include "Bytecode.h"
+#include "codeObjects/Interpreter.h"
+#include "codeObjects/Value.h"
+#include <optional>
+#include <vector>
+
+// Executes BytecodeProgram with a dispatch loop. Variable frames and function call
+// contexts are kept by the Interpreter, so semantics and error messages are shared
+// with the tree walker; VM call frames are kept on the heap.
+class VirtualMachine {
+public:
+    VirtualMachine(Interpreter &interpreter, const BytecodeProgram &bytecode)
+        : interpreter_(interpreter)
+        , bytecode_(bytecode) {}
+    
+    // executes the program the same way as Interpreter::executeProgram(), returns exit status
+    int execute();
+    
+    // executes the program inside already created main function call context
+    int run();
+
+private:
+    struct Frame {
+        const CompiledFunction *function;
+        const BytecodeInstr *code;
+        const BytecodeInstr *ip;
+        bool asStatement;
+        // function called by the frame; the running function differs after tail calls
+        const FuncDef *callee;
+        // arguments of the call to memoize its result with, empty if not memoized
+        std::optional<std::vector<Value>> memoizedArgs;
+    };
+
+private:
+    // pushes the value returned from a function called as expression
+    void pushReturnValue(std::optional<Value> retVal);
+    Value pop();
+    
+    RawValue popRaw() {
+        RawValue value = rawStack_.back();
+        rawStack_.pop_back();
+        return value;
+    }
+    
+    // right operand of an operator on raw numbers (RawOperand)
+    double rightNumber(const BytecodeInstr &instr) {
+        switch (static_cast<RawOperand>(instr.count)) {
+            case RawOperand::CONSTANT:
+                return bytecode_.rawConstants[instr.operand].number;
+            case RawOperand::VARIABLE: {
+                const VarOperand &var = bytecode_.variables[instr.operand];
+                return interpreter_.getVariable(var.slot, bytecode_.names[var.name]).asDouble();
+            }
+            default:
+                return popRaw().number;
+        }
+    }
+
+private:
+    Interpreter &interpreter_;
+    const BytecodeProgram &bytecode_;
+    std::vector<Value> stack_;
+    // numbers and bools of expressions calculated raw
+    std::vector<RawValue> rawStack_;
+    std::vector<Frame> frames_;
+};
+
+#endif // TKOMSIUNITS_VM_VIRTUAL_MACHINE_H_INCLUDED
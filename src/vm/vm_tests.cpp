@@ -0,0 +1,349 @@
+#include "Compiler.h"
+#include "VirtualMachine.h"
+#include "utils/engineTestUtils.h"
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <gtest/gtest.h>
+
+namespace {
+
+using engineTests::RunResult;
+using engineTests::parse;
+using engineTests::run;
+using engineTests::runTreeWalker;
+
+int executeVm(Interpreter &interp, const Program &program) {
+    BytecodeProgram bytecode = Compiler::compile(program);
+    VirtualMachine vm(interp, bytecode);
+    return vm.execute();
+}
+
+RunResult runVm(const std::string &input, bool memoize = false) {
+    return run(input, executeVm, memoize);
+}
+
+void expectParity(const std::string &input, bool memoize = false) {
+    engineTests::expectParity(input, executeVm, memoize);
+}
+
+} // anonymous namespace
+
+TEST(VmTests, ReturnsExitStatus) {
+    RunResult result = runVm("a = 3\n return a * 2\n");
+    EXPECT_EQ(6, result.exitStatus);
+    EXPECT_EQ("", result.stderr);
+}
+
+TEST(VmTests, WhileWithBreakAndContinue) {
+    std::string input = "a = 10\n b = 0\n"
+                        "while a > 0 {"
+                        "    a = a - 1\n"
+                        "    if a > 7 { continue\n }\n"
+                        "    c = a * 1[m]\n"
+                        "    b = b + 1\n"
+                        "    if a < 3 { break\n }\n"
+                        "}\n"
+                        "print(\"a = {a}, b = {b}\")\n"
+                        "return b\n";
+    RunResult result = runVm(input);
+    EXPECT_EQ(6, result.exitStatus);
+    EXPECT_EQ("a = 2, b = 6\n", result.stdout);
+    expectParity(input);
+}
+
+TEST(VmTests, FunctionRecursionFibonacci) {
+    std::string input =
+        "func fibonacci (steps [1]) -> [m] {"
+        "    if steps == 0 {"
+        "        return 0[m]\n"
+        "    } elif steps == 1 {"
+        "        return 1[m]\n"
+        "    } else {"
+        "        return fibonacci(steps - 1) + fibonacci(steps - 2)\n"
+        "    }\n"
+        "}\n"
+        "f15 = fibonacci(15)\n"
+        "print(\"{f15}\")\n"
+        "if fibonacci(20) == 6 765[m] {"
+        "    return 20\n"
+        "}\n"
+        "return 1\n";
+    RunResult result = runVm(input);
+    EXPECT_EQ(20, result.exitStatus);
+    expectParity(input);
+}
+
+TEST(VmTests, FunctionsSeeOnlyOwnContextAndGlobalScope) {
+    std::string input =
+        "total = 1[s]\n"
+        "func addToGlobal (x [s]) {"
+        "    total = total + x\n"
+        "    while true {"
+        "        local = x\n"
+        "        break\n"
+        "    }\n"
+        "}\n"
+        "if true {"
+        "    hidden = 5\n"
+        "    addToGlobal(2[s])\n"
+        "}\n"
+        "print(\"total = {total}\")\n"
+        "func readsCallerVariable () -> [1] {"
+        "    return hidden\n"
+        "}\n"
+        "if true {"
+        "    hidden = 5\n"
+        "    x = readsCallerVariable()\n"
+        "}\n";
+    RunResult result = runVm(input);
+    EXPECT_EQ(1, result.exitStatus);
+    EXPECT_EQ("total = 3[(s)/()]\n", result.stdout);
+    expectParity(input);
+}
+
+TEST(VmTests, ShadowingAndTypedDefinitions) {
+    std::string input =
+        "a = 1[m]\n"
+        "if true {"
+        "    a[s] = 2[s]\n"
+        "    print(\"inner {a}\")\n"
+        "}\n"
+        "print(\"outer {a}\")\n"
+        "a[m] = 3[m]\n";
+    RunResult result = runVm(input);
+    EXPECT_EQ(1, result.exitStatus);
+    EXPECT_EQ("inner 2[(s)/()]\nouter 1[(m)/()]\n", result.stdout);
+    expectParity(input);
+}
+
+TEST(VmTests, RuntimeErrorsMatchTreeWalker) {
+    expectParity("break\n");
+    expectParity("func f () { continue\n }\n f()\n");
+    expectParity("func f () -> [m] { }\n a = f()\n");
+    expectParity("func f () { return\n }\n f()\n");
+    expectParity("print(b)\n");
+    expectParity("a = 1[km]\n a = 1[m]\n b = a * 1[km]\n");
+}
+
+TEST(VmTests, GlobalsReferencedFromFunctionsAreCheckedAtCallTime) {
+    std::string input =
+        "func setX () {"
+        "    x = 5\n"
+        "    print(\"in setX {x}\")\n"
+        "}\n"
+        "func shadowX () {"
+        "    x = 7\n"
+        "    x[1] = 6\n"
+        "    print(\"in shadowX {x}\")\n"
+        "}\n"
+        "func getY () -> [m] {"
+        "    return y\n"
+        "}\n"
+        "func getZ () -> [m] {"
+        "    return z\n"
+        "}\n"
+        "setX()\n"
+        "x = 1\n"
+        "setX()\n"
+        "shadowX()\n"
+        "print(\"{x}\")\n"
+        "y = 2[m]\n"
+        "y = getY()\n"
+        "w = getZ()\n"
+        "z = 1[m]\n";
+    RunResult result = runVm(input);
+    EXPECT_EQ(1, result.exitStatus);
+    EXPECT_EQ("in setX 5\nin setX 5\nin shadowX 6\n7\n", result.stdout);
+    expectParity(input);
+    expectParity("func shadowX () { x = 7\n x[1] = 6\n }\n shadowX()\n x = 1\n");
+}
+
+TEST(VmTests, LogicOperatorsShortCircuit) {
+    std::string input =
+        "func check (x [1]) -> [bool] {"
+        "    print(\"check {x}\")\n"
+        "    return x > 0\n"
+        "}\n"
+        "i = 0\n"
+        "while i < 3 && check(i) || i == 0 {"
+        "    i = i + 1\n"
+        "}\n"
+        "func fail () -> [bool] {"
+        "    return undefinedVar\n"
+        "}\n"
+        "a = false && fail()\n"
+        "b = true || fail()\n"
+        "print(\"{i} {a} {b}\")\n"
+        "c = true && fail()\n";
+    RunResult result = runVm(input);
+    EXPECT_EQ(1, result.exitStatus);
+    EXPECT_EQ("check 0\ncheck 1\ncheck 2\n3 false true\n", result.stdout);
+    expectParity(input);
+}
+
+TEST(VmTests, StaticallyTypedExpressionsAreCalculatedRaw) {
+    std::string input =
+        "func isPositive (x [m]) -> [bool] {"
+        "    return x > 0[m]\n"
+        "}\n"
+        "i = 0\n"
+        "distance = 0[km]\n"
+        "time = 0[s]\n"
+        "isFar = false\n"
+        "while i < 10 && (i == 0 || distance / 2[km] < 100) {"
+        "    distance = distance + 2[km] * i\n"
+        "    time = time + 1[s]\n"
+        "    i = i + 1\n"
+        "    if i == 3 { continue\n }\n"
+        "    isFar = distance > 10[km] == true\n"
+        "    if isFar != (time < 7[s]) && isPositive(distance / 1[km] * 1[m]) {"
+        "        print(\"far {i}\")\n"
+        "    }\n"
+        "}\n"
+        "speed = distance / time\n"
+        "print(\"{speed} {isFar}\")\n"
+        "return i - 10 + speed / 1[km/s] - 1 + undefinedVar\n";
+    std::unique_ptr<Program> program = parse(input);
+    BytecodeProgram bytecode = Compiler::compile(*program);
+    auto countOf = [&bytecode](OpCode op) {
+            return std::count_if(bytecode.main.code.begin(), bytecode.main.code.end(), [op](const BytecodeInstr &instr) {
+                    return instr.op == op;
+                });
+        };
+    // numbers of exact types are operated on without their Values, only the type of
+    // the sum with not-defined variable is unknown
+    EXPECT_EQ(1, countOf(OpCode::BINARY));
+    EXPECT_EQ(3, countOf(OpCode::STORE_NUMBER));
+    EXPECT_EQ(1, countOf(OpCode::JUMP_IF_TRUE));
+    RunResult result = runVm(input);
+    EXPECT_EQ(1, result.exitStatus);
+    EXPECT_EQ("far 2\nfar 7\nfar 8\nfar 9\nfar 10\n9[(km)/(s)] true\n", result.stdout);
+    expectParity(input);
+}
+
+TEST(VmTests, MemoizedCallsOfPureFunctions) {
+    std::string input =
+        "func fibonacci (steps [1]) -> [1] {"
+        "    if steps < 2 {"
+        "        return steps\n"
+        "    }\n"
+        "    return fibonacci(steps - 1) + fibonacci(steps - 2)\n"
+        "}\n"
+        "func logged (x [1]) -> [1] {"
+        "    print(\"logged {x}\")\n"
+        "    return fibonacci(x)\n"
+        "}\n"
+        "fibonacci(90)\n"
+        "a = logged(70) + logged(70)\n"
+        "b = fibonacci(5) * 1[km]\n"
+        "print(\"{a} {b}\")\n"
+        "return fibonacci(10) - 50\n";
+    RunResult result = runVm(input, true);
+    EXPECT_EQ(5, result.exitStatus);
+    EXPECT_EQ("logged 70\nlogged 70\n3.80785e+14 5[(km)/()]\n", result.stdout);
+    expectParity(input, true);
+}
+
+TEST(VmTests, TailCallsReuseCallFrame) {
+    std::string input =
+        "func sum (n [1], acc [m]) -> [m] {"
+        "    if n == 0 {"
+        "        return acc\n"
+        "    }\n"
+        "    return sum(n - 1, acc + 1[m])\n"
+        "}\n"
+        "func count (n [1]) -> [1] {"
+        "    return sum(n, 0[km]) / 1[km]\n"
+        "}\n"
+        "func steps (n [1]) -> [1] {"
+        "    while true {"
+        "        return count(n)\n"
+        "    }\n"
+        "}\n"
+        "a = sum(100 000, 0[m])\n"
+        "print(\"{a}\")\n"
+        "return steps(7)\n";
+    RunResult result = runVm(input);
+    EXPECT_EQ(7, result.exitStatus);
+    EXPECT_EQ("100000[(m)/()]\n", result.stdout);
+    expectParity(input);
+    expectParity(input, true);
+    expectParity(
+        "func sum (n [1], acc [m]) -> [m] {"
+        "    if n == 0 {"
+        "        return acc\n"
+        "    }\n"
+        "    return sum(n - 1, acc + 1[m])\n"
+        "}\n"
+        "func callsUndefinedGlobal (n [1]) -> [m] {"
+        "    return sum(n, later)\n"
+        "}\n"
+        "callsUndefinedGlobal(3)\n"
+    );
+}
+
+TEST(VmTests, CallFramesAreLimitedOnlyByMaxCallDepth) {
+    std::string input =
+        "func depth (n [1]) -> [1] {"
+        "    if n == 0 {"
+        "        return 0\n"
+        "    }\n"
+        "    return depth(n - 1) + 1\n"
+        "}\n"
+        "print(\"start\")\n"
+        "return depth(99 999) - 99 989\n";
+    // the VM does not use the native stack for calls of functions
+    RunResult result = run(input, [](Interpreter &interp, const Program &program) {
+        interp.setMaxCallDepth(100 * Interpreter::DEFAULT_MAX_CALL_DEPTH);
+        BytecodeProgram bytecode = Compiler::compile(program);
+        VirtualMachine vm(interp, bytecode);
+        return vm.execute();
+    }, false);
+    EXPECT_EQ(10, result.exitStatus);
+    EXPECT_EQ("start\n", result.stdout);
+    result = runVm(input);
+    EXPECT_EQ(1, result.exitStatus);
+    EXPECT_EQ(
+        "Function Call error: Maximum call depth of " + std::to_string(Interpreter::DEFAULT_MAX_CALL_DEPTH)
+            + " exceeded in call of function 'depth'\n",
+        result.stderr
+    );
+    // within the native stack of the tree walker the same limit is reported
+    auto withMaxCallDepth = [](auto &&engine) {
+        return [&engine](Interpreter &interp, const Program &program) {
+            interp.setMaxCallDepth(1000);
+            return engine(interp, program);
+        };
+    };
+    RunResult expected = run(input, withMaxCallDepth([](Interpreter &interp, const Program &) {
+        return interp.executeProgram();
+    }));
+    result = run(input, withMaxCallDepth(executeVm));
+    EXPECT_EQ(expected.exitStatus, result.exitStatus);
+    EXPECT_EQ(expected.stdout, result.stdout);
+    EXPECT_EQ(expected.stderr, result.stderr);
+}
+
+TEST(VmTests, HighPowersOfUnitsMatchTreeWalker) {
+    std::string input = "a = 2[m3]\nb = a";
+    for (int i = 1; i < 45; ++i) {
+        input += " * a";
+    }
+    expectParity(input + "\nprint(\"{b}\")\n");
+}
+
+TEST(VmTests, ArraysMatchTreeWalker) {
+    expectParity(
+        "xs = [1, 2.5, -4][km]\n"
+        "ts = [0.5, 1, 2][s]\n"
+        "speeds = xs / ts\n"
+        "isFast = speeds > 1[km/s]\n"
+        "scaled = 2 * speeds * isFast\n"
+        "print(\"{speeds} {isFast} {scaled}\")\n"
+        "if false {\n"
+        "    skipped = [1, 2][m] + [1][m]\n"
+        "}\n"
+        "wrong = [1, 2][km] * [1][s]\n"
+    );
+}